@@ -0,0 +1,305 @@
+/****************************************************************************************************************************
+  AsyncAssetImage.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncAssetImage.h"
+
+#include <string.h>
+
+#if defined(ESP32)
+  #include "Arduino.h"
+  #include "AsyncWebServer_ESP32_ENC_Debug.h"
+#else
+  // Host backend : map a regular image file
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+
+  #define AWS_LOGERROR(x)
+  #define AWS_LOGERROR1(x,y)
+  #define AWS_LOGINFO2(x,y,z)
+#endif
+
+/////////////////////////////////////////////////
+
+AsyncAssetImage::AsyncAssetImage()
+  : _base(NULL)
+  , _size(0)
+  , _entries(NULL)
+  , _count(0)
+#if defined(ESP32)
+  , _handle(0)
+#endif
+  , _ownsMapping(false)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncAssetImage::~AsyncAssetImage()
+{
+  end();
+}
+
+/////////////////////////////////////////////////
+
+#if defined(ESP32)
+
+bool AsyncAssetImage::begin(const char* name)
+{
+  end();
+
+  const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
+
+  if (!partition)
+  {
+    AWS_LOGERROR1(F("[AsyncAssetImage::begin] No data partition labelled"), name);
+
+    return false;
+  }
+
+  // Only map what the image really uses, MMU pages are a scarce resource
+  AsyncAssetImageHeader header;
+
+  if ( (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK) || (header.magic != ASYNC_ASSET_IMAGE_MAGIC)
+       || (header.imageSize < sizeof(header)) || (header.imageSize > partition->size) )
+  {
+    AWS_LOGERROR1(F("[AsyncAssetImage::begin] No valid asset image in partition"), name);
+
+    return false;
+  }
+
+  const void* base = NULL;
+
+  if (esp_partition_mmap(partition, 0, header.imageSize, ESP_PARTITION_MMAP_DATA, &base, &_handle) != ESP_OK)
+  {
+    AWS_LOGERROR1(F("[AsyncAssetImage::begin] esp_partition_mmap failed, size ="), header.imageSize);
+
+    return false;
+  }
+
+  if (!_validate((const uint8_t*) base, header.imageSize))
+  {
+    spi_flash_munmap(_handle);
+
+    return false;
+  }
+
+  _ownsMapping = true;
+
+  AWS_LOGINFO2(F("[AsyncAssetImage::begin] Mapped assets, count ="), _count, name);
+
+  return true;
+}
+
+#else
+
+bool AsyncAssetImage::begin(const char* name)
+{
+  end();
+
+  int fd = open(name, O_RDONLY);
+
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+
+  if ( (fstat(fd, &st) != 0) || (st.st_size < (off_t) sizeof(AsyncAssetImageHeader)) )
+  {
+    close(fd);
+
+    return false;
+  }
+
+  void* base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+
+  if (base == MAP_FAILED)
+    return false;
+
+  if (!_validate((const uint8_t*) base, (size_t) st.st_size))
+  {
+    munmap(base, (size_t) st.st_size);
+
+    return false;
+  }
+
+  // Keep the full file length for munmap()
+  _size = (size_t) st.st_size;
+  _ownsMapping = true;
+
+  return true;
+}
+
+#endif
+
+/////////////////////////////////////////////////
+
+bool AsyncAssetImage::begin(const void* base, size_t size)
+{
+  end();
+
+  if (!base)
+    return false;
+
+  return _validate((const uint8_t*) base, size);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncAssetImage::end()
+{
+  if (_base && _ownsMapping)
+  {
+#if defined(ESP32)
+    spi_flash_munmap(_handle);
+#else
+    munmap((void*) _base, _size);
+#endif
+  }
+
+  _base = NULL;
+  _size = 0;
+  _entries = NULL;
+  _count = 0;
+  _ownsMapping = false;
+}
+
+/////////////////////////////////////////////////
+
+// Same ordering as the builder: plain byte order, shorter prefix first
+static int _assetPathCompare(const char* path, size_t len, const char* entryPath, size_t entryLen)
+{
+  int cmp = memcmp(path, entryPath, (len < entryLen) ? len : entryLen);
+
+  if (cmp != 0)
+    return cmp;
+
+  return (len < entryLen) ? -1 : ((len > entryLen) ? 1 : 0);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncAssetImage::_validate(const uint8_t* base, size_t size)
+{
+  const AsyncAssetImageHeader* header = (const AsyncAssetImageHeader*) base;
+
+  if ( (size < sizeof(AsyncAssetImageHeader)) || (header->magic != ASYNC_ASSET_IMAGE_MAGIC)
+       || (header->version != ASYNC_ASSET_IMAGE_VERSION) || (header->headerSize < sizeof(AsyncAssetImageHeader))
+       || (header->imageSize > size) || (header->entriesOffset % 4) )
+  {
+    AWS_LOGERROR(F("[AsyncAssetImage::_validate] Bad image header"));
+
+    return false;
+  }
+
+  const uint64_t imageSize = header->imageSize;
+
+  if ( (uint64_t) header->entriesOffset + (uint64_t) header->entryCount * sizeof(AsyncAssetImageEntry) > imageSize)
+  {
+    AWS_LOGERROR(F("[AsyncAssetImage::_validate] Entry table out of bounds"));
+
+    return false;
+  }
+
+  const AsyncAssetImageEntry* entries = (const AsyncAssetImageEntry*) (base + header->entriesOffset);
+
+  // Check every entry once here, so that lookups and responses can trust offsets blindly
+  for (uint32_t i = 0; i < header->entryCount; i++)
+  {
+    const AsyncAssetImageEntry* e = &entries[i];
+
+    bool ok = ( (uint64_t) e->pathOffset + e->pathLength < imageSize ) && (base[e->pathOffset + e->pathLength] == 0)
+              && ( (uint64_t) e->dataOffset + e->dataLength <= imageSize );
+
+    if (ok && e->mimeOffset)
+      ok = ( (uint64_t) e->mimeOffset + e->mimeLength < imageSize ) && (base[e->mimeOffset + e->mimeLength] == 0);
+
+    if (ok && i)
+    {
+      const AsyncAssetImageEntry* prev = &entries[i - 1];
+
+      ok = _assetPathCompare((const char*) base + prev->pathOffset, prev->pathLength,
+                             (const char*) base + e->pathOffset, e->pathLength) < 0;
+    }
+
+    if (!ok)
+    {
+      AWS_LOGERROR1(F("[AsyncAssetImage::_validate] Bad entry, index ="), i);
+
+      return false;
+    }
+  }
+
+  _base = base;
+  _size = size;
+  _entries = entries;
+  _count = header->entryCount;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+const AsyncAssetImageEntry* AsyncAssetImage::find(const char* path, size_t len) const
+{
+  size_t lo = 0;
+  size_t hi = _count;
+
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2;
+    const AsyncAssetImageEntry* e = &_entries[mid];
+
+    int cmp = _assetPathCompare(path, len, (const char*) (_base + e->pathOffset), e->pathLength);
+
+    if (cmp == 0)
+      return e;
+
+    if (cmp < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return NULL;
+}
+
+/////////////////////////////////////////////////
+
+const AsyncAssetImageEntry* AsyncAssetImage::find(const char* path) const
+{
+  return find(path, strlen(path));
+}
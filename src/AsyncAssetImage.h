@@ -0,0 +1,183 @@
+/****************************************************************************************************************************
+  AsyncAssetImage.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCASSETIMAGE_H_
+#define ASYNCASSETIMAGE_H_
+
+// Read-only packed asset image, as produced by utils/build_asset_image.py.
+//
+// The image is a flat, little-endian blob:
+//
+//   AsyncAssetImageHeader
+//   AsyncAssetImageEntry[entryCount]   sorted by path (plain byte order), for binary search
+//   string table                       NUL-terminated paths and mime types
+//   file data                          each file 4-byte aligned
+//
+// On ESP32 the image lives in a raw data partition and is mapped with esp_partition_mmap(), so
+// entries and file data are plain pointers into flash. Elsewhere a regular file is mapped with mmap(),
+// which allows the lookup code and the builder output to be checked on a Linux host.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(ESP32)
+  #include "esp_partition.h"
+#endif
+
+/////////////////////////////////////////////////
+
+#define ASYNC_ASSET_IMAGE_MAGIC         0x41535741UL     // "AWSA"
+#define ASYNC_ASSET_IMAGE_VERSION       1
+
+// Entry flags
+#define ASYNC_ASSET_FLAG_GZIP           0x0001          // Data is stored gzip-compressed
+
+/////////////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;
+  uint32_t entryCount;
+  uint32_t entriesOffset;
+  uint32_t imageSize;
+  uint32_t reserved[3];
+} AsyncAssetImageHeader;
+
+/////////////////////////////////////////////////
+
+typedef struct
+{
+  uint32_t pathOffset;        // From start of image, NUL-terminated
+  uint16_t pathLength;
+  uint16_t flags;
+  uint32_t mimeOffset;        // 0 if no mime type was recorded
+  uint16_t mimeLength;
+  uint16_t reserved0;
+  uint32_t dataOffset;        // From start of image
+  uint32_t dataLength;
+  uint32_t etag;              // FNV-1a of the stored bytes
+  uint32_t reserved1;
+} AsyncAssetImageEntry;
+
+static_assert(sizeof(AsyncAssetImageHeader) == 32, "AsyncAssetImageHeader must be 32 bytes");
+static_assert(sizeof(AsyncAssetImageEntry) == 32, "AsyncAssetImageEntry must be 32 bytes");
+
+/////////////////////////////////////////////////
+
+class AsyncAssetImage
+{
+  private:
+    const uint8_t* _base;
+    size_t _size;
+    const AsyncAssetImageEntry* _entries;
+    uint32_t _count;
+
+#if defined(ESP32)
+    spi_flash_mmap_handle_t _handle;
+#endif
+    bool _ownsMapping;
+
+    bool _validate(const uint8_t* base, size_t size);
+
+  public:
+    AsyncAssetImage();
+    ~AsyncAssetImage();
+
+    AsyncAssetImage(AsyncAssetImage const &) = delete;
+    AsyncAssetImage &operator=(AsyncAssetImage const &) = delete;
+
+    // ESP32: name is the label of a data partition. Host: name is the path of an image file.
+    bool begin(const char* name);
+
+    // Use an image that is already addressable, e.g. linked into the firmware. Not copied.
+    bool begin(const void* base, size_t size);
+
+    void end();
+
+    /////////////////////////////////////////////////
+
+    inline bool mapped() const
+    {
+      return _base != NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline size_t count() const
+    {
+      return _count;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline size_t size() const
+    {
+      return _size;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const AsyncAssetImageEntry* entry(size_t index) const
+    {
+      return (index < _count) ? &_entries[index] : NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const char* path(const AsyncAssetImageEntry* entry) const
+    {
+      return (const char*)(_base + entry->pathOffset);
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const char* mime(const AsyncAssetImageEntry* entry) const
+    {
+      return entry->mimeOffset ? (const char*)(_base + entry->mimeOffset) : NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const uint8_t* data(const AsyncAssetImageEntry* entry) const
+    {
+      return _base + entry->dataOffset;
+    }
+
+    /////////////////////////////////////////////////
+
+    const AsyncAssetImageEntry* find(const char* path, size_t len) const;
+    const AsyncAssetImageEntry* find(const char* path) const;
+};
+
+#endif /* ASYNCASSETIMAGE_H_ */
@@ -0,0 +1,259 @@
+/****************************************************************************************************************************
+  AsyncBodySpool.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#include "AsyncBodySpool.h"
+
+/////////////////////////////////////////////////
+
+uint32_t AsyncBodySpool::_counter = 0;
+
+/////////////////////////////////////////////////
+
+AsyncBodySpool::AsyncBodySpool(size_t length)
+  : _mem(NULL)
+  , _file()
+  , _fs(NULL)
+  , _path()
+  , _stage(NULL)
+  , _staged(0)
+  , _length(length)
+  , _written(0)
+  , _readPos(0)
+  , _finished(false)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncBodySpool::~AsyncBodySpool()
+{
+  if (_mem)
+    free(_mem);
+
+  if (_stage)
+    free(_stage);
+
+  if (_file)
+    _file.close();
+
+  if (_path.length())
+    _fs->remove(_path);
+}
+
+/////////////////////////////////////////////////
+
+AsyncBodySpool* AsyncBodySpool::create(size_t length, FS *fs, const String& dir)
+{
+  AsyncBodySpool *spool = new AsyncBodySpool(length);
+
+  if (psramFound())
+    spool->_mem = (uint8_t *) ps_malloc(length);
+
+  if (!spool->_mem && fs)
+  {
+    spool->_fs = fs;
+    spool->_path = dir + "/body" + String(++_counter) + ".tmp";
+    spool->_file = fs->open(spool->_path, "w");
+
+    if (!spool->_file)
+    {
+      // First use, the directory may not exist yet
+      fs->mkdir(dir);
+      spool->_file = fs->open(spool->_path, "w");
+    }
+
+    if (spool->_file)
+      spool->_stage = (uint8_t *) malloc(ASYNC_BODY_SPOOL_WRITE_SIZE);
+    else
+      spool->_path = String();
+  }
+
+  if (!spool->_mem && !spool->_file)
+  {
+    AWS_LOGERROR1(F("[AsyncBodySpool] No PSRAM or file for body, length ="), length);
+
+    delete spool;
+
+    return NULL;
+  }
+
+  AWS_LOGDEBUG3("[AsyncBodySpool] Spooling body, length =", length, ", to", spool->_mem ? "PSRAM" : spool->_path.c_str());
+
+  return spool;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncBodySpool::_flushStage()
+{
+  if (!_staged)
+    return true;
+
+  const size_t len = _staged;
+  _staged = 0;
+
+  return _file.write(_stage, len) == len;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncBodySpool::append(const uint8_t *data, size_t len)
+{
+  if (_finished || (len > _length - _written))
+    return false;
+
+  if (_mem)
+  {
+    memcpy(_mem + _written, data, len);
+    _written += len;
+
+    return true;
+  }
+
+  _written += len;
+
+  if (!_stage)
+    return _file.write(data, len) == len;
+
+  while (len)
+  {
+    const size_t n = std::min(len, (size_t) ASYNC_BODY_SPOOL_WRITE_SIZE - _staged);
+
+    memcpy(_stage + _staged, data, n);
+    _staged += n;
+    data += n;
+    len -= n;
+
+    if ((_staged == ASYNC_BODY_SPOOL_WRITE_SIZE) && !_flushStage())
+      return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncBodySpool::finish()
+{
+  if (_finished)
+    return true;
+
+  _finished = true;
+
+  if (_mem)
+    return true;
+
+  const bool flushed = _flushStage();
+
+  free(_stage);
+  _stage = NULL;
+
+  _file.close();
+
+  if (!flushed)
+    return false;
+
+  _file = _fs->open(_path, "r");
+
+  return (bool) _file;
+}
+
+/////////////////////////////////////////////////
+
+int AsyncBodySpool::available()
+{
+  if (!_finished)
+    return 0;
+
+  return _mem ? (int) (_written - _readPos) : _file.available();
+}
+
+/////////////////////////////////////////////////
+
+int AsyncBodySpool::read()
+{
+  if (!_finished)
+    return -1;
+
+  if (!_mem)
+    return _file.read();
+
+  return (_readPos < _written) ? _mem[_readPos++] : -1;
+}
+
+/////////////////////////////////////////////////
+
+int AsyncBodySpool::peek()
+{
+  if (!_finished)
+    return -1;
+
+  if (!_mem)
+    return _file.peek();
+
+  return (_readPos < _written) ? _mem[_readPos] : -1;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncBodySpool::read(uint8_t *buffer, size_t len)
+{
+  if (!_finished)
+    return 0;
+
+  if (!_mem)
+    return _file.read(buffer, len);
+
+  len = std::min(len, _written - _readPos);
+
+  memcpy(buffer, _mem + _readPos, len);
+  _readPos += len;
+
+  return len;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncBodySpool::readBytes(char *buffer, size_t len)
+{
+  return read((uint8_t *) buffer, len);
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncBodySpool::write(uint8_t data)
+{
+  ESP32_ENC_AWS_UNUSED(data);
+
+  return 0;
+}
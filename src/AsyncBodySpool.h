@@ -0,0 +1,126 @@
+/****************************************************************************************************************************
+  AsyncBodySpool.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef ASYNCBODYSPOOL_H_
+#define ASYNCBODYSPOOL_H_
+
+// Keeps a large request body out of the internal heap while it is received, see
+// AsyncWebServer::setBodySpool(). The body goes into one PSRAM block when there is PSRAM,
+// else into a temporary file written in ASYNC_BODY_SPOOL_WRITE_SIZE pieces. Once the body
+// is complete the handler reads it back as a Stream from request->body().
+
+#include "AsyncWebServer_ESP32_ENC.h"
+
+/////////////////////////////////////////////////
+
+// Largest body that is spooled, larger ones are answered with 413 before any of them is stored.
+// Applies on top of the handler's setMaxContentLength(), which may be unlimited.
+#ifndef ASYNC_BODY_SPOOL_MAX_LENGTH
+  #define ASYNC_BODY_SPOOL_MAX_LENGTH       (1024 * 1024)
+#endif
+
+// Bytes collected before each file write, flash prefers few large writes
+#ifndef ASYNC_BODY_SPOOL_WRITE_SIZE
+  #define ASYNC_BODY_SPOOL_WRITE_SIZE       4096
+#endif
+
+/////////////////////////////////////////////////
+
+class AsyncBodySpool: public Stream
+{
+    using File = fs::File;
+    using FS = fs::FS;
+
+  private:
+    uint8_t *_mem;                // Whole body in PSRAM, or NULL when spooling to _file
+    File _file;
+    FS *_fs;
+    String _path;
+    uint8_t *_stage;              // Pending file write, NULL if it couldn't be allocated
+    size_t _staged;
+    size_t _length;
+    size_t _written;
+    size_t _readPos;
+    bool _finished;
+
+    AsyncBodySpool(size_t length);
+
+    bool _flushStage();
+
+    static uint32_t _counter;
+
+  public:
+    ~AsyncBodySpool();
+
+    AsyncBodySpool(AsyncBodySpool const &) = delete;
+    AsyncBodySpool &operator=(AsyncBodySpool const &) = delete;
+
+    // NULL if neither PSRAM nor a temporary file in dir on fs is available
+    static AsyncBodySpool* create(size_t length, FS *fs, const String& dir);
+
+    // False once the body can't be stored, e.g. the file system is full
+    bool append(const uint8_t *data, size_t len);
+
+    // Writes out what is left and rewinds for reading
+    bool finish();
+
+    /////////////////////////////////////////////////
+
+    inline size_t size() const
+    {
+      return _written;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline bool inPsram() const
+    {
+      return _mem != NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Stream, readable after finish()
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t *buffer, size_t len);
+
+    using Stream::readBytes;
+    size_t readBytes(char *buffer, size_t len);
+
+    // Read only
+    size_t write(uint8_t data);
+};
+
+#endif /* ASYNCBODYSPOOL_H_ */
@@ -32,6 +32,10 @@
 
 #include "Arduino.h"
 #include "AsyncEventSource.h"
+#include "AsyncWebWake.h"
+
+// Otherwise it silently goes back to the heap
+static_assert(sizeof(AsyncEventSourceMessage) <= ASYNC_WEB_MSG_POOL_OBJECT_SIZE, "AsyncEventSourceMessage must fit ASYNC_WEB_MSG_POOL_OBJECT_SIZE");
 
 /////////////////////////////////////////////////
 
@@ -156,7 +160,7 @@ static String generateEventMessage(const char *message, const char *event, uint3
 AsyncEventSourceMessage::AsyncEventSourceMessage(const char * data, size_t len)
   : _data(nullptr), _len(len), _sent(0), _acked(0)
 {
-  _data = (uint8_t*)malloc(_len + 1);
+  _data = (uint8_t*) AsyncWebMessagePool::allocPayload(_len + 1);
 
   if (_data == nullptr)
   {
@@ -173,8 +177,7 @@ AsyncEventSourceMessage::AsyncEventSourceMessage(const char * data, size_t len)
 
 AsyncEventSourceMessage::~AsyncEventSourceMessage()
 {
-  if (_data != NULL)
-    free(_data);
+  AsyncWebMessagePool::freePayload(_data);
 }
 
 /////////////////////////////////////////////////
@@ -225,10 +228,10 @@ size_t AsyncEventSourceMessage::send(AsyncClient *client)
 // Client
 
 AsyncEventSourceClient::AsyncEventSourceClient(AsyncWebServerRequest *request, AsyncEventSource *server)
-  : _messageQueue(LinkedList<AsyncEventSourceMessage * >([](AsyncEventSourceMessage * m)
+  : _messageQueue([](AsyncEventSourceMessage * m)
 {
   delete  m;
-}))
+})
 {
   _client = request->client();
   _server = server;
@@ -267,7 +270,7 @@ AsyncEventSourceClient::AsyncEventSourceClient(AsyncWebServerRequest *request, A
 
   _server->_addClient(this);
 
-  delete request;
+  request->_release();
 }
 
 /////////////////////////////////////////////////
@@ -320,12 +323,17 @@ void AsyncEventSourceClient::_onAck(size_t len, uint32_t time)
   }
 
   _runQueue();
+
+  // Events from other tasks, for every client of the server
+  _server->_drainSubmitted();
 }
 
 /////////////////////////////////////////////////
 
 void AsyncEventSourceClient::_onPoll()
 {
+  _server->_drainSubmitted();
+
   if (!_messageQueue.isEmpty())
   {
     _runQueue();
@@ -393,18 +401,28 @@ void AsyncEventSourceClient::_runQueue()
 
 AsyncEventSource::AsyncEventSource(const String& url)
   : _url(url)
-  , _clients(LinkedList<AsyncEventSourceClient * >([](AsyncEventSourceClient * c)
+  , _clients([](AsyncEventSourceClient * c)
 {
   delete c;
-}))
+})
 , _connectcb(NULL)
-{}
+, _networkTask(NULL)
+, _wakeClient(NULL)
+, _wakePending(false)
+{
+  AsyncWebMessagePool::begin();
+}
 
 /////////////////////////////////////////////////
 
 AsyncEventSource::~AsyncEventSource()
 {
   close();
+
+  AsyncEventSourceSubmit submit;
+
+  while (_submitted.pop(submit))
+    AsyncWebMessagePool::freePayload(submit.data);
 }
 
 /////////////////////////////////////////////////
@@ -431,7 +449,11 @@ void AsyncEventSource::_addClient(AsyncEventSourceClient * client)
     free(temp);
     }*/
 
+  // Sent before this client connected
+  _drainSubmitted();
+
   _clients.add(client);
+  _wakeClient.store(client->client(), std::memory_order_relaxed);
 
   if (_connectcb)
     _connectcb(client);
@@ -442,6 +464,8 @@ void AsyncEventSource::_addClient(AsyncEventSourceClient * client)
 void AsyncEventSource::_handleDisconnect(AsyncEventSourceClient * client)
 {
   _clients.remove(client);
+
+  _wakeClient.store(_clients.isEmpty() ? NULL : _clients.front()->client(), std::memory_order_relaxed);
 }
 
 /////////////////////////////////////////////////
@@ -485,17 +509,82 @@ void AsyncEventSource::send(const char *message, const char *event, uint32_t id,
 {
   String ev = generateEventMessage(message, event, id, reconnect);
 
+  if (_onNetworkTask())
+  {
+    _drainSubmitted();
+    _write(ev.c_str(), ev.length());
+
+    return;
+  }
+
+  // Other task : hand a copy to the async_tcp task, without touching the clients
+  AsyncEventSourceSubmit submit = { (char *) AsyncWebMessagePool::allocPayload(ev.length()), ev.length() };
+
+  if (!submit.data)
+    return;
+
+  memcpy(submit.data, ev.c_str(), ev.length());
+
+  if (!_submitted.push(submit))
+  {
+    AWS_LOGWARN("[AsyncEventSource] Submit queue full, event dropped");
+
+    AsyncWebMessagePool::freePayload(submit.data);
+
+    return;
+  }
+
+  _wakeNetwork();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncEventSource::_write(const char *data, size_t len)
+{
   for (const auto &c : _clients)
   {
     if (c->connected())
     {
-      c->write(ev.c_str(), ev.length());
+      c->write(data, len);
     }
   }
 }
 
 /////////////////////////////////////////////////
 
+// Other task, after a push : has a client polled now, which drains the ring, rather than on its next
+// ack or lwIP poll up to 500ms later. Once until the next drain.
+void AsyncEventSource::_wakeNetwork()
+{
+  if (_wakePending.exchange(true, std::memory_order_acq_rel))
+    return;
+
+  // lwIP mailbox full, the next push tries again
+  if (!AsyncWebWake::client(_wakeClient.load(std::memory_order_relaxed)))
+    _wakePending.store(false, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+
+// async_tcp task : writes what other tasks sent to the clients, in the order it was sent
+void AsyncEventSource::_drainSubmitted()
+{
+  _networkTask.store(xTaskGetCurrentTaskHandle(), std::memory_order_relaxed);
+
+  // Pushes from now on wake the network again
+  _wakePending.store(false, std::memory_order_release);
+
+  AsyncEventSourceSubmit submit;
+
+  while (_submitted.pop(submit))
+  {
+    _write(submit.data, submit.len);
+    AsyncWebMessagePool::freePayload(submit.data);
+  }
+}
+
+/////////////////////////////////////////////////
+
 size_t AsyncEventSource::count() const
 {
   return _clients.count_if([](AsyncEventSourceClient * c)
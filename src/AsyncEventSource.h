@@ -41,11 +41,18 @@
 #include "AsyncWebServer_ESP32_ENC.h"
 
 #include "AsyncWebSynchronization.h"
+#include "AsyncMpscRing.h"
+#include "AsyncWebMessagePool.h"
 
 /////////////////////////////////////////////////
 
 #define DEFAULT_MAX_SSE_CLIENTS 8
 
+// Events sent by other tasks waiting for the async_tcp task, per AsyncEventSource. Must be a power of 2.
+#ifndef ASYNC_SSE_SUBMIT_QUEUE_SIZE
+  #define ASYNC_SSE_SUBMIT_QUEUE_SIZE   16
+#endif
+
 class AsyncEventSource;
 class AsyncEventSourceResponse;
 class AsyncEventSourceClient;
@@ -56,7 +63,7 @@ typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFuncti
 
 /////////////////////////////////////////////////
 
-class AsyncEventSourceMessage
+class AsyncEventSourceMessage : public AsyncWebPooledObject
 {
   private:
     uint8_t * _data;
@@ -93,7 +100,7 @@ class AsyncEventSourceClient
     AsyncClient *_client;
     AsyncEventSource *_server;
     uint32_t _lastId;
-    LinkedList<AsyncEventSourceMessage *> _messageQueue;
+    SmallVector<AsyncEventSourceMessage *, 4> _messageQueue;
     void _queueMessage(AsyncEventSourceMessage *dataMessage);
     void _runQueue();
 
@@ -147,13 +154,43 @@ class AsyncEventSourceClient
 
 /////////////////////////////////////////////////
 
+// An event sent on another task, formatted into a pool payload
+typedef struct
+{
+  char *data;
+  size_t len;
+} AsyncEventSourceSubmit;
+
+/////////////////////////////////////////////////
+
 class AsyncEventSource: public AsyncWebHandler
 {
   private:
     String _url;
-    LinkedList<AsyncEventSourceClient *> _clients;
+    SmallVector<AsyncEventSourceClient *, 4> _clients;
     ArEventHandlerFunction _connectcb;
 
+    // The clients belong to the async_tcp task. Other tasks only push to the ring, see _drainSubmitted().
+    AsyncMpscRing<AsyncEventSourceSubmit, ASYNC_SSE_SUBMIT_QUEUE_SIZE> _submitted;
+    std::atomic<TaskHandle_t> _networkTask;
+    std::atomic<AsyncClient *> _wakeClient;   // Any client, woken so that it drains the ring, see AsyncWebWake
+    std::atomic<bool> _wakePending;
+
+    /////////////////////////////////////////////////
+
+    inline bool _onNetworkTask() const
+    {
+      return _networkTask.load(std::memory_order_relaxed) == xTaskGetCurrentTaskHandle();
+    }
+
+    /////////////////////////////////////////////////
+
+    void _wakeNetwork();
+
+    /////////////////////////////////////////////////
+
+    void _write(const char *data, size_t len);
+
   public:
     AsyncEventSource(const String& url);
     ~AsyncEventSource();
@@ -173,9 +210,20 @@ class AsyncEventSource: public AsyncWebHandler
     size_t count() const; //number clients connected
     size_t  avgPacketsWaiting() const;
 
+    /////////////////////////////////////////////////
+
+    // Events from other tasks refused because too many were waiting for the async_tcp task
+    inline uint32_t submitDropped() const
+    {
+      return _submitted.dropped();
+    }
+
+    /////////////////////////////////////////////////
+
     //system callbacks (do not call)
     void _addClient(AsyncEventSourceClient * client);
     void _handleDisconnect(AsyncEventSourceClient * client);
+    void _drainSubmitted();
     virtual bool canHandle(AsyncWebServerRequest *request) override final;
     virtual void handleRequest(AsyncWebServerRequest *request) override final;
 };
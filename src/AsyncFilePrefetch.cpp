@@ -0,0 +1,311 @@
+/****************************************************************************************************************************
+  AsyncFilePrefetch.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncFilePrefetch.h"
+#include "AsyncWebWake.h"
+
+/////////////////////////////////////////////////
+
+QueueHandle_t AsyncFilePrefetch::_queue = NULL;
+
+// Guards the slot bookkeeping and reference counts of all instances, never held across a read
+static portMUX_TYPE _prefetchMux = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+bool AsyncFilePrefetch::_startWorker()
+{
+  // Only called from the async_tcp task, no need to guard against a concurrent start
+  if (_queue)
+    return true;
+
+  _queue = xQueueCreate(ASYNC_FILE_PREFETCH_QUEUE_SIZE, sizeof(AsyncFilePrefetch *));
+
+  if (!_queue)
+  {
+    AWS_LOGERROR(F("[AsyncFilePrefetch] xQueueCreate failed"));
+
+    return false;
+  }
+
+  if (xTaskCreatePinnedToCore(_worker, "aws_prefetch", ASYNC_FILE_PREFETCH_STACK_SIZE, NULL,
+                              ASYNC_FILE_PREFETCH_PRIORITY, NULL, ASYNC_FILE_PREFETCH_CORE) != pdPASS)
+  {
+    AWS_LOGERROR(F("[AsyncFilePrefetch] xTaskCreatePinnedToCore failed"));
+
+    vQueueDelete(_queue);
+    _queue = NULL;
+
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFilePrefetch::_worker(void *arg)
+{
+  ESP32_ENC_AWS_UNUSED(arg);
+
+  for (;;)
+  {
+    AsyncFilePrefetch *prefetch;
+
+    if (xQueueReceive(_queue, &prefetch, portMAX_DELAY) != pdTRUE)
+      continue;
+
+    prefetch->_fill();
+    prefetch->_unref();
+  }
+}
+
+/////////////////////////////////////////////////
+
+AsyncFilePrefetch::AsyncFilePrefetch(File& file, uint8_t depth)
+  : _file(file)
+  , _client(NULL)
+  , _buffers(NULL)
+  , _readPos(0)
+  , _depth(depth)
+  , _readSlot(0)
+  , _writeSlot(0)
+  , _ready(0)
+  , _refs(1)
+  , _queued(false)
+  , _eof(false)
+  , _cancelled(false)
+  , _waiting(false)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncFilePrefetch::~AsyncFilePrefetch()
+{
+  if (_file)
+    _file.close();
+
+  free(_buffers);
+}
+
+/////////////////////////////////////////////////
+
+AsyncFilePrefetch* AsyncFilePrefetch::start(File& file, uint8_t depth)
+{
+  if (!file || !depth)
+    return NULL;
+
+  if (depth > ASYNC_FILE_PREFETCH_MAX_DEPTH)
+    depth = ASYNC_FILE_PREFETCH_MAX_DEPTH;
+
+  if (!_startWorker())
+    return NULL;
+
+  uint8_t *buffers = (uint8_t *) malloc(depth * ASYNC_FILE_PREFETCH_BUFFER_SIZE);
+
+  if (!buffers)
+  {
+    AWS_LOGERROR1(F("[AsyncFilePrefetch] malloc failed, size ="), depth * ASYNC_FILE_PREFETCH_BUFFER_SIZE);
+
+    return NULL;
+  }
+
+  AsyncFilePrefetch *prefetch = new AsyncFilePrefetch(file, depth);
+  prefetch->_buffers = buffers;
+
+  // From now on only the worker reads the file
+  file = File();
+
+  prefetch->_schedule();
+
+  return prefetch;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFilePrefetch::_schedule()
+{
+  portENTER_CRITICAL(&_prefetchMux);
+
+  const bool post = !_queued && !_eof && !_cancelled && (_ready < _depth);
+
+  if (post)
+  {
+    // The queue entry holds a reference until the worker is done with it
+    _queued = true;
+    _refs++;
+  }
+
+  portEXIT_CRITICAL(&_prefetchMux);
+
+  AsyncFilePrefetch *self = this;
+
+  if (post && (xQueueSend(_queue, &self, 0) != pdTRUE))
+  {
+    // Queue full, read() schedules again on the next attempt
+    portENTER_CRITICAL(&_prefetchMux);
+    _queued = false;
+    _refs--;
+    portEXIT_CRITICAL(&_prefetchMux);
+  }
+}
+
+/////////////////////////////////////////////////
+
+// Worker task : fill every free slot, the file is only ever read here
+void AsyncFilePrefetch::_fill()
+{
+  portENTER_CRITICAL(&_prefetchMux);
+  _queued = false;
+  portEXIT_CRITICAL(&_prefetchMux);
+
+  for (;;)
+  {
+    portENTER_CRITICAL(&_prefetchMux);
+    const bool more = !_cancelled && !_eof && (_ready < _depth);
+    const uint8_t slot = _writeSlot;
+    portEXIT_CRITICAL(&_prefetchMux);
+
+    if (!more)
+      break;
+
+    const size_t len = _file.read(_buffers + slot * ASYNC_FILE_PREFETCH_BUFFER_SIZE, ASYNC_FILE_PREFETCH_BUFFER_SIZE);
+
+    portENTER_CRITICAL(&_prefetchMux);
+
+    if (len)
+    {
+      _length[slot] = len;
+      _writeSlot = (slot + 1) % _depth;
+      _ready++;
+    }
+    else
+    {
+      _eof = true;
+    }
+
+    // Either way the response has something to do now
+    const bool wake = _waiting && !_cancelled;
+    _waiting = false;
+
+    portEXIT_CRITICAL(&_prefetchMux);
+
+    if (wake)
+      AsyncWebWake::client(_client);
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFilePrefetch::setClient(AsyncClient *client)
+{
+  portENTER_CRITICAL(&_prefetchMux);
+  _client = client;
+  portEXIT_CRITICAL(&_prefetchMux);
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncFilePrefetch::read(uint8_t *dst, size_t len)
+{
+  size_t copied = 0;
+  bool drained = false;
+  bool ended = false;
+
+  while (copied < len)
+  {
+    portENTER_CRITICAL(&_prefetchMux);
+    const uint8_t ready = _ready;
+    const uint8_t slot = _readSlot;
+    ended = _eof && !ready;
+
+    // Checked together with _ready, so that the worker can't fill a slot unnoticed in between
+    if (!ready && !copied && !ended)
+      _waiting = true;
+
+    portEXIT_CRITICAL(&_prefetchMux);
+
+    if (!ready)
+      break;
+
+    const size_t n = std::min(len - copied, _length[slot] - _readPos);
+
+    memcpy(dst + copied, _buffers + slot * ASYNC_FILE_PREFETCH_BUFFER_SIZE + _readPos, n);
+    copied += n;
+    _readPos += n;
+
+    if (_readPos == _length[slot])
+    {
+      // Hand the slot back to the worker
+      _readPos = 0;
+
+      portENTER_CRITICAL(&_prefetchMux);
+      _readSlot = (slot + 1) % _depth;
+      _ready--;
+      portEXIT_CRITICAL(&_prefetchMux);
+
+      drained = true;
+    }
+  }
+
+  if (drained || !copied)
+    _schedule();
+
+  if (!copied && !ended)
+    return RESPONSE_TRY_AGAIN;
+
+  return copied;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFilePrefetch::_unref()
+{
+  portENTER_CRITICAL(&_prefetchMux);
+  const bool last = (--_refs == 0);
+  portEXIT_CRITICAL(&_prefetchMux);
+
+  if (last)
+    delete this;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFilePrefetch::release()
+{
+  portENTER_CRITICAL(&_prefetchMux);
+  _cancelled = true;
+  portEXIT_CRITICAL(&_prefetchMux);
+
+  _unref();
+}
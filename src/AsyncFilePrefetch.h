@@ -0,0 +1,134 @@
+/****************************************************************************************************************************
+  AsyncFilePrefetch.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCFILEPREFETCH_H_
+#define ASYNCFILEPREFETCH_H_
+
+// Read-ahead for AsyncFileResponse, so that slow SD cards or LittleFS garbage collection
+// don't stall the async_tcp task, and with it every other connection.
+//
+// One worker task, shared by all responses, fills a small ring of buffers per response.
+// The response only copies out what is ready and answers RESPONSE_TRY_AGAIN otherwise, and the
+// worker wakes its connection once the next buffer is filled.
+// The state is shared with the worker and reference counted, so a response can go away
+// (client disconnect) while a read is in progress. The last owner closes the file.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+
+/////////////////////////////////////////////////
+
+// Default read-ahead depth (buffers) for every AsyncFileResponse, 0 = read synchronously
+#ifndef ASYNC_FILE_PREFETCH_DEPTH
+  #define ASYNC_FILE_PREFETCH_DEPTH           0
+#endif
+
+#define ASYNC_FILE_PREFETCH_MAX_DEPTH         8
+
+#ifndef ASYNC_FILE_PREFETCH_BUFFER_SIZE
+  #define ASYNC_FILE_PREFETCH_BUFFER_SIZE     1460
+#endif
+
+// Responses waiting for the worker
+#ifndef ASYNC_FILE_PREFETCH_QUEUE_SIZE
+  #define ASYNC_FILE_PREFETCH_QUEUE_SIZE      16
+#endif
+
+#ifndef ASYNC_FILE_PREFETCH_STACK_SIZE
+  #define ASYNC_FILE_PREFETCH_STACK_SIZE      4096
+#endif
+
+#ifndef ASYNC_FILE_PREFETCH_PRIORITY
+  #define ASYNC_FILE_PREFETCH_PRIORITY        2
+#endif
+
+// Keep file reads off the core running async_tcp
+#ifndef ASYNC_FILE_PREFETCH_CORE
+  #if defined(CONFIG_ASYNC_TCP_RUNNING_CORE) && (CONFIG_ASYNC_TCP_RUNNING_CORE >= 0)
+    #define ASYNC_FILE_PREFETCH_CORE          (1 - CONFIG_ASYNC_TCP_RUNNING_CORE)
+  #else
+    #define ASYNC_FILE_PREFETCH_CORE          0
+  #endif
+#endif
+
+/////////////////////////////////////////////////
+
+class AsyncFilePrefetch
+{
+    using File = fs::File;
+
+  private:
+    File _file;
+    AsyncClient *_client;         // Woken when a buffer is filled while the response waits
+    uint8_t *_buffers;
+    size_t _length[ASYNC_FILE_PREFETCH_MAX_DEPTH];
+    size_t _readPos;              // In the slot being read, touched by the response only
+    uint8_t _depth;
+    uint8_t _readSlot;
+    uint8_t _writeSlot;
+    uint8_t _ready;               // Filled slots not yet read
+    uint8_t _refs;
+    bool _queued;
+    bool _eof;
+    bool _cancelled;
+    bool _waiting;                // read() answered RESPONSE_TRY_AGAIN
+
+    AsyncFilePrefetch(File& file, uint8_t depth);
+    ~AsyncFilePrefetch();
+
+    void _schedule();
+    void _fill();
+    void _unref();
+
+    static QueueHandle_t _queue;
+
+    static bool _startWorker();
+    static void _worker(void *arg);
+
+  public:
+    AsyncFilePrefetch(AsyncFilePrefetch const &) = delete;
+    AsyncFilePrefetch &operator=(AsyncFilePrefetch const &) = delete;
+
+    // Takes over the file and starts reading ahead. NULL if the worker or the buffers
+    // can't be set up, the caller then keeps reading the file itself.
+    static AsyncFilePrefetch* start(File& file, uint8_t depth);
+
+    // Connection to wake when data becomes ready after read() answered RESPONSE_TRY_AGAIN
+    void setClient(AsyncClient *client);
+
+    // Copies ready data. RESPONSE_TRY_AGAIN if none is ready yet, 0 at the end of the file.
+    size_t read(uint8_t *dst, size_t len);
+
+    // The response is done with it, pending reads are abandoned
+    void release();
+};
+
+#endif /* ASYNCFILEPREFETCH_H_ */
@@ -0,0 +1,235 @@
+/****************************************************************************************************************************
+  AsyncFrameSource.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#include "AsyncFrameSource.h"
+#include "AsyncWebWake.h"
+
+/////////////////////////////////////////////////
+
+AsyncFrameSource::AsyncFrameSource(uint8_t maxFrames)
+  : _latest(NULL)
+  , _seq(0)
+  , _maxFrames(maxFrames ? maxFrames : 1)
+  , _frames(0)
+  , _dropped(0)
+  , _waiting(NULL)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncFrameSource::~AsyncFrameSource()
+{
+  if (_latest)
+    _unref(_latest);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncFrameSource::publish(const uint8_t *data, size_t len)
+{
+  AsyncFrame *reclaim = NULL;
+  bool room = true;
+
+  portENTER_CRITICAL(&_mux);
+
+  if (_latest && (_latest->refs == 1))
+  {
+    // Nobody is sending the newest frame, it is replaced rather than kept
+    reclaim = _latest;
+    _latest = NULL;
+  }
+  else if (_frames >= _maxFrames)
+  {
+    room = false;
+    _dropped++;
+  }
+
+  if (room && !reclaim)
+    _frames++;
+
+  portEXIT_CRITICAL(&_mux);
+
+  if (!room)
+    return false;
+
+  // The reclaimed frame's slot goes to the new one, so _frames is unchanged
+  if (reclaim && (reclaim->capacity < len))
+  {
+    free(reclaim);
+    reclaim = NULL;
+  }
+
+  AsyncFrame *frame = reclaim;
+
+  if (!frame)
+  {
+    frame = (AsyncFrame *) malloc(sizeof(AsyncFrame) + len);
+
+    if (frame)
+      frame->capacity = len;
+  }
+
+  if (!frame)
+  {
+    AWS_LOGERROR1(F("[AsyncFrameSource] malloc failed, size ="), len);
+
+    portENTER_CRITICAL(&_mux);
+    _frames--;
+    _dropped++;
+    portEXIT_CRITICAL(&_mux);
+
+    return false;
+  }
+
+  memcpy((uint8_t *) frame->data(), data, len);
+  frame->len = len;
+  frame->refs = 1;
+
+  portENTER_CRITICAL(&_mux);
+
+  AsyncFrame *previous = _latest;
+  frame->seq = ++_seq;
+  _latest = frame;
+
+  portEXIT_CRITICAL(&_mux);
+
+  // The source's reference, responses still sending it keep it alive
+  if (previous)
+    _unref(previous);
+
+  _wake();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFrameSource::_wake()
+{
+  for (;;)
+  {
+    AsyncClient *clients[8];
+    uint8_t count = 0;
+
+    // A few at a time, the lwIP mailbox can't be posted to under the lock
+    portENTER_CRITICAL(&_mux);
+
+    while (_waiting && (count < 8))
+    {
+      AsyncFrameWaiter *waiter = _waiting;
+
+      _waiting = waiter->next;
+      waiter->linked = false;
+      clients[count++] = waiter->client;
+    }
+
+    portEXIT_CRITICAL(&_mux);
+
+    // Only used as keys, the responses may be gone already
+    for (uint8_t i = 0; i < count; i++)
+      AsyncWebWake::client(clients[i]);
+
+    if (count < 8)
+      return;
+  }
+}
+
+/////////////////////////////////////////////////
+
+AsyncFrame* AsyncFrameSource::acquire(uint32_t seq, AsyncFrameWaiter *waiter)
+{
+  AsyncFrame *frame = NULL;
+
+  portENTER_CRITICAL(&_mux);
+
+  if (_latest && (_latest->seq != seq))
+  {
+    frame = _latest;
+    frame->refs++;
+  }
+  else if (waiter && !waiter->linked)
+  {
+    waiter->next = _waiting;
+    waiter->linked = true;
+    _waiting = waiter;
+  }
+
+  portEXIT_CRITICAL(&_mux);
+
+  return frame;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFrameSource::forget(AsyncFrameWaiter *waiter)
+{
+  portENTER_CRITICAL(&_mux);
+
+  if (waiter->linked)
+  {
+    AsyncFrameWaiter **link = &_waiting;
+
+    while (*link != waiter)
+      link = &(*link)->next;
+
+    *link = waiter->next;
+    waiter->linked = false;
+  }
+
+  portEXIT_CRITICAL(&_mux);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFrameSource::release(AsyncFrame *frame)
+{
+  _unref(frame);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFrameSource::_unref(AsyncFrame *frame)
+{
+  portENTER_CRITICAL(&_mux);
+
+  const bool last = (--frame->refs == 0);
+
+  if (last)
+    _frames--;
+
+  portEXIT_CRITICAL(&_mux);
+
+  if (last)
+    free(frame);
+}
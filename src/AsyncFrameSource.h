@@ -0,0 +1,115 @@
+/****************************************************************************************************************************
+  AsyncFrameSource.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef ASYNCFRAMESOURCE_H_
+#define ASYNCFRAMESOURCE_H_
+
+// Latest-frame buffer for multipart/x-mixed-replace streams (MJPEG cameras, rendered charts),
+// sent with request->beginMultipartStreamResponse().
+//
+// The producer publishes complete frames from any task, each is copied once into a reference
+// counted block. Every response holds the frame it is sending and, once done, takes whatever is
+// newest, so a slow client simply skips frames. Nothing is queued per client. Responses which
+// found nothing new wait in a list, publish() wakes their connections through AsyncWebWake.
+//
+// The source must outlive every response streaming from it.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+
+/////////////////////////////////////////////////
+
+struct AsyncFrame
+{
+  uint32_t seq;
+  uint16_t refs;                // The source's own reference while newest, plus one per response
+  size_t len;
+  size_t capacity;
+
+  inline const uint8_t* data() const
+  {
+    return (const uint8_t*) (this + 1);
+  }
+};
+
+/////////////////////////////////////////////////
+
+class AsyncFrameSource
+{
+  private:
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    AsyncFrame *_latest;
+    uint32_t _seq;
+    uint8_t _maxFrames;
+    uint8_t _frames;              // Allocated, including one being published
+    uint32_t _dropped;
+    AsyncFrameWaiter *_waiting;
+
+    void _unref(AsyncFrame *frame);
+    void _wake();
+
+  public:
+    // At most maxFrames frames are kept at once : the newest, and older ones still being sent
+    AsyncFrameSource(uint8_t maxFrames = 2);
+    ~AsyncFrameSource();
+
+    AsyncFrameSource(AsyncFrameSource const &) = delete;
+    AsyncFrameSource &operator=(AsyncFrameSource const &) = delete;
+
+    // Copies a complete frame. False if it was dropped, because slow clients still hold
+    // maxFrames frames or there is no memory.
+    bool publish(const uint8_t *data, size_t len);
+
+    // For responses : the newest frame if it is not seq, with a reference. Else NULL, and the
+    // waiter is linked in, under the same lock, to be woken by the next publish().
+    AsyncFrame* acquire(uint32_t seq, AsyncFrameWaiter *waiter = NULL);
+    void release(AsyncFrame *frame);
+
+    // Unlinks a waiter which is going away
+    void forget(AsyncFrameWaiter *waiter);
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t published() const
+    {
+      return _seq;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t dropped() const
+    {
+      return _dropped;
+    }
+};
+
+#endif /* ASYNCFRAMESOURCE_H_ */
@@ -310,20 +310,23 @@ class AsyncCallbackJsonWebHandler: public AsyncWebHandler
     const size_t maxJsonBufferSize;
 #endif
 
-    size_t _maxContentLength;
-
   public:
 
     /////////////////////////////////////////////////
 
 #ifdef ARDUINOJSON_5_COMPATIBILITY
     AsyncCallbackJsonWebHandler(const String& uri, ArJsonRequestHandlerFunction onRequest)
-      : _uri(uri), _method(HTTP_POST | HTTP_PUT | HTTP_PATCH), _onRequest(onRequest), _maxContentLength(16384) {}
+      : _uri(uri), _method(HTTP_POST | HTTP_PUT | HTTP_PATCH), _onRequest(onRequest)
+    {
+      _maxContentLength = 16384;
+    }
 #else
     AsyncCallbackJsonWebHandler(const String& uri, ArJsonRequestHandlerFunction onRequest,
                                 size_t maxJsonBufferSize = DYNAMIC_JSON_DOCUMENT_SIZE)
-      : _uri(uri), _method(HTTP_POST | HTTP_PUT | HTTP_PATCH), _onRequest(onRequest), maxJsonBufferSize(maxJsonBufferSize),
-        _maxContentLength(16384) {}
+      : _uri(uri), _method(HTTP_POST | HTTP_PUT | HTTP_PATCH), _onRequest(onRequest), maxJsonBufferSize(maxJsonBufferSize)
+    {
+      _maxContentLength = 16384;
+    }
 #endif
 
     /////////////////////////////////////////////////
@@ -335,13 +338,6 @@ class AsyncCallbackJsonWebHandler: public AsyncWebHandler
 
     /////////////////////////////////////////////////
 
-    inline void setMaxContentLength(int maxContentLength)
-    {
-      _maxContentLength = maxContentLength;
-    }
-
-    /////////////////////////////////////////////////
-
     inline void onRequest(ArJsonRequestHandlerFunction fn)
     {
       _onRequest = fn;
@@ -370,22 +366,43 @@ class AsyncCallbackJsonWebHandler: public AsyncWebHandler
 
     /////////////////////////////////////////////////
 
+    // The Content-Type is only known at the end of the headers
+    virtual bool routesOnHeaders(AsyncWebServerRequest *request) override final
+    {
+      return _onRequest && (_method & request->method())
+             && (!_uri.length() || (_uri == request->url()) || request->url().startsWith(_uri + "/"));
+    }
+
+    /////////////////////////////////////////////////
+
+    // handleRequest() parses spooled bodies from request->body()
+    virtual bool canSpoolBody() override final
+    {
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+
     virtual void handleRequest(AsyncWebServerRequest *request) override final
     {
       if (_onRequest)
       {
-        if (request->_tempObject != NULL)
+        // Large bodies may have been spooled instead of collected by handleBody()
+        Stream *body = request->body();
+
+        if (body || request->_tempObject != NULL)
         {
 
 #ifdef ARDUINOJSON_5_COMPATIBILITY
           DynamicJsonBuffer jsonBuffer;
-          JsonVariant json = jsonBuffer.parse((uint8_t*)(request->_tempObject));
+          JsonVariant json = body ? jsonBuffer.parse(*body) : jsonBuffer.parse((uint8_t*)(request->_tempObject));
 
           if (json.success())
           {
 #else
           DynamicJsonDocument jsonBuffer(this->maxJsonBufferSize);
-          DeserializationError error = deserializeJson(jsonBuffer, (uint8_t*)(request->_tempObject));
+          DeserializationError error = body ? deserializeJson(jsonBuffer, *body)
+                                       : deserializeJson(jsonBuffer, (uint8_t*)(request->_tempObject));
 
           if (!error)
           {
@@ -398,7 +415,7 @@ class AsyncCallbackJsonWebHandler: public AsyncWebHandler
           }
         }
 
-        request->send(_contentLength > _maxContentLength ? 413 : 400);
+        request->send((_maxContentLength && (_contentLength > _maxContentLength)) ? 413 : 400);
       }
       else
       {
@@ -422,7 +439,7 @@ class AsyncCallbackJsonWebHandler: public AsyncWebHandler
       {
         _contentLength = total;
 
-        if (total > 0 && request->_tempObject == NULL && total < _maxContentLength)
+        if (total > 0 && request->_tempObject == NULL && (!_maxContentLength || total <= _maxContentLength))
         {
           request->_tempObject = malloc(total);
         }
@@ -0,0 +1,150 @@
+/****************************************************************************************************************************
+  AsyncMpscRing.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef ASYNCMPSCRING_H_
+#define ASYNCMPSCRING_H_
+
+// Bounded lock-free queue with many producers and a single consumer, after Dmitry Vyukov's
+// bounded MPMC queue. Used by AsyncWebSocket and AsyncEventSource to take sends from application
+// tasks, which are then drained on the async_tcp task that owns the clients.
+//
+// Every cell carries a sequence number. A producer claims a position with one CAS on the tail,
+// writes the item and publishes it by storing the next sequence, so it never blocks or waits
+// for another producer to finish. push() fails at once when the ring is full. Only one task may
+// call pop().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/////////////////////////////////////////////////
+
+template <typename T, size_t N>
+class AsyncMpscRing
+{
+    static_assert((N >= 2) && ((N & (N - 1)) == 0), "AsyncMpscRing size must be a power of 2");
+
+  private:
+    struct Cell
+    {
+      std::atomic<size_t> seq;
+      T item;
+    };
+
+    Cell _cells[N];
+    std::atomic<size_t> _tail;      // Next position to claim, shared by the producers
+    size_t _head;                   // Next position to read, consumer only
+    std::atomic<uint32_t> _dropped;
+
+  public:
+    AsyncMpscRing() : _tail(0), _head(0), _dropped(0)
+    {
+      for (size_t i = 0; i < N; i++)
+        _cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    AsyncMpscRing(AsyncMpscRing const &) = delete;
+    AsyncMpscRing &operator=(AsyncMpscRing const &) = delete;
+
+    /////////////////////////////////////////////////
+
+    // Any task. False if the ring is full, the item is then still the caller's.
+    bool push(const T& item)
+    {
+      size_t pos = _tail.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+        Cell& cell = _cells[pos & (N - 1)];
+        const intptr_t diff = (intptr_t) cell.seq.load(std::memory_order_acquire) - (intptr_t) pos;
+
+        if (diff == 0)
+        {
+          // Free cell, claim it unless another producer was faster
+          if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            cell.item = item;
+            cell.seq.store(pos + 1, std::memory_order_release);
+
+            return true;
+          }
+        }
+        else if (diff < 0)
+        {
+          // Not read yet since the last lap
+          _dropped.fetch_add(1, std::memory_order_relaxed);
+
+          return false;
+        }
+        else
+        {
+          pos = _tail.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////
+
+    // Consumer task only. False if nothing is published at the head, items come out in claim order.
+    bool pop(T& item)
+    {
+      Cell& cell = _cells[_head & (N - 1)];
+
+      if (cell.seq.load(std::memory_order_acquire) != _head + 1)
+        return false;
+
+      item = cell.item;
+      cell.seq.store(_head + N, std::memory_order_release);
+      _head++;
+
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+
+    // May be stale by the time it returns, only a hint for the consumer
+    inline bool empty() const
+    {
+      return _cells[_head & (N - 1)].seq.load(std::memory_order_acquire) != _head + 1;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Pushes refused because the ring was full
+    inline uint32_t dropped() const
+    {
+      return _dropped.load(std::memory_order_relaxed);
+    }
+};
+
+#endif /* ASYNCMPSCRING_H_ */
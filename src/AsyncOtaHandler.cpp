@@ -0,0 +1,875 @@
+/****************************************************************************************************************************
+  AsyncOtaHandler.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#include "AsyncOtaHandler.h"
+#include "AsyncWebWake.h"
+
+#include <Update.h>
+
+/////////////////////////////////////////////////
+
+#define OTA_CMD_FINISH        -1
+#define OTA_CMD_ABORT         -2
+#define OTA_CMD_QUIT          -3
+#define OTA_CMD_BEGIN         -4
+
+#define OTA_DIGEST_NONE       0
+#define OTA_DIGEST_MD5        1
+#define OTA_DIGEST_SHA256     2
+
+// Guards the failure of an upload, set by either task
+static portMUX_TYPE _otaMux = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaUpdateTarget::begin(size_t size)
+{
+  return Update.begin(size ? size : UPDATE_SIZE_UNKNOWN);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaUpdateTarget::write(const uint8_t *data, size_t len)
+{
+  return Update.write((uint8_t *) data, len) == len;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaUpdateTarget::end()
+{
+  return Update.end(true);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaUpdateTarget::abort()
+{
+  Update.abort();
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncOtaUpdateTarget::errorString()
+{
+  return Update.errorString();
+}
+
+/////////////////////////////////////////////////
+
+AsyncOtaFileTarget::~AsyncOtaFileTarget()
+{
+  if (_file)
+    fclose(_file);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaFileTarget::begin(size_t size)
+{
+  ESP32_ENC_AWS_UNUSED(size);
+
+  if (_file)
+    fclose(_file);
+
+  _file = fopen(_path.c_str(), "wb");
+
+  return _file != NULL;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaFileTarget::write(const uint8_t *data, size_t len)
+{
+  return _file && (fwrite(data, 1, len, _file) == len);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaFileTarget::end()
+{
+  if (!_file)
+    return false;
+
+  const bool ok = (fclose(_file) == 0);
+  _file = NULL;
+
+  return ok;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaFileTarget::abort()
+{
+  if (_file)
+  {
+    fclose(_file);
+    _file = NULL;
+  }
+
+  remove(_path.c_str());
+}
+
+/////////////////////////////////////////////////
+
+AsyncOtaHandler::AsyncOtaHandler(const char *uri, AsyncOtaTarget *target)
+  : _uri(uri)
+  , _target(target ? target : new AsyncOtaUpdateTarget())
+  , _onProgress(NULL)
+  , _onEnd(NULL)
+  , _free(NULL)
+  , _filled(NULL)
+  , _done(NULL)
+  , _request(NULL)
+  , _client(NULL)
+  , _buffers(NULL)
+  , _fillSlot(-1)
+  , _fillLen(0)
+  , _backlog(NULL)
+  , _backlogLen(0)
+  , _backlogSize(0)
+  , _received(0)
+  , _total(0)
+  , _startMs(0)
+  , _elapsedMs(0)
+  , _bodyDone(false)
+  , _respond(false)
+  , _pending(false)
+  , _finished(false)
+  , _success(false)
+  , _written(0)
+  , _failed(false)
+  , _error(NULL)
+  , _digestType(OTA_DIGEST_NONE)
+{
+  mbedtls_md5_init(&_md5);
+  mbedtls_sha256_init(&_sha256);
+}
+
+/////////////////////////////////////////////////
+
+AsyncOtaHandler::~AsyncOtaHandler()
+{
+  if (_filled)
+  {
+    int8_t cmd;
+    bool result;
+
+    if (_request && !_finished && !_pending)
+    {
+      cmd = OTA_CMD_ABORT;
+      xQueueSend(_filled, &cmd, portMAX_DELAY);
+      _pending = true;
+    }
+
+    // Not on the async_tcp task, the worker answers once it wrote what it holds
+    if (_pending)
+      xQueueReceive(_done, &result, portMAX_DELAY);
+
+    cmd = OTA_CMD_QUIT;
+    xQueueSend(_filled, &cmd, portMAX_DELAY);
+    xQueueReceive(_done, &result, portMAX_DELAY);
+
+    vQueueDelete(_free);
+    vQueueDelete(_filled);
+    vQueueDelete(_done);
+  }
+
+  free(_buffers);
+  free(_backlog);
+
+  mbedtls_md5_free(&_md5);
+  mbedtls_sha256_free(&_sha256);
+
+  delete _target;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaHandler::_startWorker()
+{
+  if (_filled)
+    return true;
+
+  // OTA_CMD_BEGIN, both buffers and the end of the upload : never full
+  _free = xQueueCreate(2, sizeof(int8_t));
+  _filled = xQueueCreate(4, sizeof(int8_t));
+  _done = xQueueCreate(1, sizeof(bool));
+
+  if (_free && _filled && _done &&
+      (xTaskCreatePinnedToCore(_worker, "aws_ota", ASYNC_OTA_STACK_SIZE, this, ASYNC_OTA_PRIORITY, NULL,
+                               ASYNC_OTA_CORE) == pdPASS))
+  {
+    return true;
+  }
+
+  AWS_LOGERROR(F("[AsyncOtaHandler] Can't start worker"));
+
+  if (_free)
+    vQueueDelete(_free);
+
+  if (_filled)
+    vQueueDelete(_filled);
+
+  if (_done)
+    vQueueDelete(_done);
+
+  _free = _filled = _done = NULL;
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_worker(void *arg)
+{
+  ((AsyncOtaHandler *) arg)->_work();
+
+  vTaskDelete(NULL);
+}
+
+/////////////////////////////////////////////////
+
+// Worker task : hashes and writes full buffers, finishes or abandons the image.
+// The answer to OTA_CMD_FINISH / OTA_CMD_ABORT comes after every buffer was handed back,
+// until then the async_tcp task doesn't reuse them.
+void AsyncOtaHandler::_work()
+{
+  for (;;)
+  {
+    int8_t cmd;
+
+    if (xQueueReceive(_filled, &cmd, portMAX_DELAY) != pdTRUE)
+      continue;
+
+    // Set by _begin() before its first command
+    AsyncClient *client = _client;
+
+    if (cmd == OTA_CMD_BEGIN)
+    {
+      if (!_target->begin(_total))
+        _fail(_target->errorString());
+
+      continue;
+    }
+
+    if (cmd >= 0)
+    {
+      if (!_failed)
+      {
+        const uint8_t *data = _buffers + cmd * ASYNC_OTA_BUFFER_SIZE;
+
+        _digestUpdate(data, _length[cmd]);
+
+        if (_target->write(data, _length[cmd]))
+          _written += _length[cmd];
+        else
+          _fail(_target->errorString());
+      }
+
+      xQueueSend(_free, &cmd, portMAX_DELAY);
+
+      // Data may be held for this buffer
+      AsyncWebWake::client(client);
+
+      continue;
+    }
+
+    bool result = false;
+
+    if (cmd == OTA_CMD_FINISH)
+    {
+      if (!_failed && !_digestMatches())
+        _fail("checksum mismatch");
+
+      if (!_failed && !_target->end())
+        _fail(_target->errorString());
+
+      result = !_failed;
+    }
+
+    if (!result && (cmd != OTA_CMD_QUIT))
+      _target->abort();
+
+    xQueueSend(_done, &result, portMAX_DELAY);
+
+    if (cmd == OTA_CMD_QUIT)
+      return;
+
+    // handleRequest() may wait for the outcome
+    AsyncWebWake::client(client);
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_fail(const char *error)
+{
+  portENTER_CRITICAL(&_otaMux);
+
+  const bool first = !_failed;
+
+  if (first)
+  {
+    _error = error;
+    _failed = true;
+  }
+
+  portEXIT_CRITICAL(&_otaMux);
+
+  if (first)
+    AWS_LOGERROR1(F("[AsyncOtaHandler] Update failed :"), error);
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncOtaHandler::error() const
+{
+  portENTER_CRITICAL(&_otaMux);
+  const char *error = _error;
+  portEXIT_CRITICAL(&_otaMux);
+
+  return error ? error : "";
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaHandler::canHandle(AsyncWebServerRequest *request)
+{
+  if (!(request->method() & (HTTP_POST | HTTP_PUT)))
+    return false;
+
+  if (request->url() != _uri)
+    return false;
+
+  request->addInterestingHeader("X-Update-SHA256");
+  request->addInterestingHeader("X-Update-MD5");
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+int AsyncOtaHandler::checkBody(AsyncWebServerRequest *request)
+{
+  // Also while the worker still ends an abandoned upload
+  if ((_request && (_request != request)) || !_collect())
+    return 409;
+
+  return AsyncWebHandler::checkBody(request);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaHandler::_begin(AsyncWebServerRequest *request, size_t total)
+{
+  if (_request || !_collect())
+    return false;
+
+  if (!_buffers)
+    _buffers = (uint8_t *) malloc(2 * ASYNC_OTA_BUFFER_SIZE);
+
+  if (!_buffers || !_startWorker())
+  {
+    AWS_LOGERROR(F("[AsyncOtaHandler] Out of memory"));
+
+    return false;
+  }
+
+  int8_t slot;
+
+  // The worker is idle and handed back every buffer it had, take back the ones still queued
+  while (xQueueReceive(_free, &slot, 0) == pdTRUE);
+
+  _request = request;
+  _client = request->client();
+  _fillSlot = -1;
+  _fillLen = 0;
+  _backlogLen = 0;
+  _received = 0;
+  _total = total;
+  _startMs = millis();
+  _elapsedMs = 0;
+  _bodyDone = false;
+  _respond = false;
+  _finished = false;
+  _success = false;
+  _written = 0;
+
+  portENTER_CRITICAL(&_otaMux);
+  _failed = false;
+  _error = NULL;
+  portEXIT_CRITICAL(&_otaMux);
+
+  _digestBegin();
+
+  // Drop the upload if the client goes away
+  request->onDisconnect([this, request]()
+  {
+    _abort(request);
+  });
+
+  // The client may wait for a buffer longer than the request timeout
+  _client->setRxTimeout(0);
+
+  // Both buffers are free to begin with
+  for (slot = 0; slot < 2; slot++)
+    xQueueSend(_free, &slot, 0);
+
+  slot = OTA_CMD_BEGIN;
+  xQueueSend(_filled, &slot, 0);
+
+  AWS_LOGINFO1(F("[AsyncOtaHandler] Update started, size ="), total);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_digestBegin()
+{
+  _digestType = OTA_DIGEST_NONE;
+  _expectedDigest = String();
+
+  if (_request->hasHeader("X-Update-SHA256"))
+    _expectedDigest = _request->header("X-Update-SHA256");
+  else if (_request->hasParam("sha256"))
+    _expectedDigest = _request->getParam("sha256")->value();
+
+  if (_expectedDigest.length())
+  {
+    _digestType = OTA_DIGEST_SHA256;
+
+    // Hands back a hardware engine still held by an abandoned upload
+    mbedtls_sha256_free(&_sha256);
+    mbedtls_sha256_init(&_sha256);
+
+#if (MBEDTLS_VERSION_NUMBER < 0x02070000)
+    mbedtls_sha256_starts(&_sha256, 0);
+#else
+    mbedtls_sha256_starts_ret(&_sha256, 0);
+#endif
+
+    return;
+  }
+
+  if (_request->hasHeader("X-Update-MD5"))
+    _expectedDigest = _request->header("X-Update-MD5");
+  else if (_request->hasParam("md5"))
+    _expectedDigest = _request->getParam("md5")->value();
+
+  if (_expectedDigest.length())
+  {
+    _digestType = OTA_DIGEST_MD5;
+
+    mbedtls_md5_free(&_md5);
+    mbedtls_md5_init(&_md5);
+
+#if (MBEDTLS_VERSION_NUMBER < 0x02070000)
+    mbedtls_md5_starts(&_md5);
+#else
+    mbedtls_md5_starts_ret(&_md5);
+#endif
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_digestUpdate(const uint8_t *data, size_t len)
+{
+#if (MBEDTLS_VERSION_NUMBER < 0x02070000)
+
+  if (_digestType == OTA_DIGEST_SHA256)
+    mbedtls_sha256_update(&_sha256, data, len);
+  else if (_digestType == OTA_DIGEST_MD5)
+    mbedtls_md5_update(&_md5, data, len);
+
+#else
+
+  if (_digestType == OTA_DIGEST_SHA256)
+    mbedtls_sha256_update_ret(&_sha256, data, len);
+  else if (_digestType == OTA_DIGEST_MD5)
+    mbedtls_md5_update_ret(&_md5, data, len);
+
+#endif
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncOtaHandler::_digestMatches()
+{
+  if (_digestType == OTA_DIGEST_NONE)
+    return true;
+
+  uint8_t digest[32];
+  size_t len;
+
+#if (MBEDTLS_VERSION_NUMBER < 0x02070000)
+
+  if (_digestType == OTA_DIGEST_SHA256)
+    mbedtls_sha256_finish(&_sha256, digest);
+  else
+    mbedtls_md5_finish(&_md5, digest);
+
+#else
+
+  if (_digestType == OTA_DIGEST_SHA256)
+    mbedtls_sha256_finish_ret(&_sha256, digest);
+  else
+    mbedtls_md5_finish_ret(&_md5, digest);
+
+#endif
+
+  len = (_digestType == OTA_DIGEST_SHA256) ? 32 : 16;
+
+  if (_expectedDigest.length() != len * 2)
+    return false;
+
+  char hex[65];
+
+  for (size_t i = 0; i < len; i++)
+    sprintf(hex + (i * 2), "%02x", digest[i]);
+
+  return _expectedDigest.equalsIgnoreCase(hex);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_feed(const uint8_t *data, size_t len)
+{
+  _received += len;
+
+  // Buffers may have come back since the last poll
+  _drain();
+
+  if (_failed)
+    return;
+
+  // Behind what is held already
+  const size_t n = _backlogLen ? 0 : _fill(data, len);
+
+  if ((n < len) && !_hold(data + n, len - n))
+    _fail("flash write too slow");
+}
+
+/////////////////////////////////////////////////
+
+// Copies into the free buffers without waiting, and hands full ones to the worker.
+// Returns how much was taken.
+size_t AsyncOtaHandler::_fill(const uint8_t *data, size_t len)
+{
+  size_t taken = 0;
+
+  while (taken < len)
+  {
+    if (_fillSlot < 0)
+    {
+      if (xQueueReceive(_free, &_fillSlot, 0) != pdTRUE)
+      {
+        _fillSlot = -1;
+
+        break;
+      }
+
+      _fillLen = 0;
+    }
+
+    const size_t n = std::min(len - taken, (size_t) ASYNC_OTA_BUFFER_SIZE - _fillLen);
+
+    memcpy(_buffers + _fillSlot * ASYNC_OTA_BUFFER_SIZE + _fillLen, data + taken, n);
+    _fillLen += n;
+    taken += n;
+
+    if (_fillLen == ASYNC_OTA_BUFFER_SIZE)
+      _submit();
+  }
+
+  return taken;
+}
+
+/////////////////////////////////////////////////
+
+// Both buffers are being written : keep the data and don't ack it, the client stops once its window is full
+bool AsyncOtaHandler::_hold(const uint8_t *data, size_t len)
+{
+  if (_backlogLen + len > _backlogSize)
+  {
+    if (_backlogLen + len > ASYNC_OTA_BACKLOG_SIZE)
+      return false;
+
+    const size_t size = std::min(std::max(_backlogSize * 2, _backlogLen + len), (size_t) ASYNC_OTA_BACKLOG_SIZE);
+    uint8_t *backlog = (uint8_t *) realloc(_backlog, size);
+
+    if (!backlog)
+      return false;
+
+    _backlog = backlog;
+    _backlogSize = size;
+  }
+
+  memcpy(_backlog + _backlogLen, data, len);
+  _backlogLen += len;
+
+  _request->client()->ackLater();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+// Moves held data into the buffers the worker handed back, then lets the client send again
+void AsyncOtaHandler::_drain()
+{
+  if (!_backlogLen)
+    return;
+
+  // Nothing is written any more after a failure
+  const size_t n = _failed ? _backlogLen : _fill(_backlog, _backlogLen);
+
+  _backlogLen -= n;
+  memmove(_backlog, _backlog + n, _backlogLen);
+
+  if (_backlogLen)
+    return;
+
+  // Every delayed ack, ack() stops at those
+  _request->client()->ack(SIZE_MAX);
+
+  if (_bodyDone)
+    _finish();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_submit()
+{
+  _length[_fillSlot] = _fillLen;
+
+  // Never full, see _startWorker()
+  xQueueSend(_filled, &_fillSlot, 0);
+
+  _fillSlot = -1;
+  _fillLen = 0;
+
+  if (_onProgress)
+    _onProgress(_written, _total);
+}
+
+/////////////////////////////////////////////////
+
+// End of the body : the last buffer and the commit, once the held data is in the buffers.
+// The image is checked by the worker, _collect() takes the outcome.
+void AsyncOtaHandler::_finish()
+{
+  _bodyDone = true;
+
+  if (_pending || _finished || _backlogLen)
+    return;
+
+  if (!_failed && (_fillSlot >= 0) && _fillLen)
+    _submit();
+
+  int8_t cmd = OTA_CMD_FINISH;
+
+  xQueueSend(_filled, &cmd, 0);
+  _pending = true;
+}
+
+/////////////////////////////////////////////////
+
+// Takes the worker's answer to OTA_CMD_FINISH / OTA_CMD_ABORT without waiting.
+// False while it's still due, the buffers are the worker's until then.
+bool AsyncOtaHandler::_collect()
+{
+  if (!_pending)
+    return true;
+
+  bool result;
+
+  if (xQueueReceive(_done, &result, 0) != pdTRUE)
+    return false;
+
+  _pending = false;
+  _finished = true;
+  _success = result;
+  _elapsedMs = millis() - _startMs;
+
+  AWS_LOGINFO3(F("[AsyncOtaHandler] Update"), _success ? F("done") : F("failed"), F(", bytes ="), _written);
+  AWS_LOGINFO3(F("[AsyncOtaHandler] ms ="), _elapsedMs, F(", bytes/s ="), throughput());
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+// Sends the response once handleRequest() was called and the image is committed or abandoned
+void AsyncOtaHandler::_answer()
+{
+  if (!_respond || !_collect() || !_finished)
+    return;
+
+  AsyncWebServerRequest *request = _request;
+  const bool success = _success;
+
+  if (_onEnd)
+    _onEnd(request, success);
+  else if (success)
+    request->send(200, "text/plain", "OK");
+  else
+    request->send(500, "text/plain", error());
+
+  _release();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_abort(AsyncWebServerRequest *request)
+{
+  if (_request != request)
+    return;
+
+  if (!_finished && !_pending)
+  {
+    AWS_LOGWARN(F("[AsyncOtaHandler] Upload aborted"));
+
+    int8_t cmd = OTA_CMD_ABORT;
+
+    _fail("upload aborted");
+
+    xQueueSend(_filled, &cmd, 0);
+    _pending = true;
+  }
+
+  // The next upload takes the answer and the buffers back
+  _release();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::_release()
+{
+  if (_request)
+    _request->onDisconnect(NULL);
+
+  _request = NULL;
+  _respond = false;
+
+  free(_backlog);
+  _backlog = NULL;
+  _backlogLen = 0;
+  _backlogSize = 0;
+}
+
+/////////////////////////////////////////////////
+
+uint32_t AsyncOtaHandler::throughput() const
+{
+  const uint32_t ms = _finished ? _elapsedMs : (millis() - _startMs);
+
+  return ms ? (uint32_t) ((uint64_t) _written * 1000 / ms) : 0;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index,
+                                 size_t total)
+{
+  // Raw image as the request body
+  if (index == 0 && !_begin(request, total))
+    return;
+
+  if (_request != request)
+    return;
+
+  _feed(data, len);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data,
+                                   size_t len, bool final)
+{
+  ESP32_ENC_AWS_UNUSED(filename);
+  ESP32_ENC_AWS_UNUSED(final);
+
+  if (index == 0)
+  {
+    // One image per upload, a second file in the form fails it
+    if (_request == request)
+    {
+      _fail("more than one file");
+
+      return;
+    }
+
+    // Its size isn't known
+    if (!_begin(request, 0))
+      return;
+  }
+
+  if (_request != request)
+    return;
+
+  _feed(data, len);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::handleRequest(AsyncWebServerRequest *request)
+{
+  if ((_username != "" && _password != "") && !request->authenticate(_username.c_str(), _password.c_str()))
+    return request->requestAuthentication();
+
+  if (_request != request)
+  {
+    request->send(_request ? 409 : 400, "text/plain", _request ? "Update in progress" : "No image");
+
+    return;
+  }
+
+  // The rest of the multipart form is read, no more files can follow
+  _respond = true;
+  _finish();
+  _answer();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncOtaHandler::handlePoll(AsyncWebServerRequest *request)
+{
+  if (_request != request)
+    return;
+
+  _drain();
+  _answer();
+}
@@ -0,0 +1,282 @@
+/****************************************************************************************************************************
+  AsyncOtaHandler.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef ASYNCOTAHANDLER_H_
+#define ASYNCOTAHANDLER_H_
+
+// Firmware upload handler. Takes a raw body (POST/PUT with any Content-Type) or the file part
+// of a multipart form, collects it into flash sector sized buffers, and hands full buffers to a
+// worker task. The network keeps filling the second buffer while the first one is erased and
+// written. The async_tcp task never waits for the worker : when flash is slower than the network,
+// what arrives meanwhile is held and its TCP ack delayed, which stops the client until a buffer
+// is free again and the worker wakes the connection.
+//
+// An expected digest can be given with an X-Update-SHA256 / X-Update-MD5 header, or a sha256 /
+// md5 query parameter. It is computed by the worker as the data is written, and the image is
+// only committed when it matches.
+//
+// Where the image goes is up to an AsyncOtaTarget : the Update library by default, or a plain
+// file with AsyncOtaFileTarget.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+
+#include "mbedtls/md5.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/version.h"
+
+/////////////////////////////////////////////////
+
+// One flash sector
+#ifndef ASYNC_OTA_BUFFER_SIZE
+  #define ASYNC_OTA_BUFFER_SIZE         4096
+#endif
+
+// Most data held while the worker writes both buffers. The delayed ack keeps it within the
+// TCP window, the upload fails beyond this.
+#ifndef ASYNC_OTA_BACKLOG_SIZE
+  #define ASYNC_OTA_BACKLOG_SIZE        16384
+#endif
+
+#ifndef ASYNC_OTA_STACK_SIZE
+  #define ASYNC_OTA_STACK_SIZE          4096
+#endif
+
+#ifndef ASYNC_OTA_PRIORITY
+  #define ASYNC_OTA_PRIORITY            2
+#endif
+
+// Keep flash writes off the core running async_tcp
+#ifndef ASYNC_OTA_CORE
+  #if defined(CONFIG_ASYNC_TCP_RUNNING_CORE) && (CONFIG_ASYNC_TCP_RUNNING_CORE >= 0)
+    #define ASYNC_OTA_CORE              (1 - CONFIG_ASYNC_TCP_RUNNING_CORE)
+  #else
+    #define ASYNC_OTA_CORE              0
+  #endif
+#endif
+
+/////////////////////////////////////////////////
+
+// Where an uploaded image is written. All calls but the constructor come from the worker task.
+class AsyncOtaTarget
+{
+  public:
+    virtual ~AsyncOtaTarget() {}
+
+    // size is 0 when unknown, e.g. for a multipart upload
+    virtual bool begin(size_t size) = 0;
+    virtual bool write(const uint8_t *data, size_t len) = 0;
+
+    // Commits the image
+    virtual bool end() = 0;
+    virtual void abort() = 0;
+
+    // Describes the last failure, a string which stays valid like a literal
+    virtual const char* errorString()
+    {
+      return "write failed";
+    }
+};
+
+/////////////////////////////////////////////////
+
+// The running firmware's OTA partition, through the Update library
+class AsyncOtaUpdateTarget: public AsyncOtaTarget
+{
+  public:
+    bool begin(size_t size) override;
+    bool write(const uint8_t *data, size_t len) override;
+    bool end() override;
+    void abort() override;
+    const char* errorString() override;
+};
+
+/////////////////////////////////////////////////
+
+// A plain file image through stdio, e.g. "/littlefs/firmware.bin" or a path on the host
+class AsyncOtaFileTarget: public AsyncOtaTarget
+{
+  private:
+    String _path;
+    FILE *_file;
+
+  public:
+    AsyncOtaFileTarget(const char *path): _path(path), _file(NULL) {}
+    ~AsyncOtaFileTarget();
+
+    bool begin(size_t size) override;
+    bool write(const uint8_t *data, size_t len) override;
+    bool end() override;
+    void abort() override;
+};
+
+/////////////////////////////////////////////////
+
+typedef std::function<void(size_t written, size_t total)> ArOtaProgressHandler;
+typedef std::function<void(AsyncWebServerRequest *request, bool success)> ArOtaEndHandler;
+
+/////////////////////////////////////////////////
+
+class AsyncOtaHandler: public AsyncWebHandler
+{
+  private:
+    String _uri;
+    AsyncOtaTarget *_target;
+    ArOtaProgressHandler _onProgress;
+    ArOtaEndHandler _onEnd;
+
+    QueueHandle_t _free;          // Buffer index, ready to be filled
+    QueueHandle_t _filled;        // Buffer index or OTA_CMD_*, for the worker
+    QueueHandle_t _done;          // Outcome of OTA_CMD_FINISH / OTA_CMD_ABORT / OTA_CMD_QUIT
+
+    // Upload in progress, one at a time. Only the async_tcp task uses these.
+    AsyncWebServerRequest *_request;
+    AsyncClient *_client;         // Woken by the worker, only used as a key
+    uint8_t *_buffers;
+    size_t _length[2];
+    int8_t _fillSlot;             // -1 while no buffer is held
+    size_t _fillLen;
+    uint8_t *_backlog;            // Arrived while both buffers were written, not acked yet
+    size_t _backlogLen;
+    size_t _backlogSize;
+    size_t _received;
+    size_t _total;
+    uint32_t _startMs;
+    uint32_t _elapsedMs;
+    bool _bodyDone;               // OTA_CMD_FINISH is sent once the backlog is written
+    bool _respond;                // handleRequest() waits for the outcome
+    bool _pending;                // OTA_CMD_FINISH / OTA_CMD_ABORT sent, its outcome not received yet
+    bool _finished;
+    bool _success;
+
+    // Also set by the worker, see _fail()
+    volatile size_t _written;
+    volatile bool _failed;
+    const char *_error;
+
+    uint8_t _digestType;
+    String _expectedDigest;
+    mbedtls_md5_context _md5;
+    mbedtls_sha256_context _sha256;
+
+    bool _startWorker();
+    static void _worker(void *arg);
+    void _work();
+
+    bool _begin(AsyncWebServerRequest *request, size_t total);
+    void _feed(const uint8_t *data, size_t len);
+    size_t _fill(const uint8_t *data, size_t len);
+    bool _hold(const uint8_t *data, size_t len);
+    void _drain();
+    void _submit();
+    void _finish();
+    bool _collect();
+    void _answer();
+    void _abort(AsyncWebServerRequest *request);
+    void _release();
+    void _fail(const char *error);
+
+    void _digestBegin();
+    void _digestUpdate(const uint8_t *data, size_t len);
+    bool _digestMatches();
+
+  public:
+    // Takes ownership of the target, NULL writes through the Update library
+    AsyncOtaHandler(const char *uri, AsyncOtaTarget *target = NULL);
+    ~AsyncOtaHandler();
+
+    /////////////////////////////////////////////////
+
+    // Called on the async_tcp task after each buffer is handed to the worker, total 0 if unknown
+    inline AsyncOtaHandler& onProgress(ArOtaProgressHandler fn)
+    {
+      _onProgress = fn;
+      return *this;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Sends the response instead of the default 200 "OK" / 500 with the error
+    inline AsyncOtaHandler& onEnd(ArOtaEndHandler fn)
+    {
+      _onEnd = fn;
+      return *this;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline bool busy() const
+    {
+      return _request != NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Bytes written by the target so far
+    inline size_t written() const
+    {
+      return _written;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Of the current or last upload, "" if none failed
+    const char* error() const;
+
+    // Of the current or last upload, bytes per second
+    uint32_t throughput() const;
+
+    virtual bool canHandle(AsyncWebServerRequest *request) override final;
+    virtual int checkBody(AsyncWebServerRequest *request) override final;
+    virtual void handleRequest(AsyncWebServerRequest *request) override final;
+    virtual void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data,
+                              size_t len, bool final) override final;
+    virtual void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index,
+                            size_t total) override final;
+    virtual void handlePoll(AsyncWebServerRequest *request) override final;
+
+    /////////////////////////////////////////////////
+
+    virtual bool isRequestHandlerTrivial() override final
+    {
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+
+    virtual bool canSpoolBody() override final
+    {
+      return false;
+    }
+};
+
+#endif /* ASYNCOTAHANDLER_H_ */
@@ -0,0 +1,314 @@
+/****************************************************************************************************************************
+  AsyncResponseCache.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#include "AsyncResponseCache.h"
+
+/////////////////////////////////////////////////
+
+std::vector<AsyncCacheEntryPtr> AsyncResponseCache::_entries;
+volatile size_t AsyncResponseCache::_budget = ASYNC_RESPONSE_CACHE_BUDGET;
+volatile uint32_t AsyncResponseCache::_clears = 0;
+uint32_t AsyncResponseCache::_clearsDone = 0;
+size_t AsyncResponseCache::_used = 0;
+uint32_t AsyncResponseCache::_hits = 0;
+uint32_t AsyncResponseCache::_misses = 0;
+
+// clear() may come from any task
+static portMUX_TYPE _cacheMux = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+// FNV-1a
+static uint32_t cacheHash(const uint8_t *data, size_t len, uint32_t hash = 2166136261UL)
+{
+  while (len--)
+  {
+    hash ^= *data++;
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncCacheEntry::footprint() const
+{
+  size_t size = sizeof(AsyncCacheEntry) + key.length() + contentType.length() + length;
+
+  for (const auto& header : headers)
+    size += sizeof(header) + header.first.length() + header.second.length();
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+
+AsyncCacheCapture::AsyncCacheCapture(const String& key, uint32_t hash, uint32_t ttl)
+  : _entry(new AsyncCacheEntry())
+  , _capacity(0)
+  , _clears(AsyncResponseCache::clears())
+  , _failed(false)
+{
+  _entry->key = key;
+  _entry->hash = hash;
+  _entry->ttl = ttl;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncCacheCapture::setResponse(int code, const String& contentType, bool compress)
+{
+  _entry->code = code;
+  _entry->contentType = contentType;
+  _entry->compress = compress;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncCacheCapture::addHeader(const String& name, const String& value)
+{
+  _entry->headers.emplace_back(name, value);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncCacheCapture::append(const uint8_t *data, size_t len)
+{
+  if (_failed || !len)
+    return;
+
+  const size_t needed = _entry->length + len;
+
+  if (needed > _capacity)
+  {
+    // Can never be stored, stop copying
+    if (needed > AsyncResponseCache::budget())
+    {
+      _failed = true;
+
+      free(_entry->body);
+      _entry->body = NULL;
+
+      return;
+    }
+
+    size_t capacity = std::max(needed, std::min(2 * _capacity, AsyncResponseCache::budget()));
+    uint8_t *body = (uint8_t *) realloc(_entry->body, capacity);
+
+    if (!body)
+    {
+      _failed = true;
+
+      return;
+    }
+
+    _entry->body = body;
+    _capacity = capacity;
+  }
+
+  memcpy(_entry->body + _entry->length, data, len);
+  _entry->length = needed;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncCacheCapture::complete()
+{
+  // The data it was rendered from changed meanwhile
+  if (_failed || (_clears != AsyncResponseCache::clears()))
+    return;
+
+  // Give back the slack of the last doubling
+  if (_capacity > _entry->length)
+  {
+    uint8_t *body = (uint8_t *) realloc(_entry->body, _entry->length ? _entry->length : 1);
+
+    if (body)
+      _entry->body = body;
+  }
+
+  snprintf(_entry->etag, sizeof(_entry->etag), "\"%08x-%x\"", (unsigned) cacheHash(_entry->body, _entry->length),
+           (unsigned) _entry->length);
+
+  AsyncResponseCache::store(_entry);
+
+  // Stored or not, this capture is done
+  _failed = true;
+}
+
+/////////////////////////////////////////////////
+
+uint32_t AsyncResponseCache::hash(const String& key)
+{
+  return cacheHash((const uint8_t *) key.c_str(), key.length());
+}
+
+/////////////////////////////////////////////////
+
+AsyncCacheEntryPtr AsyncResponseCache::find(const String& key, uint32_t hash)
+{
+  _apply();
+
+  const uint32_t now = millis();
+
+  for (size_t i = 0; i < _entries.size(); i++)
+  {
+    const AsyncCacheEntryPtr& entry = _entries[i];
+
+    if (entry->hash != hash || entry->key != key)
+      continue;
+
+    if (entry->expired(now))
+    {
+      _remove(i);
+
+      break;
+    }
+
+    _hits++;
+    entry->lastUsed = now;
+
+    return entry;
+  }
+
+  _misses++;
+
+  return AsyncCacheEntryPtr();
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseCache::store(const AsyncCacheEntryPtr& entry)
+{
+  _apply();
+
+  // Rendered again by a concurrent miss, the newer one wins
+  for (size_t i = 0; i < _entries.size(); i++)
+  {
+    if (_entries[i]->hash == entry->hash && _entries[i]->key == entry->key)
+    {
+      _remove(i);
+
+      break;
+    }
+  }
+
+  const size_t size = entry->footprint();
+
+  if (!_makeRoom(size))
+    return;
+
+  entry->storedAt = entry->lastUsed = millis();
+
+  _entries.push_back(entry);
+  _used += size;
+
+  AWS_LOGDEBUG3("[AsyncResponseCache] Stored", entry->key, ", bytes =", size);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncResponseCache::_makeRoom(size_t needed)
+{
+  if (needed > _budget)
+    return false;
+
+  const uint32_t now = millis();
+
+  for (size_t i = _entries.size(); i-- > 0; )
+  {
+    if (_entries[i]->expired(now))
+      _remove(i);
+  }
+
+  while (_used + needed > _budget)
+  {
+    size_t oldest = 0;
+
+    for (size_t i = 1; i < _entries.size(); i++)
+    {
+      if ((now - _entries[i]->lastUsed) > (now - _entries[oldest]->lastUsed))
+        oldest = i;
+    }
+
+    _remove(oldest);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseCache::_remove(size_t index)
+{
+  _used -= _entries[index]->footprint();
+
+  _entries[index] = _entries.back();
+  _entries.pop_back();
+}
+
+/////////////////////////////////////////////////
+
+// async_tcp task : carries out setBudget() and clear() calls made since the last lookup
+void AsyncResponseCache::_apply()
+{
+  const uint32_t clears = _clears;
+
+  if (clears != _clearsDone)
+  {
+    _clearsDone = clears;
+
+    _entries.clear();
+    _used = 0;
+  }
+
+  if (_used > _budget)
+    _makeRoom(0);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseCache::setBudget(size_t bytes)
+{
+  _budget = bytes;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseCache::clear()
+{
+  portENTER_CRITICAL(&_cacheMux);
+  _clears++;
+  portEXIT_CRITICAL(&_cacheMux);
+}
@@ -0,0 +1,193 @@
+/****************************************************************************************************************************
+  AsyncResponseCache.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef ASYNCRESPONSECACHE_H_
+#define ASYNCRESPONSECACHE_H_
+
+// Rendered responses of AsyncCallbackWebHandler::setCache() routes, kept for a TTL.
+//
+// On a miss the handler runs as usual, and the body its response produces is copied into a
+// new entry as it is sent. Once the response is complete the entry gets an ETag and is stored.
+// Hits are sent from the entry without calling the handler, or answered with 304 when the
+// client already has that ETag. All routes share one memory budget, expired entries go first,
+// then the least recently used. Entries are shared, an evicted entry lives on until the
+// responses sending it are done.
+//
+// Responses setting a cookie, or with Cache-Control no-store or private, are never stored.
+//
+// Everything but setBudget() and clear() runs on the async_tcp task, there is no locking. Those
+// two may be called from any task, and take effect before the next lookup.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+
+#include <memory>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+// Bytes of rendered responses kept for all routes, see AsyncResponseCache::setBudget()
+#ifndef ASYNC_RESPONSE_CACHE_BUDGET
+  #define ASYNC_RESPONSE_CACHE_BUDGET     16384
+#endif
+
+/////////////////////////////////////////////////
+
+struct AsyncCacheEntry
+{
+  String key;
+  uint32_t hash;
+  uint32_t storedAt;
+  uint32_t ttl;
+  uint32_t lastUsed;
+
+  int code;
+  String contentType;
+  std::vector<std::pair<String, String>> headers;
+  bool compress;
+
+  uint8_t *body;
+  size_t length;
+  char etag[24];
+
+  AsyncCacheEntry(): hash(0), storedAt(0), ttl(0), lastUsed(0), code(200), compress(false), body(NULL), length(0)
+  {
+    etag[0] = 0;
+  }
+
+  ~AsyncCacheEntry()
+  {
+    free(body);
+  }
+
+  /////////////////////////////////////////////////
+
+  inline bool expired(uint32_t now) const
+  {
+    return (now - storedAt) >= ttl;
+  }
+
+  // Bytes counted against the budget
+  size_t footprint() const;
+};
+
+typedef std::shared_ptr<AsyncCacheEntry> AsyncCacheEntryPtr;
+
+/////////////////////////////////////////////////
+
+// Collects the body of a response on a miss, owned by the response
+class AsyncCacheCapture
+{
+  private:
+    AsyncCacheEntryPtr _entry;
+    size_t _capacity;
+    uint32_t _clears;             // Rendered before a later clear() if it changed
+    bool _failed;
+
+  public:
+    AsyncCacheCapture(const String& key, uint32_t hash, uint32_t ttl);
+
+    void setResponse(int code, const String& contentType, bool compress);
+    void addHeader(const String& name, const String& value);
+    void append(const uint8_t *data, size_t len);
+
+    // The whole body went through append(), the entry is stored
+    void complete();
+};
+
+/////////////////////////////////////////////////
+
+class AsyncResponseCache
+{
+  private:
+    static std::vector<AsyncCacheEntryPtr> _entries;
+    static volatile size_t _budget;
+    static volatile uint32_t _clears;
+    static uint32_t _clearsDone;
+    static size_t _used;
+    static uint32_t _hits;
+    static uint32_t _misses;
+
+    static void _apply();
+    static void _remove(size_t index);
+    static bool _makeRoom(size_t needed);
+
+  public:
+    // Any task. Shared by all routes, 0 disables caching. Shrinking it evicts before the next lookup.
+    static void setBudget(size_t bytes);
+
+    // Any task. Drops every entry, and the responses still being captured.
+    static void clear();
+
+    // Current entry for the key, NULL on a miss
+    static AsyncCacheEntryPtr find(const String& key, uint32_t hash);
+    static void store(const AsyncCacheEntryPtr& entry);
+
+    static uint32_t hash(const String& key);
+
+    /////////////////////////////////////////////////
+
+    static inline size_t budget()
+    {
+      return _budget;
+    }
+
+    /////////////////////////////////////////////////
+
+    static inline uint32_t clears()
+    {
+      return _clears;
+    }
+
+    /////////////////////////////////////////////////
+
+    static inline size_t used()
+    {
+      return _used;
+    }
+
+    /////////////////////////////////////////////////
+
+    static inline uint32_t hits()
+    {
+      return _hits;
+    }
+
+    /////////////////////////////////////////////////
+
+    static inline uint32_t misses()
+    {
+      return _misses;
+    }
+};
+
+#endif /* ASYNCRESPONSECACHE_H_ */
@@ -0,0 +1,99 @@
+/****************************************************************************************************************************
+  AsyncWebArena.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebArena.h"
+
+#include <stdlib.h>
+
+/////////////////////////////////////////////////
+
+void* AsyncWebArena::alloc(size_t size)
+{
+  size = _align(size ? size : 1);
+
+  const size_t capacity = _blocks ? _blocks->size : sizeof(_first);
+
+  if (_used + size > capacity)
+  {
+    const size_t blockSize = (size > ASYNC_WEB_ARENA_SIZE) ? size : ASYNC_WEB_ARENA_SIZE;
+    Block* block = (Block*) malloc(_align(sizeof(Block)) + blockSize);
+
+    if (!block)
+      return NULL;
+
+    block->next = _blocks;
+    block->size = blockSize;
+    _blocks = block;
+    _used = 0;
+  }
+
+  uint8_t* p = (_blocks ? _data(_blocks) : _first) + _used;
+
+  _used += size;
+  _total += size;
+
+  return p;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebArena::owns(const void* p) const
+{
+  const uint8_t* q = (const uint8_t*) p;
+
+  if ((q >= _first) && (q < _first + sizeof(_first)))
+    return _total != 0;
+
+  for (Block* block = _blocks; block; block = block->next)
+  {
+    if ((q >= _data(block)) && (q < _data(block) + block->size))
+      return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebArena::reset()
+{
+  while (_blocks)
+  {
+    Block* next = _blocks->next;
+
+    free(_blocks);
+    _blocks = next;
+  }
+
+  _used = 0;
+  _total = 0;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************************************************************
+  AsyncWebArena.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBARENA_H_
+#define ASYNCWEBARENA_H_
+
+// Bump allocator owned by each request. Headers, parameters, path parameters and handler scratch
+// memory (AsyncWebServerRequest::tempAlloc()) are carved from a first block inside the request,
+// then from overflow blocks on the heap, and all of it is given back at once when the request ends
+// or is recycled. Nothing is freed individually : destructors of objects made with create() are
+// run by their owner, the memory itself only goes away with reset().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+/////////////////////////////////////////////////
+
+// Bytes of the first block, inside every request. Also the minimum size of an overflow block.
+#ifndef ASYNC_WEB_ARENA_SIZE
+  #define ASYNC_WEB_ARENA_SIZE      512
+#endif
+
+#define ASYNC_WEB_ARENA_ALIGN       alignof(long double)
+
+/////////////////////////////////////////////////
+
+class AsyncWebArena
+{
+  private:
+    struct Block
+    {
+      Block* next;
+      size_t size;
+    };
+
+    Block* _blocks;             // Overflow blocks, newest first
+    size_t _used;               // Bytes taken in the newest block, _first while there's none
+    size_t _total;              // Bytes handed out since the last reset()
+    alignas(ASYNC_WEB_ARENA_ALIGN) uint8_t _first[ASYNC_WEB_ARENA_SIZE];
+
+    static inline size_t _align(size_t n)
+    {
+      return (n + ASYNC_WEB_ARENA_ALIGN - 1) & ~(ASYNC_WEB_ARENA_ALIGN - 1);
+    }
+
+    static inline uint8_t* _data(Block* block)
+    {
+      return (uint8_t*) block + _align(sizeof(Block));
+    }
+
+  public:
+    AsyncWebArena() : _blocks(NULL), _used(0), _total(0) {}
+
+    ~AsyncWebArena()
+    {
+      reset();
+    }
+
+    AsyncWebArena(AsyncWebArena const &) = delete;
+    AsyncWebArena &operator=(AsyncWebArena const &) = delete;
+
+    // size bytes, aligned for any type. NULL if an overflow block can't be allocated.
+    void* alloc(size_t size);
+
+    // Whether p was handed out by this arena since the last reset()
+    bool owns(const void* p) const;
+
+    // Frees the overflow blocks, the first block is reused
+    void reset();
+
+    /////////////////////////////////////////////////
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+      void* p = alloc(sizeof(T));
+
+      return p ? new (p) T(std::forward<Args>(args)...) : NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline size_t used() const
+    {
+      return _total;
+    }
+};
+
+#endif /* ASYNCWEBARENA_H_ */
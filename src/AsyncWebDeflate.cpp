@@ -0,0 +1,601 @@
+/****************************************************************************************************************************
+  AsyncWebDeflate.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebDeflate.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#if defined(ESP32)
+  #include "Arduino.h"
+  #include "AsyncWebServer_ESP32_ENC_Debug.h"
+#else
+  #define AWS_LOGERROR1(x,y)
+#endif
+
+/////////////////////////////////////////////////
+
+#define DEFLATE_MIN_MATCH         3
+#define DEFLATE_MAX_MATCH         258
+#define DEFLATE_END_OF_BLOCK      256
+
+static const uint16_t _lengthBase[29] =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t _lengthExtra[29] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t _distanceBase[30] =
+{
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+  4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const uint8_t _distanceExtra[30] =
+{
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Half-byte table for the reflected CRC-32 polynomial 0xEDB88320
+static const uint32_t _crcTable[16] =
+{
+  0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+  0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+/////////////////////////////////////////////////
+
+// Huffman codes are defined MSB first but packed LSB first
+static inline uint32_t _reverseBits(uint32_t code, uint8_t count)
+{
+  uint32_t result = 0;
+
+  while (count--)
+  {
+    result = (result << 1) | (code & 1);
+    code >>= 1;
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+
+// Largest index with table[index] <= value
+template<typename T, size_t N>
+static inline uint8_t _findCode(const T (&table)[N], size_t value)
+{
+  uint8_t lo = 0;
+  uint8_t hi = N - 1;
+
+  while (lo < hi)
+  {
+    uint8_t mid = (lo + hi + 1) / 2;
+
+    if (table[mid] <= value)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  return lo;
+}
+
+/////////////////////////////////////////////////
+
+static inline uint32_t _hash(const uint8_t* p)
+{
+  return ((((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | p[2]) * (uint32_t) 2654435761U) >> (32 - ASYNC_DEFLATE_HASH_BITS);
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebDeflate::AsyncWebDeflate()
+  : _mem(NULL)
+  , _window(NULL)
+  , _head(NULL)
+  , _prev(NULL)
+  , _out(NULL)
+  , _windowStart(0)
+  , _windowLen(0)
+  , _outLen(0)
+  , _outPos(0)
+  , _bitBuf(0)
+  , _bitCount(0)
+  , _encoding(ASYNC_ENCODING_NONE)
+  , _finished(false)
+  , _crc(0)
+  , _totalIn(0)
+  , _totalOut(0)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebDeflate::~AsyncWebDeflate()
+{
+  free(_mem);
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncWebDeflate::memoryUsage()
+{
+  return ASYNC_DEFLATE_HASH_SIZE * sizeof(uint32_t) + ASYNC_DEFLATE_WINDOW_SIZE * sizeof(uint16_t)
+         + ASYNC_DEFLATE_WINDOW_SIZE + ASYNC_DEFLATE_INPUT_SIZE + ASYNC_DEFLATE_OUTPUT_SIZE;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebDeflate::begin(AsyncWebEncoding encoding)
+{
+  if ( (encoding != ASYNC_ENCODING_GZIP) && (encoding != ASYNC_ENCODING_DEFLATE) )
+    return false;
+
+  if (!_mem)
+  {
+    // Word-sized tables first to keep them aligned
+    _mem = (uint8_t*) malloc(memoryUsage());
+
+    if (!_mem)
+    {
+      AWS_LOGERROR1(F("[AsyncWebDeflate::begin] malloc failed, size ="), memoryUsage());
+
+      return false;
+    }
+
+    _head   = (uint32_t*) _mem;
+    _prev   = (uint16_t*) (_mem + ASYNC_DEFLATE_HASH_SIZE * sizeof(uint32_t));
+    _window = (uint8_t*) (_prev + ASYNC_DEFLATE_WINDOW_SIZE);
+    _out    = _window + ASYNC_DEFLATE_WINDOW_SIZE + ASYNC_DEFLATE_INPUT_SIZE;
+  }
+
+  memset(_head, 0, ASYNC_DEFLATE_HASH_SIZE * sizeof(uint32_t));
+
+  _windowStart = 0;
+  _windowLen = 0;
+  _outLen = 0;
+  _outPos = 0;
+  _bitBuf = 0;
+  _bitCount = 0;
+  _encoding = encoding;
+  _finished = false;
+  _totalIn = 0;
+  _totalOut = 0;
+
+  if (encoding == ASYNC_ENCODING_GZIP)
+  {
+    // ID1 ID2 CM=deflate FLG=0 MTIME=0 XFL=0 OS=unknown
+    static const uint8_t gzipHeader[10] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+
+    memcpy(_out, gzipHeader, sizeof(gzipHeader));
+    _outLen = sizeof(gzipHeader);
+    _crc = 0xffffffff;
+  }
+  else
+  {
+    const uint8_t cmf = 0x08 | ((ASYNC_DEFLATE_WINDOW_BITS - 8) << 4);
+
+    _out[0] = cmf;
+    _out[1] = 31 - ((cmf << 8) % 31);
+    _outLen = 2;
+    _crc = 1;
+  }
+
+  // A single non-final block with fixed codes, BFINAL=0 BTYPE=01
+  _putBits(0x02, 3);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+uint8_t* AsyncWebDeflate::inputBuffer(size_t& room)
+{
+  if (_windowLen > ASYNC_DEFLATE_WINDOW_SIZE)
+  {
+    // Keep one window of history in front of the new input
+    const size_t drop = _windowLen - ASYNC_DEFLATE_WINDOW_SIZE;
+
+    memmove(_window, _window + drop, ASYNC_DEFLATE_WINDOW_SIZE);
+    _windowStart += drop;
+    _windowLen = ASYNC_DEFLATE_WINDOW_SIZE;
+  }
+
+  room = (_finished || available()) ? 0 : ASYNC_DEFLATE_WINDOW_SIZE + ASYNC_DEFLATE_INPUT_SIZE - _windowLen;
+
+  if (room > ASYNC_DEFLATE_INPUT_SIZE)
+    room = ASYNC_DEFLATE_INPUT_SIZE;
+
+  return _window + _windowLen;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::commit(size_t len)
+{
+  if (!len || _finished)
+    return;
+
+  // The output buffer is sized for one full input buffer, drain it first
+  _outLen = 0;
+  _outPos = 0;
+
+  _checksum(_window + _windowLen, len);
+  _totalIn += len;
+
+  const size_t from = _windowLen;
+  _windowLen += len;
+
+  _compress(from, _windowLen);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::finish()
+{
+  if (_finished || !_mem)
+    return;
+
+  if (_outPos == _outLen)
+  {
+    _outLen = 0;
+    _outPos = 0;
+  }
+
+  // End the open block, then an empty final block, then pad to a byte boundary
+  _putSymbol(DEFLATE_END_OF_BLOCK);
+  _putBits(0x03, 3);
+  _putSymbol(DEFLATE_END_OF_BLOCK);
+  _flushBits();
+
+  if (_encoding == ASYNC_ENCODING_GZIP)
+  {
+    const uint32_t crc = ~_crc;
+
+    for (uint8_t i = 0; i < 4; i++)
+      _putByte(crc >> (8 * i));
+
+    for (uint8_t i = 0; i < 4; i++)
+      _putByte(_totalIn >> (8 * i));
+  }
+  else
+  {
+    for (int8_t i = 3; i >= 0; i--)
+      _putByte(_crc >> (8 * i));
+  }
+
+  _finished = true;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncWebDeflate::read(uint8_t* dst, size_t len)
+{
+  const size_t n = (len < available()) ? len : available();
+
+  memcpy(dst, _out + _outPos, n);
+  _outPos += n;
+  _totalOut += n;
+
+  return n;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::_putByte(uint8_t value)
+{
+  _out[_outLen++] = value;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::_putBits(uint32_t value, uint8_t count)
+{
+  _bitBuf |= value << _bitCount;
+  _bitCount += count;
+
+  while (_bitCount >= 8)
+  {
+    _putByte(_bitBuf);
+    _bitBuf >>= 8;
+    _bitCount -= 8;
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::_flushBits()
+{
+  if (_bitCount)
+    _putByte(_bitBuf);
+
+  _bitBuf = 0;
+  _bitCount = 0;
+}
+
+/////////////////////////////////////////////////
+
+// Fixed literal/length code, RFC 1951 section 3.2.6
+void AsyncWebDeflate::_putSymbol(uint16_t symbol)
+{
+  if (symbol < 144)
+    _putBits(_reverseBits(0x30 + symbol, 8), 8);
+  else if (symbol < 256)
+    _putBits(_reverseBits(0x190 + symbol - 144, 9), 9);
+  else if (symbol < 280)
+    _putBits(_reverseBits(symbol - 256, 7), 7);
+  else
+    _putBits(_reverseBits(0xc0 + symbol - 280, 8), 8);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::_putMatch(size_t length, size_t distance)
+{
+  const uint8_t lengthCode = _findCode(_lengthBase, length);
+
+  _putSymbol(257 + lengthCode);
+
+  if (_lengthExtra[lengthCode])
+    _putBits(length - _lengthBase[lengthCode], _lengthExtra[lengthCode]);
+
+  const uint8_t distanceCode = _findCode(_distanceBase, distance);
+
+  _putBits(_reverseBits(distanceCode, 5), 5);
+
+  if (_distanceExtra[distanceCode])
+    _putBits(distance - _distanceBase[distanceCode], _distanceExtra[distanceCode]);
+}
+
+/////////////////////////////////////////////////
+
+// Greedy LZ77 over _window[from, to). Matches don't extend past to, so every commit is
+// fully encoded and nothing is held back waiting for more input.
+void AsyncWebDeflate::_compress(size_t from, size_t to)
+{
+  size_t i = from;
+
+  while (i < to)
+  {
+    const size_t avail = to - i;
+    size_t bestLen = 0;
+    size_t bestDistance = 0;
+
+    if (avail >= DEFLATE_MIN_MATCH)
+    {
+      const size_t maxLen = (avail < DEFLATE_MAX_MATCH) ? avail : DEFLATE_MAX_MATCH;
+      const uint32_t pos = _windowStart + i;
+      const uint32_t h = _hash(_window + i);
+
+      uint32_t candidate = _head[h];
+      _head[h] = pos + 1;
+
+      // A distance of WINDOW_SIZE or more would alias the _prev slot, store 0 for "none"
+      const uint32_t distance = candidate ? pos - (candidate - 1) : 0;
+      _prev[pos & (ASYNC_DEFLATE_WINDOW_SIZE - 1)] = (distance < ASYNC_DEFLATE_WINDOW_SIZE) ? distance : 0;
+
+      uint8_t chain = ASYNC_DEFLATE_MAX_CHAIN;
+
+      while (candidate && chain--)
+      {
+        const uint32_t match = candidate - 1;
+        const uint32_t dist = pos - match;
+
+        if ( (dist >= ASYNC_DEFLATE_WINDOW_SIZE) || (match < _windowStart) )
+          break;
+
+        const uint8_t* a = _window + i;
+        const uint8_t* b = _window + (match - _windowStart);
+
+        // Only worth a full compare if it could beat the current best
+        if (b[bestLen] == a[bestLen])
+        {
+          size_t len = 0;
+
+          while ( (len < maxLen) && (a[len] == b[len]) )
+            len++;
+
+          if (len > bestLen)
+          {
+            bestLen = len;
+            bestDistance = dist;
+
+            if (len == maxLen)
+              break;
+          }
+        }
+
+        const uint16_t step = _prev[match & (ASYNC_DEFLATE_WINDOW_SIZE - 1)];
+
+        if (!step)
+          break;
+
+        candidate = match - step + 1;
+      }
+    }
+
+    if (bestLen >= DEFLATE_MIN_MATCH)
+    {
+      _putMatch(bestLen, bestDistance);
+
+      // Index the positions inside the match too, as far as 3 bytes are available
+      for (size_t k = 1; k < bestLen; k++)
+      {
+        const size_t j = i + k;
+
+        if (to - j < DEFLATE_MIN_MATCH)
+          break;
+
+        const uint32_t pos = _windowStart + j;
+        const uint32_t h = _hash(_window + j);
+        const uint32_t distance = _head[h] ? pos - (_head[h] - 1) : 0;
+
+        _prev[pos & (ASYNC_DEFLATE_WINDOW_SIZE - 1)] = (distance < ASYNC_DEFLATE_WINDOW_SIZE) ? distance : 0;
+        _head[h] = pos + 1;
+      }
+
+      i += bestLen;
+    }
+    else
+    {
+      _putSymbol(_window[i]);
+      i++;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebDeflate::_checksum(const uint8_t* data, size_t len)
+{
+  if (_encoding == ASYNC_ENCODING_GZIP)
+  {
+    uint32_t crc = _crc;
+
+    while (len--)
+    {
+      crc ^= *data++;
+      crc = (crc >> 4) ^ _crcTable[crc & 0x0f];
+      crc = (crc >> 4) ^ _crcTable[crc & 0x0f];
+    }
+
+    _crc = crc;
+  }
+  else
+  {
+    // Adler-32, sums reduced before they can overflow
+    uint32_t a = _crc & 0xffff;
+    uint32_t b = _crc >> 16;
+
+    while (len)
+    {
+      size_t n = (len < 5552) ? len : 5552;
+      len -= n;
+
+      while (n--)
+      {
+        a += *data++;
+        b += a;
+      }
+
+      a %= 65521;
+      b %= 65521;
+    }
+
+    _crc = (b << 16) | a;
+  }
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebEncoding AsyncWebDeflate::select(uint8_t accepted)
+{
+  if (accepted & ASYNC_ENCODING_GZIP)
+    return ASYNC_ENCODING_GZIP;
+
+  if (accepted & ASYNC_ENCODING_DEFLATE)
+    return ASYNC_ENCODING_DEFLATE;
+
+  return ASYNC_ENCODING_NONE;
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncWebDeflate::name(AsyncWebEncoding encoding)
+{
+  return (encoding == ASYNC_ENCODING_GZIP) ? "gzip" : ((encoding == ASYNC_ENCODING_DEFLATE) ? "deflate" : "identity");
+}
+
+/////////////////////////////////////////////////
+
+static bool _tokenIs(const char* token, size_t len, const char* name)
+{
+  return (strlen(name) == len) && (strncasecmp(token, name, len) == 0);
+}
+
+/////////////////////////////////////////////////
+
+uint8_t AsyncWebDeflate::parseAcceptEncoding(const char* value)
+{
+  uint8_t accepted = 0;
+
+  while (value && *value)
+  {
+    const char* end = strchr(value, ',');
+    const char* stop = end ? end : value + strlen(value);
+
+    while ( (value < stop) && ((*value == ' ') || (*value == '\t')) )
+      value++;
+
+    const char* tokenEnd = value;
+
+    while ( (tokenEnd < stop) && (*tokenEnd != ';') && (*tokenEnd != ' ') && (*tokenEnd != '\t') )
+      tokenEnd++;
+
+    // "q=0", "q=0.0" ... means not acceptable
+    bool refused = false;
+    const char* q = (const char*) memchr(tokenEnd, '=', stop - tokenEnd);
+
+    if (q && (q > tokenEnd) && ((q[-1] == 'q') || (q[-1] == 'Q')))
+    {
+      refused = true;
+
+      for (const char* p = q + 1; p < stop; p++)
+      {
+        if ( (*p >= '1') && (*p <= '9') )
+          refused = false;
+      }
+    }
+
+    const size_t len = tokenEnd - value;
+
+    if (!refused)
+    {
+      if (_tokenIs(value, len, "gzip") || _tokenIs(value, len, "x-gzip"))
+        accepted |= ASYNC_ENCODING_GZIP;
+      else if (_tokenIs(value, len, "deflate"))
+        accepted |= ASYNC_ENCODING_DEFLATE;
+      else if (_tokenIs(value, len, "*"))
+        accepted |= ASYNC_ENCODING_GZIP | ASYNC_ENCODING_DEFLATE;
+    }
+
+    value = end ? end + 1 : NULL;
+  }
+
+  return accepted;
+}
@@ -0,0 +1,202 @@
+/****************************************************************************************************************************
+  AsyncWebDeflate.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBDEFLATE_H_
+#define ASYNCWEBDEFLATE_H_
+
+// Small streaming deflate compressor (RFC 1951) with gzip (RFC 1952) or zlib (RFC 1950) framing,
+// used by AsyncAbstractResponse::setCompress().
+//
+// Trades ratio for RAM : a bounded window, greedy matching over short hash chains and a single
+// block of fixed Huffman codes, so there are no code tables to build or send. Everything lives in
+// one allocation made by begin(), about 6KB with the defaults below. The tdefl compressor in the
+// ROM wants a full 32KB dictionary and well over 100KB of state, too much for every response.
+// tests/host checks the output with zlib and benchmarks it.
+//
+// Input is written straight into the window with inputBuffer() / commit(), and each commit is
+// compressed at once into an output buffer that is drained with read() before the next commit.
+
+#include <stdint.h>
+#include <stddef.h>
+
+/////////////////////////////////////////////////
+
+// Matches reach back at most 2^ASYNC_DEFLATE_WINDOW_BITS bytes, 8..15
+#ifndef ASYNC_DEFLATE_WINDOW_BITS
+  #define ASYNC_DEFLATE_WINDOW_BITS       10
+#endif
+
+#ifndef ASYNC_DEFLATE_HASH_BITS
+  #define ASYNC_DEFLATE_HASH_BITS         9
+#endif
+
+// Max input bytes per commit(), also bounds the output buffer
+#ifndef ASYNC_DEFLATE_INPUT_SIZE
+  #define ASYNC_DEFLATE_INPUT_SIZE        512
+#endif
+
+// Candidates tried per position, more is slower but finds longer matches
+#ifndef ASYNC_DEFLATE_MAX_CHAIN
+  #define ASYNC_DEFLATE_MAX_CHAIN         16
+#endif
+
+// Known-length bodies below this are not worth compressing
+#ifndef ASYNC_DEFLATE_MIN_LENGTH
+  #define ASYNC_DEFLATE_MIN_LENGTH        128
+#endif
+
+#define ASYNC_DEFLATE_WINDOW_SIZE         (1UL << ASYNC_DEFLATE_WINDOW_BITS)
+#define ASYNC_DEFLATE_HASH_SIZE           (1UL << ASYNC_DEFLATE_HASH_BITS)
+// 9 bits per literal at worst, plus block framing and trailer
+#define ASYNC_DEFLATE_OUTPUT_SIZE         (ASYNC_DEFLATE_INPUT_SIZE + ASYNC_DEFLATE_INPUT_SIZE / 8 + 32)
+
+static_assert(ASYNC_DEFLATE_WINDOW_BITS >= 8 && ASYNC_DEFLATE_WINDOW_BITS <= 15, "ASYNC_DEFLATE_WINDOW_BITS must be 8..15");
+
+/////////////////////////////////////////////////
+
+// Content codings, also used as bit flags for the Accept-Encoding of a request
+typedef enum
+{
+  ASYNC_ENCODING_NONE     = 0,
+  ASYNC_ENCODING_GZIP     = 1 << 0,
+  ASYNC_ENCODING_DEFLATE  = 1 << 1
+} AsyncWebEncoding;
+
+/////////////////////////////////////////////////
+
+class AsyncWebDeflate
+{
+  private:
+    uint8_t* _mem;              // Single allocation for all buffers below
+
+    uint8_t* _window;           // Last WINDOW_SIZE bytes of history followed by new input
+    uint32_t* _head;            // Hash -> absolute position + 1 of the newest occurrence, 0 if none
+    uint16_t* _prev;            // Position & (WINDOW_SIZE - 1) -> distance to the previous occurrence
+    uint8_t* _out;
+
+    uint32_t _windowStart;      // Absolute stream position of _window[0]
+    size_t _windowLen;
+    size_t _outLen;
+    size_t _outPos;
+
+    uint32_t _bitBuf;
+    uint8_t _bitCount;
+
+    AsyncWebEncoding _encoding;
+    bool _finished;
+
+    uint32_t _crc;              // CRC-32 for gzip, Adler-32 for zlib
+    uint32_t _totalIn;
+    uint32_t _totalOut;
+
+    void _putBits(uint32_t value, uint8_t count);
+    void _putSymbol(uint16_t symbol);
+    void _putMatch(size_t length, size_t distance);
+    void _putByte(uint8_t value);
+    void _flushBits();
+    void _compress(size_t from, size_t to);
+    void _checksum(const uint8_t* data, size_t len);
+
+  public:
+    AsyncWebDeflate();
+    ~AsyncWebDeflate();
+
+    AsyncWebDeflate(AsyncWebDeflate const &) = delete;
+    AsyncWebDeflate &operator=(AsyncWebDeflate const &) = delete;
+
+    // Allocates the buffers and writes the stream header. False if out of memory.
+    bool begin(AsyncWebEncoding encoding);
+
+    // Where to put the next input, at most room bytes. Only valid while available() is 0.
+    uint8_t* inputBuffer(size_t& room);
+
+    // Compresses len bytes placed at inputBuffer()
+    void commit(size_t len);
+
+    // Ends the stream, the rest of the output becomes available
+    void finish();
+
+    // Copies out compressed bytes, returns how many
+    size_t read(uint8_t* dst, size_t len);
+
+    /////////////////////////////////////////////////
+
+    inline size_t available() const
+    {
+      return _outLen - _outPos;
+    }
+
+    /////////////////////////////////////////////////
+
+    // All output has been produced and read
+    inline bool done() const
+    {
+      return _finished && !available();
+    }
+
+    /////////////////////////////////////////////////
+
+    inline AsyncWebEncoding encoding() const
+    {
+      return _encoding;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t totalIn() const
+    {
+      return _totalIn;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t totalOut() const
+    {
+      return _totalOut;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Bytes allocated by begin()
+    static size_t memoryUsage();
+
+    // Picks the coding to use from the request's Accept-Encoding flags, gzip first
+    static AsyncWebEncoding select(uint8_t accepted);
+
+    // Content-Encoding value for the coding
+    static const char* name(AsyncWebEncoding encoding);
+
+    // ASYNC_ENCODING_* flags for an Accept-Encoding header value, q=0 entries excluded
+    static uint8_t parseAcceptEncoding(const char* value);
+};
+
+#endif /* ASYNCWEBDEFLATE_H_ */
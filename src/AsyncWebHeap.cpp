@@ -0,0 +1,123 @@
+/****************************************************************************************************************************
+  AsyncWebHeap.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncWebHeap.h"
+
+#include "esp_heap_caps.h"
+
+/////////////////////////////////////////////////
+
+AsyncHeapStatus AsyncWebHeap::_status = { ASYNC_HEAP_NORMAL, ASYNC_WEB_HEAP_LOW, ASYNC_WEB_HEAP_CRITICAL, 0, SIZE_MAX, 0, 0, 0, 0 };
+
+// Guards _status, checks run on the async_tcp task while status() is read from anywhere
+static portMUX_TYPE _heapMux = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+void AsyncWebHeap::setWatermarks(size_t low, size_t critical)
+{
+  portENTER_CRITICAL(&_heapMux);
+  _status.lowMark = low;
+  _status.criticalMark = critical;
+  portEXIT_CRITICAL(&_heapMux);
+}
+
+/////////////////////////////////////////////////
+
+AsyncHeapMode AsyncWebHeap::check()
+{
+  // Internal RAM is what the stack, the request and the send buffers come from, PSRAM doesn't count
+  const size_t freeHeap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+  portENTER_CRITICAL(&_heapMux);
+
+  const AsyncHeapMode previous = _status.mode;
+  const size_t lowExit = _status.lowMark + ((previous >= ASYNC_HEAP_LOW) ? ASYNC_WEB_HEAP_HYSTERESIS : 0);
+  const size_t criticalExit = _status.criticalMark + ((previous == ASYNC_HEAP_CRITICAL) ? ASYNC_WEB_HEAP_HYSTERESIS : 0);
+  AsyncHeapMode mode = ASYNC_HEAP_NORMAL;
+
+  if (_status.criticalMark && (freeHeap < criticalExit))
+    mode = ASYNC_HEAP_CRITICAL;
+  else if (_status.lowMark && (freeHeap < lowExit))
+    mode = ASYNC_HEAP_LOW;
+
+  if ((mode >= ASYNC_HEAP_LOW) && (previous == ASYNC_HEAP_NORMAL))
+    _status.lowEntered++;
+
+  if ((mode == ASYNC_HEAP_CRITICAL) && (previous != ASYNC_HEAP_CRITICAL))
+    _status.criticalEntered++;
+
+  _status.mode = mode;
+  _status.freeHeap = freeHeap;
+
+  if (freeHeap < _status.minFreeHeap)
+    _status.minFreeHeap = freeHeap;
+
+  portEXIT_CRITICAL(&_heapMux);
+
+  if (mode != previous)
+  {
+    AWS_LOGWARN2(F("[AsyncWebHeap] mode, free heap ="), mode, freeHeap);
+  }
+
+  return mode;
+}
+
+/////////////////////////////////////////////////
+
+AsyncHeapStatus AsyncWebHeap::status()
+{
+  portENTER_CRITICAL(&_heapMux);
+  AsyncHeapStatus status = _status;
+  portEXIT_CRITICAL(&_heapMux);
+
+  return status;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebHeap::_degraded()
+{
+  portENTER_CRITICAL(&_heapMux);
+  _status.degraded++;
+  portEXIT_CRITICAL(&_heapMux);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebHeap::_refused()
+{
+  portENTER_CRITICAL(&_heapMux);
+  _status.refused++;
+  portEXIT_CRITICAL(&_heapMux);
+}
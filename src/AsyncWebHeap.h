@@ -0,0 +1,121 @@
+/****************************************************************************************************************************
+  AsyncWebHeap.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBHEAP_H_
+#define ASYNCWEBHEAP_H_
+
+// Admission control on free internal heap, see AsyncWebServer::setHeapWatermarks().
+//
+// Below the low mark responses are sent without compression, from smaller send buffers, and
+// template responses are answered with 503. Below the critical mark new connections get a canned
+// 503 with Retry-After before any request is allocated for them. A mode is only left once the
+// free heap is ASYNC_WEB_HEAP_HYSTERESIS above its mark, so that it doesn't flap around it.
+// The heap is shared, so are the marks and the mode by every server.
+
+#include <stdint.h>
+#include <stddef.h>
+
+/////////////////////////////////////////////////
+
+// Free internal heap, in bytes. 0 turns the mode off.
+#ifndef ASYNC_WEB_HEAP_LOW
+  #define ASYNC_WEB_HEAP_LOW              0
+#endif
+
+#ifndef ASYNC_WEB_HEAP_CRITICAL
+  #define ASYNC_WEB_HEAP_CRITICAL         0
+#endif
+
+#ifndef ASYNC_WEB_HEAP_HYSTERESIS
+  #define ASYNC_WEB_HEAP_HYSTERESIS       2048
+#endif
+
+// Largest send buffer of a response below the low mark
+#ifndef ASYNC_WEB_HEAP_LOW_BUFFER
+  #define ASYNC_WEB_HEAP_LOW_BUFFER       536
+#endif
+
+// Seconds, a string literal
+#ifndef ASYNC_WEB_HEAP_RETRY_AFTER
+  #define ASYNC_WEB_HEAP_RETRY_AFTER      "5"
+#endif
+
+/////////////////////////////////////////////////
+
+typedef enum
+{
+  ASYNC_HEAP_NORMAL,
+  ASYNC_HEAP_LOW,
+  ASYNC_HEAP_CRITICAL
+} AsyncHeapMode;
+
+typedef struct
+{
+  AsyncHeapMode mode;
+  size_t lowMark;
+  size_t criticalMark;
+  size_t freeHeap;          // At the last check
+  size_t minFreeHeap;       // Lowest seen by a check
+  uint32_t lowEntered;      // Times the low mode was entered from the normal one
+  uint32_t criticalEntered;
+  uint32_t degraded;        // Responses sent below the low mark
+  uint32_t refused;         // Connections and template responses answered with 503
+} AsyncHeapStatus;
+
+/////////////////////////////////////////////////
+
+class AsyncWebHeap
+{
+  private:
+    static AsyncHeapStatus _status;
+
+  public:
+    static void setWatermarks(size_t low, size_t critical);
+
+    // Measures the free heap and updates the mode. Called for each new connection and response.
+    static AsyncHeapMode check();
+
+    static AsyncHeapStatus status();
+
+    static void _degraded();
+    static void _refused();
+
+    /////////////////////////////////////////////////
+
+    // As of the last check
+    static inline AsyncHeapMode mode()
+    {
+      return _status.mode;
+    }
+};
+
+#endif /* ASYNCWEBHEAP_H_ */
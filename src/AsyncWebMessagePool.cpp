@@ -0,0 +1,235 @@
+/****************************************************************************************************************************
+  AsyncWebMessagePool.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncWebMessagePool.h"
+
+/////////////////////////////////////////////////
+
+// Constant initialized, begin() may run from the constructor of a global AsyncWebSocket
+AsyncWebSlab AsyncWebMessagePool::_slabs[ASYNC_WEB_POOL_COUNT];
+
+/////////////////////////////////////////////////
+
+bool AsyncWebSlab::begin(size_t blockSize, size_t count)
+{
+  if (_memory.load(std::memory_order_acquire))
+    return true;
+
+  if (!count)
+    return false;
+
+  // Every block must hold the free list link and stay aligned for any object
+  const size_t align = sizeof(void *) * 2;
+
+  blockSize = (blockSize < sizeof(void *)) ? sizeof(void *) : blockSize;
+  blockSize = (blockSize + align - 1) & ~(align - 1);
+
+  uint8_t *memory = (uint8_t *) malloc(blockSize * count);
+
+  if (!memory)
+  {
+    AWS_LOGERROR1(F("[AsyncWebSlab] malloc failed, size ="), blockSize * count);
+
+    return false;
+  }
+
+  // Link all blocks, lowest address first
+  for (size_t i = 0; i < count; i++)
+    *(void **) (memory + i * blockSize) = (i + 1 < count) ? memory + (i + 1) * blockSize : NULL;
+
+  {
+    AsyncWebLockGuard l(_lock);
+
+    // Another task's begin() got there first
+    if (!_memory.load(std::memory_order_relaxed))
+    {
+      _end = memory + blockSize * count;
+      _blockSize = blockSize;
+      _free = memory;
+      _stats.blockSize = blockSize;
+      _stats.count = count;
+      _stats.available = count;
+      _stats.lowWater = count;
+
+      _memory.store(memory, std::memory_order_release);
+      memory = NULL;
+    }
+  }
+
+  free(memory);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void* AsyncWebSlab::alloc(bool countMiss)
+{
+  AsyncWebLockGuard l(_lock);
+
+  void *p = _free;
+
+  if (!p)
+  {
+    if (countMiss)
+      _stats.misses++;
+
+    return NULL;
+  }
+
+  _free = *(void **) p;
+  _stats.hits++;
+
+  if (--_stats.available < _stats.lowWater)
+    _stats.lowWater = _stats.available;
+
+  return p;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebSlab::countMiss()
+{
+  AsyncWebLockGuard l(_lock);
+
+  _stats.misses++;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebSlab::release(void* p)
+{
+  if (!owns(p))
+    return false;
+
+  AsyncWebLockGuard l(_lock);
+
+  *(void **) p = _free;
+  _free = p;
+  _stats.available++;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebSlabStats AsyncWebSlab::stats() const
+{
+  AsyncWebLockGuard l(_lock);
+
+  return _stats;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+void AsyncWebMessagePool::begin()
+{
+  if (ASYNC_WEB_MSG_POOL_OBJECTS)
+    _slabs[ASYNC_WEB_POOL_OBJECTS].begin(ASYNC_WEB_MSG_POOL_OBJECT_SIZE, ASYNC_WEB_MSG_POOL_OBJECTS);
+
+  if (ASYNC_WEB_MSG_POOL_SMALL)
+    _slabs[ASYNC_WEB_POOL_SMALL].begin(ASYNC_WEB_MSG_POOL_SMALL_SIZE, ASYNC_WEB_MSG_POOL_SMALL);
+
+  if (ASYNC_WEB_MSG_POOL_MEDIUM)
+    _slabs[ASYNC_WEB_POOL_MEDIUM].begin(ASYNC_WEB_MSG_POOL_MEDIUM_SIZE, ASYNC_WEB_MSG_POOL_MEDIUM);
+}
+
+/////////////////////////////////////////////////
+
+void* AsyncWebMessagePool::allocObject(size_t size)
+{
+  AsyncWebSlab& slab = _slabs[ASYNC_WEB_POOL_OBJECTS];
+  void *p = (size <= slab.blockSize()) ? slab.alloc() : NULL;
+
+  // Throws or aborts like any new when the heap is exhausted too
+  return p ? p : ::operator new(size);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebMessagePool::freeObject(void* p)
+{
+  if (p && !_slabs[ASYNC_WEB_POOL_OBJECTS].release(p))
+    ::operator delete(p);
+}
+
+/////////////////////////////////////////////////
+
+void* AsyncWebMessagePool::allocPayload(size_t size)
+{
+  AsyncWebSlab *fits = NULL;
+
+  for (uint8_t i = ASYNC_WEB_POOL_SMALL; i <= ASYNC_WEB_POOL_MEDIUM; i++)
+  {
+    if (size <= _slabs[i].blockSize())
+    {
+      if (!fits)
+        fits = &_slabs[i];
+
+      void *p = _slabs[i].alloc(false);
+
+      if (p)
+        return p;
+    }
+  }
+
+  // Only a payload that ends up on the heap is a miss, of the smallest class it fits
+  if (fits)
+    fits->countMiss();
+
+  return malloc(size);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebMessagePool::freePayload(void* p)
+{
+  if (!p)
+    return;
+
+  for (uint8_t i = ASYNC_WEB_POOL_SMALL; i <= ASYNC_WEB_POOL_MEDIUM; i++)
+  {
+    if (_slabs[i].release(p))
+      return;
+  }
+
+  free(p);
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebSlabStats AsyncWebMessagePool::stats(AsyncWebPoolId pool)
+{
+  return (pool < ASYNC_WEB_POOL_COUNT) ? _slabs[pool].stats() : AsyncWebSlabStats();
+}
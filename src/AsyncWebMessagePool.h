@@ -0,0 +1,195 @@
+/****************************************************************************************************************************
+  AsyncWebMessagePool.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBMESSAGEPOOL_H_
+#define ASYNCWEBMESSAGEPOOL_H_
+
+// Preallocated memory for WebSocket and EventSource messages, which are made and freed for every
+// send and every client and would otherwise fragment the heap at high message rates.
+//
+// One slab of fixed size blocks holds the message objects (AsyncWebSocketBasicMessage,
+// AsyncWebSocketMultiMessage, AsyncWebSocketControl, AsyncEventSourceMessage), through the
+// operator new / delete of AsyncWebPooledObject. Two slabs of size classes hold small payloads.
+// Each slab is a single allocation made by begin(), when the first AsyncWebSocket or
+// AsyncEventSource is constructed. When a slab is empty, or a payload is too large for any of
+// them, the heap is used as before. Messages may be made on any task, the free lists are guarded
+// by a spin lock.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncWebSynchronization.h"
+
+#include <atomic>
+
+/////////////////////////////////////////////////
+
+// Message objects, 0 = always on the heap. Blocks must fit the largest message class, which the
+// message sources check with static_assert.
+#ifndef ASYNC_WEB_MSG_POOL_OBJECTS
+  #define ASYNC_WEB_MSG_POOL_OBJECTS          32
+#endif
+
+#ifndef ASYNC_WEB_MSG_POOL_OBJECT_SIZE
+  #define ASYNC_WEB_MSG_POOL_OBJECT_SIZE      (12 * sizeof(void *))
+#endif
+
+// Payloads up to ASYNC_WEB_MSG_POOL_SMALL_SIZE bytes
+#ifndef ASYNC_WEB_MSG_POOL_SMALL
+  #define ASYNC_WEB_MSG_POOL_SMALL            32
+#endif
+
+#ifndef ASYNC_WEB_MSG_POOL_SMALL_SIZE
+  #define ASYNC_WEB_MSG_POOL_SMALL_SIZE       64
+#endif
+
+// Payloads up to ASYNC_WEB_MSG_POOL_MEDIUM_SIZE bytes
+#ifndef ASYNC_WEB_MSG_POOL_MEDIUM
+  #define ASYNC_WEB_MSG_POOL_MEDIUM           8
+#endif
+
+#ifndef ASYNC_WEB_MSG_POOL_MEDIUM_SIZE
+  #define ASYNC_WEB_MSG_POOL_MEDIUM_SIZE      256
+#endif
+
+/////////////////////////////////////////////////
+
+typedef enum
+{
+  ASYNC_WEB_POOL_OBJECTS,
+  ASYNC_WEB_POOL_SMALL,
+  ASYNC_WEB_POOL_MEDIUM,
+  ASYNC_WEB_POOL_COUNT
+} AsyncWebPoolId;
+
+typedef struct
+{
+  size_t blockSize;
+  size_t count;         // Blocks preallocated
+  size_t available;
+  size_t lowWater;      // Lowest available so far
+  uint32_t hits;        // Served from the slab
+  uint32_t misses;      // Slab empty, served from the heap. Payloads : by the smallest class that fits.
+} AsyncWebSlabStats;
+
+/////////////////////////////////////////////////
+
+class AsyncWebSlab
+{
+  private:
+    // Published by begin() with a release store of _memory, _end and _blockSize are set before.
+    // Lets owns() and blockSize() run on any task without the lock.
+    std::atomic<uint8_t*> _memory;
+    uint8_t* _end;
+    size_t _blockSize;
+    void* _free;                // Free list, linked through the first word of each free block
+    AsyncWebSlabStats _stats;
+    mutable AsyncWebSpinLock _lock;
+
+  public:
+    // constexpr, so that the pool's slabs are set up before any global constructor calls begin()
+    constexpr AsyncWebSlab() : _memory(NULL), _end(NULL), _blockSize(0), _free(NULL), _stats(), _lock() {}
+
+    AsyncWebSlab(AsyncWebSlab const &) = delete;
+    AsyncWebSlab &operator=(AsyncWebSlab const &) = delete;
+
+    // Allocates count blocks of blockSize bytes, once. False if out of memory.
+    bool begin(size_t blockSize, size_t count);
+
+    // NULL if the slab is empty. Counted as a miss unless countMiss is false, for a caller
+    // that tries another slab next and counts the miss itself with countMiss().
+    void* alloc(bool countMiss = true);
+    void countMiss();
+
+    // False if p isn't a block of this slab
+    bool release(void* p);
+
+    AsyncWebSlabStats stats() const;
+
+    /////////////////////////////////////////////////
+
+    inline bool owns(const void* p) const
+    {
+      const uint8_t* memory = _memory.load(std::memory_order_acquire);
+
+      return memory && ((const uint8_t*) p >= memory) && ((const uint8_t*) p < _end);
+    }
+
+    /////////////////////////////////////////////////
+
+    // 0 until begin()
+    inline size_t blockSize() const
+    {
+      return _memory.load(std::memory_order_acquire) ? _blockSize : 0;
+    }
+};
+
+/////////////////////////////////////////////////
+
+class AsyncWebMessagePool
+{
+  private:
+    static AsyncWebSlab _slabs[ASYNC_WEB_POOL_COUNT];
+
+  public:
+    // Preallocates the slabs, once. Called by the AsyncWebSocket and AsyncEventSource constructors.
+    static void begin();
+
+    // Message objects, for the class operator new / delete
+    static void* allocObject(size_t size);
+    static void freeObject(void* p);
+
+    // Payloads, from the smallest size class that fits and has room, else the heap
+    static void* allocPayload(size_t size);
+    static void freePayload(void* p);
+
+    static AsyncWebSlabStats stats(AsyncWebPoolId pool);
+};
+
+/////////////////////////////////////////////////
+
+// Base of the message classes, routes their new / delete through the object slab
+class AsyncWebPooledObject
+{
+  public:
+    static void* operator new(size_t size)
+    {
+      return AsyncWebMessagePool::allocObject(size);
+    }
+
+    /////////////////////////////////////////////////
+
+    static void operator delete(void* p)
+    {
+      AsyncWebMessagePool::freeObject(p);
+    }
+};
+
+#endif /* ASYNCWEBMESSAGEPOOL_H_ */
@@ -0,0 +1,216 @@
+/****************************************************************************************************************************
+  AsyncWebMimeTypes.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebMimeTypes.h"
+
+#include <vector>
+
+/////////////////////////////////////////////////
+
+typedef struct
+{
+  const char* extension;
+  const char* type;
+} AsyncMimeEntry;
+
+// Must stay sorted by extension (lower case, strcmp order) for the binary search
+static const AsyncMimeEntry _builtinMimeTypes[] =
+{
+  { "css",    "text/css"                },
+  { "eot",    "font/eot"                },
+  { "gif",    "image/gif"               },
+  { "gz",     "application/x-gzip"      },
+  { "htm",    "text/html"               },
+  { "html",   "text/html"               },
+  { "ico",    "image/x-icon"            },
+  { "jpeg",   "image/jpeg"              },
+  { "jpg",    "image/jpeg"              },
+  { "js",     "application/javascript"  },
+  { "json",   "application/json"        },
+  { "mjs",    "application/javascript"  },
+  { "pdf",    "application/pdf"         },
+  { "png",    "image/png"               },
+  { "svg",    "image/svg+xml"           },
+  { "ttf",    "font/ttf"                },
+  { "txt",    "text/plain"              },
+  { "wasm",   "application/wasm"        },
+  { "webp",   "image/webp"              },
+  { "woff",   "font/woff"               },
+  { "woff2",  "font/woff2"              },
+  { "xml",    "text/xml"                },
+  { "zip",    "application/zip"         },
+};
+
+#define BUILTIN_MIME_TYPES_COUNT    ( sizeof(_builtinMimeTypes) / sizeof(_builtinMimeTypes[0]) )
+
+/////////////////////////////////////////////////
+
+typedef struct
+{
+  String extension;
+  String type;
+} AsyncUserMimeEntry;
+
+// Few entries expected, searched linearly before the built-in table so they can override it.
+// Entries are never removed, their index follows the built-in ones.
+static std::vector<AsyncUserMimeEntry> _userMimeTypes;
+
+uint16_t AsyncWebMimeTypes::_generation = 0;
+
+/////////////////////////////////////////////////
+
+// Copy the extension in lower case into buf, return its length or 0 if there is none
+static size_t _mimeExtension(const char* path, size_t len, char* buf)
+{
+  size_t i = len;
+
+  while (i > 0 && path[i - 1] != '.')
+  {
+    if (path[i - 1] == '/')
+      return 0;
+
+    i--;
+  }
+
+  size_t extLen = len - i;
+
+  if (i == 0 || extLen == 0 || extLen > ASYNC_MIME_MAX_EXTENSION_LENGTH)
+    return 0;
+
+  for (size_t j = 0; j < extLen; j++)
+    buf[j] = tolower((unsigned char) path[i + j]);
+
+  buf[extLen] = 0;
+
+  return extLen;
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncWebMimeTypes::lookup(const char* path, size_t len, const char* fallback)
+{
+  int16_t found = index(path, len);
+
+  return (found < 0) ? fallback : type(found);
+}
+
+/////////////////////////////////////////////////
+
+int16_t AsyncWebMimeTypes::index(const char* path, size_t len)
+{
+  char ext[ASYNC_MIME_MAX_EXTENSION_LENGTH + 1];
+
+  if (!path || _mimeExtension(path, len, ext) == 0)
+    return -1;
+
+  for (size_t i = 0; i < _userMimeTypes.size(); i++)
+  {
+    if (_userMimeTypes[i].extension.equals(ext))
+      return BUILTIN_MIME_TYPES_COUNT + i;
+  }
+
+  size_t lo = 0;
+  size_t hi = BUILTIN_MIME_TYPES_COUNT;
+
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2;
+    int cmp = strcmp(ext, _builtinMimeTypes[mid].extension);
+
+    if (cmp == 0)
+      return mid;
+
+    if (cmp < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return -1;
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncWebMimeTypes::type(int16_t index)
+{
+  if (index < 0)
+    return NULL;
+
+  if (index < (int16_t) BUILTIN_MIME_TYPES_COUNT)
+    return _builtinMimeTypes[index].type;
+
+  index -= BUILTIN_MIME_TYPES_COUNT;
+
+  return (index < (int16_t) _userMimeTypes.size()) ? _userMimeTypes[index].type.c_str() : NULL;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebMimeTypes::registered(int16_t index)
+{
+  return index >= (int16_t) BUILTIN_MIME_TYPES_COUNT;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebMimeTypes::add(const char* extension, const char* type)
+{
+  if (!extension || !type)
+    return false;
+
+  if (*extension == '.')
+    extension++;
+
+  size_t len = strlen(extension);
+
+  if (len == 0 || len > ASYNC_MIME_MAX_EXTENSION_LENGTH || strchr(extension, '.') || strchr(extension, '/'))
+    return false;
+
+  String ext(extension);
+  ext.toLowerCase();
+
+  for (auto& entry : _userMimeTypes)
+  {
+    if (entry.extension == ext)
+    {
+      entry.type = type;
+      _generation++;
+
+      return true;
+    }
+  }
+
+  _userMimeTypes.push_back({ ext, String(type) });
+  _generation++;
+
+  return true;
+}
@@ -0,0 +1,87 @@
+/****************************************************************************************************************************
+  AsyncWebMimeTypes.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBMIMETYPES_H_
+#define ASYNCWEBMIMETYPES_H_
+
+#include "Arduino.h"
+
+/////////////////////////////////////////////////
+
+/*
+   MIME :: Extension to Content-Type lookup, shared by the file, static and asset responses.
+   Matched case-insensitively on the extension after the last '.' of the last path segment.
+ * */
+
+#define ASYNC_MIME_MAX_EXTENSION_LENGTH     15
+
+class AsyncWebMimeTypes
+{
+  public:
+    // Returns fallback when the extension is unknown. The returned pointer stays valid until add() is called again.
+    static const char* lookup(const char* path, size_t len, const char* fallback = "text/plain");
+
+    /////////////////////////////////////////////////
+
+    static inline const char* lookup(const String& path, const char* fallback = "text/plain")
+    {
+      return lookup(path.c_str(), path.length(), fallback);
+    }
+
+    /////////////////////////////////////////////////
+
+    // Same lookup, as an index into the tables or -1 if the extension is unknown. Unlike the pointers returned
+    // by lookup(), an index stays valid when types are added later.
+    static int16_t index(const char* path, size_t len);
+
+    static const char* type(int16_t index);
+
+    // True for the types registered with add(), which take precedence over the built-in ones
+    static bool registered(int16_t index);
+
+    // Incremented by add(), indexes resolved before may now be overridden
+    static inline uint16_t generation()
+    {
+      return _generation;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Register or override a type, e.g. add("webmanifest", "application/manifest+json").
+    // The leading '.' is optional. Not synchronized : call it before the server begin()
+    static bool add(const char* extension, const char* type);
+
+  private:
+    static uint16_t _generation;
+};
+
+#endif /* ASYNCWEBMIMETYPES_H_ */
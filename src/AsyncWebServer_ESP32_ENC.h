@@ -85,6 +85,10 @@
 #include "FS.h"
 
 #include "StringArray.h"
+#include "AsyncWebArena.h"
+#include "AsyncWebMimeTypes.h"
+#include "AsyncWebDeflate.h"
+#include "AsyncWebHeap.h"
 
 //////////////////////////////////////////////////////////////
 // ESP32_ENC related code
@@ -156,8 +160,13 @@ class AsyncWebParameter;
 class AsyncWebRewrite;
 class AsyncWebHandler;
 class AsyncStaticWebHandler;
+class AsyncAssetWebHandler;
 class AsyncCallbackWebHandler;
 class AsyncResponseStream;
+class AsyncBodySpool;
+class AsyncFrameSource;
+class AsyncCacheCapture;
+class AsyncWebDeferred;
 
 /////////////////////////////////////////////////
 
@@ -180,8 +189,14 @@ typedef enum
 //if this value is returned when asked for data, packet will not be sent and you will be asked for data again
 #define RESPONSE_TRY_AGAIN      0xFFFFFFFF
 
+// Stack buffer of AsyncWebServerRequest::_sendCanned(), longer replies go through a response object
+#ifndef ASYNC_WEB_CANNED_SIZE
+  #define ASYNC_WEB_CANNED_SIZE   256
+#endif
+
 typedef uint8_t WebRequestMethodComposite;
 typedef std::function<void(void)> ArDisconnectHandler;
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
 
 /////////////////////////////////////////////////
 
@@ -248,18 +263,62 @@ class AsyncWebParameter
    HEADER :: Chainable object to hold the headers
  * */
 
+// Headers recognized while parsing, each request keeps a slot per known header for lookups without a search
+typedef enum
+{
+  AWS_HEADER_HOST,
+  AWS_HEADER_CONTENT_TYPE,
+  AWS_HEADER_CONTENT_LENGTH,
+  AWS_HEADER_AUTHORIZATION,
+  AWS_HEADER_COOKIE,
+  AWS_HEADER_IF_NONE_MATCH,
+  AWS_HEADER_IF_MODIFIED_SINCE,
+  AWS_HEADER_ACCEPT,
+  AWS_HEADER_ACCEPT_ENCODING,
+  AWS_HEADER_EXPECT,
+  AWS_HEADER_CONNECTION,
+  AWS_HEADER_UPGRADE,
+  AWS_HEADER_ORIGIN,
+  AWS_HEADER_RANGE,
+  AWS_HEADER_USER_AGENT,
+  AWS_HEADER_LAST_EVENT_ID,
+  AWS_HEADER_SEC_WEBSOCKET_KEY,
+  AWS_HEADER_SEC_WEBSOCKET_VERSION,
+  AWS_HEADER_SEC_WEBSOCKET_PROTOCOL,
+  AWS_HEADER_SEC_WEBSOCKET_EXTENSIONS,
+  AWS_HEADER_KNOWN,                       // Count of the above
+  AWS_HEADER_OTHER = AWS_HEADER_KNOWN
+} AsyncWebHeaderId;
+
+// Case-folded FNV-1a of a header name, for constant expressions only, see AsyncWebHeader::nameHash() at run time
+constexpr uint32_t asyncWebHeaderHash(const char* name, uint32_t hash = 2166136261UL)
+{
+  return *name ? asyncWebHeaderHash(name + 1, (hash ^ (uint8_t) (((*name >= 'A') && (*name <= 'Z')) ? (*name + 32) : *name))
+                                    * 16777619UL) : hash;
+}
+
+/////////////////////////////////////////////////
+
 class AsyncWebHeader
 {
   private:
     String _name;
     String _value;
+    uint32_t _hash;         // nameHash() of the name
+    uint8_t _id;            // AsyncWebHeaderId
 
   public:
-    AsyncWebHeader(const String& name, const String& value): _name(name), _value(value) {}
+    AsyncWebHeader(const String& name, const String& value)
+      : _name(name), _value(value), _hash(nameHash(name.c_str())), _id(knownId(name.c_str(), _hash)) {}
+
+    /////////////////////////////////////////////////
+
+    AsyncWebHeader(const String& name, const String& value, uint32_t hash, uint8_t id)
+      : _name(name), _value(value), _hash(hash), _id(id) {}
 
     /////////////////////////////////////////////////
 
-    AsyncWebHeader(const String& data): _name(), _value()
+    AsyncWebHeader(const String& data): _name(), _value(), _hash(asyncWebHeaderHash("")), _id(AWS_HEADER_OTHER)
     {
       if (!data)
         return;
@@ -271,6 +330,8 @@ class AsyncWebHeader
 
       _name = data.substring(0, index);
       _value = data.substring(index + 2);
+      _hash = nameHash(_name.c_str());
+      _id = knownId(_name.c_str(), _hash);
     }
 
     /////////////////////////////////////////////////
@@ -300,6 +361,25 @@ class AsyncWebHeader
 
     /////////////////////////////////////////////////
 
+    inline uint32_t hash() const
+    {
+      return _hash;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint8_t id() const
+    {
+      return _id;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Same value as asyncWebHeaderHash(name)
+    static uint32_t nameHash(const char* name);
+
+    // AsyncWebHeaderId of a name, hash being nameHash(name). AWS_HEADER_OTHER if it isn't a known header.
+    static uint8_t knownId(const char* name, uint32_t hash);
 };
 
 /////////////////////////////////////////////////
@@ -318,6 +398,22 @@ typedef enum
   RCT_MAX
 } RequestedConnectionType;
 
+// Offsets of one name=value pair in the raw query string or Cookie header of a request
+typedef struct
+{
+  uint16_t name;
+  uint16_t nameLength;
+  uint16_t value;
+  uint16_t valueLength;
+} AsyncWebPairRange;
+
+// Extra header of a canned response, see AsyncWebServerRequest::_sendCanned()
+typedef struct
+{
+  const char* name;
+  const char* value;
+} AsyncCannedHeader;
+
 typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
 typedef std::function<String(const String&)> AwsTemplateProcessor;
 
@@ -329,6 +425,7 @@ class AsyncWebServerRequest
     using FS = fs::FS;
     friend class AsyncWebServer;
     friend class AsyncCallbackWebHandler;
+    friend class AsyncWebWorker;
 
   private:
     AsyncClient* _client;
@@ -350,16 +447,29 @@ class AsyncWebServerRequest
     String _authorization;
     RequestedConnectionType _reqconntype;
     void _removeNotInterestingHeaders();
+    bool _isInterestingHeader(const String& name);
+    void _indexHeaders();
+    AsyncWebHeader* _findHeader(const char* name) const;
     bool _isDigest;
     bool _isMultipart;
     bool _isPlainPost;
     bool _expectingContinue;
+    bool _expectationFailed;      // Expect header with anything but 100-continue
+    uint8_t _acceptEncoding;      // ASYNC_ENCODING_* flags from Accept-Encoding
     size_t _contentLength;
     size_t _parsedLength;
 
-    LinkedList<AsyncWebHeader *> _headers;
-    LinkedList<AsyncWebParameter *> _params;
-    LinkedList<String *> _pathParams;
+    AsyncWebArena _arena;         // Holds the headers and parameters below, see tempAlloc()
+    SmallVector<AsyncWebHeader *, 8> _headers;
+    AsyncWebHeader* _knownHeaders[AWS_HEADER_KNOWN];    // First of each known header in _headers, by AsyncWebHeaderId
+    SmallVector<AsyncWebParameter *, 4> _params;
+    String _query;                    // Raw query string, split into _params when they are first read
+    bool _queryParsed;
+    int16_t _queryCount;              // Pairs in _queryIndex, -1 until the first queryArg()
+    AsyncWebPairRange* _queryIndex;   // In the arena, like _cookieIndex
+    int16_t _cookieCount;             // Pairs in _cookieIndex, -1 until the first cookie()
+    AsyncWebPairRange* _cookieIndex;
+    SmallVector<String *, 2> _pathParams;
 
     uint8_t _multiParseState;
     uint8_t _boundaryPosition;
@@ -372,6 +482,16 @@ class AsyncWebServerRequest
     uint8_t *_itemBuffer;
     size_t _itemBufferIndex;
     bool _itemIsFile;
+    AsyncBodySpool* _bodySpool;
+    AsyncCacheCapture* _capture;  // Handed to the response sent during a cached route's callback
+    bool _pooled;                 // Owned by the server's request pool, recycled instead of deleted
+    AsyncWebDeferred* _deferred;  // Handed to a worker by defer(), until its response is sent
+    bool _earlyRouting;           // Rewrites applied and routing tried at the request line
+    bool _answered;               // A response or canned reply went out, later sends are refused
+    bool _headAsGet;              // Routing pass where HEAD may go to HTTP_GET routes
+
+    void _bind(AsyncClient* c);
+    void _recycle();
 
     void _onPoll();
     void _onAck(size_t len, uint32_t time);
@@ -380,15 +500,21 @@ class AsyncWebServerRequest
     void _onDisconnect();
     void _onData(void *buf, size_t len);
 
-    void _addParam(AsyncWebParameter*);
+    void _addParam(const String& name, const String& value, bool form = false, bool file = false, size_t size = 0);
     void _addPathParam(const char *param);
 
     bool _parseReqHead();
     bool _parseReqHeader();
     void _parseLine();
+    bool _rejectBody();
     void _parsePlainPostChar(uint8_t data);
     void _parseMultipartPostByte(uint8_t data, bool last);
     void _addGetParams(const String& params);
+    void _addQueryParams(const String& params);
+    void _parseQuery() const;
+    AsyncWebPairRange* _indexPairs(const String& text, bool cookies, int16_t& count);
+    const AsyncWebPairRange* _findQueryArg(const char* name);
+    const AsyncWebPairRange* _findCookie(const char* name);
 
     void _handleUploadStart();
     void _handleUploadByte(uint8_t data, bool last);
@@ -401,6 +527,13 @@ class AsyncWebServerRequest
     AsyncWebServerRequest(AsyncWebServer*, AsyncClient*);
     ~AsyncWebServerRequest();
 
+    // The connection is gone or was taken over (WebSocket, EventSource), gives the request back to the server
+    void _release();
+
+    // Zeroed scratch memory that lives as long as the request, e.g. for _tempObject. Never free() it.
+    // NULL if out of memory.
+    void* tempAlloc(size_t size);
+
     /////////////////////////////////////////////////
 
     inline AsyncClient* client()
@@ -417,6 +550,14 @@ class AsyncWebServerRequest
 
     /////////////////////////////////////////////////
 
+    // ASYNC_ENCODING_* flags for the codings the client accepts
+    inline uint8_t acceptEncoding() const
+    {
+      return _acceptEncoding;
+    }
+
+    /////////////////////////////////////////////////
+
     inline WebRequestMethodComposite method() const
     {
       return _method;
@@ -452,6 +593,11 @@ class AsyncWebServerRequest
 
     /////////////////////////////////////////////////
 
+    // The complete body when it was spooled, see AsyncWebServer::setBodySpool(), else NULL
+    Stream* body();
+
+    /////////////////////////////////////////////////
+
     inline bool multipart() const
     {
       return _isMultipart;
@@ -493,10 +639,20 @@ class AsyncWebServerRequest
 
     void addInterestingHeader(const String& name);
 
+    // Runs fn on a worker task instead of the async_tcp task, see AsyncWebWorker. fn answers with
+    // send() as usual, but must not use client(). False if no worker can take it, nothing was sent.
+    bool defer(ArRequestHandlerFunction fn);
+
     void redirect(const String& url);
 
     void send(AsyncWebServerResponse *response);
     void send(int code, const String& contentType = String(), const String& content = String());
+    void send(int code, const String& contentType, String&& content);      // content is moved, not copied
+
+    // Body-less response serialized on the stack and written in one add(), without any response object.
+    // Returns false, sending nothing, if the code is unknown, the reply is longer than
+    // ASYNC_WEB_CANNED_SIZE or the TX buffer is too small.
+    bool _sendCanned(int code, const AsyncCannedHeader* extra = NULL, size_t count = 0);
 
     void send(int code, const String& contentType, const char *content, bool nonDetructiveSend = true);    // RSMOD
 
@@ -518,6 +674,7 @@ class AsyncWebServerRequest
     AsyncWebServerResponse *beginResponse(int code, const String& contentType = String(), const String& content = String());
 
     AsyncWebServerResponse *beginResponse(int code, const String& contentType, const char * content = nullptr); // RSMOD
+    AsyncWebServerResponse *beginResponse(int code, const String& contentType, String&& content);
 
     // KH add
     AsyncWebServerResponse *beginResponse(int code, const String& contentType, const uint8_t * content, size_t len,
@@ -539,6 +696,10 @@ class AsyncWebServerRequest
     AsyncWebServerResponse *beginChunkedResponse(const String& contentType, AwsResponseFiller callback,
                                                  AwsTemplateProcessor templateCallback = nullptr);
     AsyncResponseStream *beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+    // Can be sent before it is complete, call end() on it after the last write
+    AsyncResponseStream *beginChunkedResponseStream(const String& contentType);
+    // multipart/x-mixed-replace stream of the frames published to source, e.g. MJPEG
+    AsyncWebServerResponse *beginMultipartStreamResponse(AsyncFrameSource *source, const String& partType = "image/jpeg");
 
     AsyncWebServerResponse *beginResponse_P(int code, const String& contentType, const uint8_t * content, size_t len,
                                             AwsTemplateProcessor callback = nullptr);
@@ -547,10 +708,13 @@ class AsyncWebServerRequest
 
     size_t headers() const;                     // get header count
     bool hasHeader(const String& name) const;   // check if header exists
+    bool hasHeader(const char* name) const;     // check if header exists
     bool hasHeader(const __FlashStringHelper * data) const;   // check if header exists
 
     AsyncWebHeader* getHeader(const String& name) const;
+    AsyncWebHeader* getHeader(const char* name) const;
     AsyncWebHeader* getHeader(const __FlashStringHelper * data) const;
+    AsyncWebHeader* getHeader(AsyncWebHeaderId id) const;   // known header, without comparing names
     AsyncWebHeader* getHeader(size_t num) const;
 
     size_t params() const;                      // get arguments count
@@ -577,6 +741,19 @@ class AsyncWebServerRequest
     bool hasArg(const char* name) const;         // check if argument exists
     bool hasArg(const __FlashStringHelper * data) const;         // check if F(argument) exists
 
+    // Query string arguments, indexed over the raw query string on first use and decoded only when read,
+    // without Strings. Copies the value into buf like snprintf(), returns its full length, -1 if missing.
+    size_t queryArgs();
+    bool hasQueryArg(const char* name);
+    int queryArg(const char* name, char* buf, size_t size);
+    const char* queryArg(const char* name);     // decoded into the request arena, NULL if missing
+
+    // Cookies of the Cookie header, same as above. A handler routed early must addInterestingHeader("Cookie").
+    size_t cookies();
+    bool hasCookie(const char* name);
+    int cookie(const char* name, char* buf, size_t size);
+    const char* cookie(const char* name);       // copied into the request arena, NULL if missing
+
     const String& ASYNCWEBSERVER_REGEX_ATTRIBUTE pathArg(size_t i) const;
 
     const String& header(const char* name) const;// get request header value by name
@@ -687,9 +864,10 @@ class AsyncWebHandler
     ArRequestFilterFunction _filter;
     String _username;
     String _password;
+    size_t _maxContentLength;     // 0 = no limit
 
   public:
-    AsyncWebHandler(): _username(""), _password("") {}
+    AsyncWebHandler(): _username(""), _password(""), _maxContentLength(0) {}
 
     /////////////////////////////////////////////////
 
@@ -710,6 +888,22 @@ class AsyncWebHandler
 
     /////////////////////////////////////////////////
 
+    // Larger bodies are answered with 413 before any of them is read, 0 = no limit
+    inline AsyncWebHandler& setMaxContentLength(size_t maxContentLength)
+    {
+      _maxContentLength = maxContentLength;
+      return *this;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline size_t maxContentLength() const
+    {
+      return _maxContentLength;
+    }
+
+    /////////////////////////////////////////////////
+
     inline bool filter(AsyncWebServerRequest *request)
     {
       return _filter == NULL || _filter(request);
@@ -736,12 +930,40 @@ class AsyncWebHandler
     virtual void handleBody(AsyncWebServerRequest *request __attribute__((unused)), uint8_t *data __attribute__((unused)),
                             size_t len __attribute__((unused)), size_t index __attribute__((unused)), size_t total __attribute__((unused))) {}
 
+    // Called on the async_tcp task while a request this handler took has no response yet, when its connection
+    // is polled, about every 500ms, or woken with AsyncWebWake
+    virtual void handlePoll(AsyncWebServerRequest *request __attribute__((unused))) {}
+
     /////////////////////////////////////////////////
 
     virtual bool isRequestHandlerTrivial()
     {
       return true;
     }
+
+    /////////////////////////////////////////////////
+
+    // Called at the end of the headers of a request with a body, before 100-continue is sent
+    // and before any of the body is read. 0 to accept the body, else the status to answer with.
+    virtual int checkBody(AsyncWebServerRequest *request);
+
+    /////////////////////////////////////////////////
+
+    // True for handlers which read large bodies from request->body() once complete, instead of taking
+    // them in handleBody() as they arrive, see AsyncWebServer::setBodySpool()
+    virtual bool canSpoolBody()
+    {
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+
+    // True if canHandle() needs the request headers to decide on this request, which only has its request line yet.
+    // Routing then waits for the end of the headers and all of them are kept, see AsyncWebServer::setEarlyRouting().
+    virtual bool routesOnHeaders(AsyncWebServerRequest *request __attribute__((unused)))
+    {
+      return false;
+    }
 };
 
 /////////////////////////////////////////////////
@@ -776,22 +998,46 @@ class AsyncWebServerResponse
     size_t _ackedLength;
     size_t _writtenLength;
     WebResponseState _state;
+    bool _compress;
+    AsyncCacheCapture* _capture;    // Copies the body for the response cache, see AsyncCallbackWebHandler::setCache()
     const char* _responseCodeToString(int code);
 
+    // Exact-size head serialization : _prepareHead() computes _headLength, _writeHead() fills a caller buffer
+    size_t _prepareHead(uint8_t version);
+    void _writeHead(char* dst, uint8_t version);
+
+    template<typename Sink>
+    void _serializeHead(uint8_t version, Sink sink);
+
   public:
     AsyncWebServerResponse();
     virtual ~AsyncWebServerResponse();
+    // "nnn Reason\r\n" in flash for the known codes, NULL otherwise
+    static const char* _statusLine(int code, size_t& len);
+
     virtual void setCode(int code);
     virtual void setContentLength(size_t len);
     virtual void setContentType(const String& type);
     virtual void addHeader(const String& name, const String& value);
+
+    // Opt-in gzip/deflate of the body when the client accepts it. Honoured by the responses that are
+    // filled through AsyncAbstractResponse (chunked, callback, stream, file, progmem and JSON).
+    inline void setCompress(bool compress)
+    {
+      _compress = compress;
+    }
+
     virtual String _assembleHead(uint8_t version);
     virtual bool _started() const;
     virtual bool _finished() const;
     virtual bool _failed() const;
     virtual bool _sourceValid() const;
+    virtual bool _templated() const;  // Expands placeholders, turned down below the low heap mark
     virtual void _respond(AsyncWebServerRequest *request);
     virtual size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
+
+    // Takes ownership, dropped at once unless this is a 200 response
+    void _setCapture(AsyncCacheCapture* capture);
 };
 
 /////////////////////////////////////////////////
@@ -800,7 +1046,6 @@ class AsyncWebServerResponse
    SERVER :: One instance
  * */
 
-typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
 typedef std::function<void(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final)>
 ArUploadHandlerFunction;
 typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)>
@@ -808,6 +1053,18 @@ ArBodyHandlerFunction;
 
 /////////////////////////////////////////////////
 
+typedef struct
+{
+  size_t size;          // Requests allocated by begin()
+  size_t available;     // Free right now
+  size_t lowWater;      // Fewest free since begin()
+  uint32_t reused;      // Connections served from the pool
+  uint32_t overflow;    // Allocated on the heap because the pool was empty
+  uint32_t refused;     // Answered with 503 because the pool was empty
+} AsyncRequestPoolStats;
+
+/////////////////////////////////////////////////
+
 class AsyncWebServer
 {
   protected:
@@ -816,6 +1073,18 @@ class AsyncWebServer
     LinkedList<AsyncWebHandler*> _handlers;
     AsyncCallbackWebHandler* _catchAllHandler;
 
+    size_t _spoolThreshold;       // 0 = bodies are never spooled
+    fs::FS* _spoolFs;
+    String _spoolDir;
+
+    AsyncWebServerRequest** _requestPool;   // Free requests, the first _poolFree entries
+    size_t _poolSize;
+    size_t _poolFree;
+    bool _poolOverflow;
+    AsyncRequestPoolStats _poolStats;
+
+    bool _earlyRouting;
+
   public:
     AsyncWebServer(uint16_t port);
     ~AsyncWebServer();
@@ -842,8 +1111,18 @@ class AsyncWebServer
     AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
                                 ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody);
 
+    // Like on(), but onRequest runs on a worker task. Answered with 503 when all workers are busy.
+    AsyncCallbackWebHandler& onAsync(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest);
+
     AsyncStaticWebHandler& serveStatic(const char* uri, fs::FS& fs, const char* path, const char* cache_control = NULL);
 
+    // Serve a packed image built by utils/build_asset_image.py from the data partition with the given label
+    AsyncAssetWebHandler& serveAssets(const char* uri, const char* label, const char* cache_control = NULL);
+
+    // Register a Content-Type for file, static and asset responses, e.g. addMimeType("csv", "text/csv").
+    // Takes precedence over the built-in table and over the types recorded in asset images.
+    bool addMimeType(const char* extension, const char* type);
+
     void onNotFound(ArRequestHandlerFunction fn);  //called when handler is not assigned
     void onFileUpload(ArUploadHandlerFunction fn); //handle file uploads
     void onRequestBody(ArBodyHandlerFunction
@@ -851,9 +1130,53 @@ class AsyncWebServer
 
     void reset(); //remove all writers and handlers, with onNotFound/onFileUpload/onRequestBody
 
+    // Raw bodies larger than threshold are stored in PSRAM, else in a temporary file in dir on fs,
+    // instead of being passed to handleBody(). The handler reads them from request->body().
+    void setBodySpool(size_t threshold, fs::FS* fs = NULL, const char* dir = "/tmp");
+
+    AsyncBodySpool* _spoolBody(size_t length);
+
+    /////////////////////////////////////////////////
+
+    inline bool _spoolsBody(size_t length) const
+    {
+      return _spoolThreshold && (length > _spoolThreshold);
+    }
+
+    /////////////////////////////////////////////////
+
+    // Call before begin(), which allocates size requests up front. They are reused by every connection
+    // instead of being allocated and freed each time. When all are in use, a new connection gets a
+    // heap-allocated request if overflow is set, else it is answered with 503 and closed.
+    void setRequestPool(size_t size, bool overflow = false);
+    AsyncRequestPoolStats requestPoolStats() const;
+
+    // Free internal heap marks, in bytes, 0 to turn a mode off. Below low, responses are sent without compression
+    // and from smaller buffers and template responses are answered with 503. Below critical, new connections are
+    // answered with 503 and Retry-After: ASYNC_WEB_HEAP_RETRY_AFTER without allocating a request. See AsyncWebHeap.
+    void setHeapWatermarks(size_t low, size_t critical);
+    AsyncHeapStatus heapStatus() const;
+
+    // Pick the handler from the request line, so that the headers it isn't interested in are skipped as they arrive
+    // instead of being stored and removed at their end. Off by default : only turn it on when no rewrite, handler
+    // filter or canHandle() reads request headers, host() or the content type, as they aren't parsed yet then.
+    void setEarlyRouting(bool enable);
+
+    AsyncWebServerRequest* _acquireRequest(AsyncClient* c);
+    void _releaseRequest(AsyncWebServerRequest *request);
+
     void _handleDisconnect(AsyncWebServerRequest *request);
     void _attachHandler(AsyncWebServerRequest *request);
     void _rewriteRequest(AsyncWebServerRequest *request);
+    bool _routeEarly(AsyncWebServerRequest *request);
+
+    /////////////////////////////////////////////////
+
+    // Routing passes : HEAD tries the HTTP_GET routes only after every route had a chance to take it as HEAD
+    inline uint8_t _routingPasses(AsyncWebServerRequest *request) const
+    {
+      return (request->method() == HTTP_HEAD) ? 2 : 1;
+    }
 };
 
 /////////////////////////////////////////////////
@@ -863,6 +1186,9 @@ class DefaultHeaders
     using headers_t = LinkedList<AsyncWebHeader *>;
     headers_t _headers;
 
+    // "Name: value\r\n" for every header, kept up to date by addHeader() and copied as is into each response head
+    String _serialized;
+
     /////////////////////////////////////////////////
 
     DefaultHeaders()
@@ -882,6 +1208,19 @@ class DefaultHeaders
     void addHeader(const String& name, const String& value)
     {
       _headers.add(new AsyncWebHeader(name, value));
+
+      _serialized.reserve(_serialized.length() + name.length() + value.length() + 4);
+      _serialized.concat(name);
+      _serialized.concat(": ");
+      _serialized.concat(value);
+      _serialized.concat("\r\n");
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const String& serialized() const
+    {
+      return _serialized;
     }
 
     /////////////////////////////////////////////////
@@ -32,6 +32,7 @@
 
 #include "Arduino.h"
 #include "AsyncWebSocket.h"
+#include "AsyncWebWake.h"
 
 #include <libb64/cencode.h>
 
@@ -295,7 +296,7 @@ bool AsyncWebSocketMessageBuffer::reserve(size_t size)
    Control Frame
 */
 
-class AsyncWebSocketControl
+class AsyncWebSocketControl : public AsyncWebPooledObject
 {
   private:
     uint8_t _opcode;
@@ -319,7 +320,7 @@ class AsyncWebSocketControl
         if (_len > 125)
           _len = 125;
 
-        _data = (uint8_t*)malloc(_len);
+        _data = (uint8_t*) AsyncWebMessagePool::allocPayload(_len);
 
         if (_data == NULL)
           _len = 0;
@@ -332,8 +333,7 @@ class AsyncWebSocketControl
 
     virtual ~AsyncWebSocketControl()
     {
-      if (_data != NULL)
-        free(_data);
+      AsyncWebMessagePool::freePayload(_data);
     }
 
     virtual bool finished() const
@@ -359,6 +359,11 @@ class AsyncWebSocketControl
     }
 };
 
+// A message class larger than a block silently goes back to the heap
+static_assert(sizeof(AsyncWebSocketControl) <= ASYNC_WEB_MSG_POOL_OBJECT_SIZE, "AsyncWebSocketControl must fit ASYNC_WEB_MSG_POOL_OBJECT_SIZE");
+static_assert(sizeof(AsyncWebSocketBasicMessage) <= ASYNC_WEB_MSG_POOL_OBJECT_SIZE, "AsyncWebSocketBasicMessage must fit ASYNC_WEB_MSG_POOL_OBJECT_SIZE");
+static_assert(sizeof(AsyncWebSocketMultiMessage) <= ASYNC_WEB_MSG_POOL_OBJECT_SIZE, "AsyncWebSocketMultiMessage must fit ASYNC_WEB_MSG_POOL_OBJECT_SIZE");
+
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 
@@ -375,7 +380,7 @@ AsyncWebSocketBasicMessage::AsyncWebSocketBasicMessage(const char * data, size_t
 {
   _opcode = opcode & 0x07;
   _mask = mask;
-  _data = (uint8_t*)malloc(_len + 1);
+  _data = (uint8_t*) AsyncWebMessagePool::allocPayload(_len + 1);
 
   if (_data == NULL)
   {
@@ -408,8 +413,7 @@ AsyncWebSocketBasicMessage::AsyncWebSocketBasicMessage(uint8_t opcode, bool mask
 
 AsyncWebSocketBasicMessage::~AsyncWebSocketBasicMessage()
 {
-  if (_data != NULL)
-    free(_data);
+  AsyncWebMessagePool::freePayload(_data);
 }
 
 /////////////////////////////////////////////////
@@ -635,10 +639,10 @@ AsyncWebSocketClient::AsyncWebSocketClient(AsyncWebServerRequest *request, Async
 {
   delete  c;
 }))
-, _messageQueue(LinkedList<AsyncWebSocketMessage *>([](AsyncWebSocketMessage *m)
+, _messageQueue([](AsyncWebSocketMessage *m)
 {
   delete  m;
-}))
+})
 , _tempObject(NULL)
 {
   _client = request->client();
@@ -688,7 +692,7 @@ AsyncWebSocketClient::AsyncWebSocketClient(AsyncWebServerRequest *request, Async
 
   _server->_addClient(this);
   _server->_handleEvent(this, WS_EVT_CONNECT, request, NULL, 0);
-  delete request;
+  request->_release();
 }
 
 /////////////////////////////////////////////////
@@ -733,12 +737,17 @@ void AsyncWebSocketClient::_onAck(size_t len, uint32_t time)
 
   _server->_cleanBuffers();
   _runQueue();
+
+  // Sends from other tasks, for every client of the server
+  _server->_drainSubmitted();
 }
 
 /////////////////////////////////////////////////
 
 void AsyncWebSocketClient::_onPoll()
 {
+  _server->_drainSubmitted();
+
   if (_client->canSend() && (!_controlQueue.isEmpty() || !_messageQueue.isEmpty()))
   {
     _runQueue();
@@ -1235,23 +1244,133 @@ uint16_t AsyncWebSocketClient::remotePort()
 
 AsyncWebSocket::AsyncWebSocket(const String& url)
   : _url(url)
-  , _clients(LinkedList<AsyncWebSocketClient * >([](AsyncWebSocketClient * c)
+  , _clients([](AsyncWebSocketClient * c)
 {
   delete c;
-}))
+})
 , _cNextId(1)
 , _enabled(true)
+, _networkTask(NULL)
+, _wakeClient(NULL)
+, _wakePending(false)
 , _buffers(LinkedList<AsyncWebSocketMessageBuffer *>([](AsyncWebSocketMessageBuffer *b)
 {
   delete b;
 }))
 {
   _eventHandler = NULL;
+
+  AsyncWebMessagePool::begin();
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebSocket::~AsyncWebSocket()
+{
+  AsyncWebSocketSubmit submit;
+
+  while (_submitted.pop(submit))
+  {
+    if (submit.owned)
+      delete submit.buffer;
+    else
+      submit.buffer->unlock();
+  }
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebSocket::_submit(const char * message, size_t len, uint32_t id, bool binary)
+{
+  // Not in _buffers, so no lock is taken here
+  AsyncWebSocketMessageBuffer * buffer = new AsyncWebSocketMessageBuffer((uint8_t *)message, len);
+
+  if (buffer)
+    _submit(buffer, id, binary, true);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebSocket::_submit(AsyncWebSocketMessageBuffer * buffer, uint32_t id, bool binary, bool owned)
+{
+  // Keeps _cleanBuffers() away from it while it waits
+  buffer->lock();
+
+  if (_submitted.push({ buffer, id, binary, owned }))
+  {
+    _wakeNetwork();
+
+    return;
+  }
+
+  AWS_LOGWARN("[AsyncWebSocket] Submit queue full, message dropped");
+
+  if (owned)
+    delete buffer;
+  else
+    buffer->unlock();
+}
+
+/////////////////////////////////////////////////
+
+// Other task, after a push : has a client polled now, which drains the ring, rather than on its next
+// ack or lwIP poll up to 500ms later. Once until the next drain.
+void AsyncWebSocket::_wakeNetwork()
+{
+  if (_wakePending.exchange(true, std::memory_order_acq_rel))
+    return;
+
+  // lwIP mailbox full, the next push tries again
+  if (!AsyncWebWake::client(_wakeClient.load(std::memory_order_relaxed)))
+    _wakePending.store(false, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+
+// async_tcp task : queues what other tasks sent to the clients, in the order it was sent
+void AsyncWebSocket::_drainSubmitted()
+{
+  _networkTask.store(xTaskGetCurrentTaskHandle(), std::memory_order_relaxed);
+
+  // Pushes from now on wake the network again
+  _wakePending.store(false, std::memory_order_release);
+
+  if (_submitted.empty())
+    return;
+
+  AsyncWebSocketSubmit submit;
+
+  while (_submitted.pop(submit))
+  {
+    if (submit.owned)
+    {
+      AsyncWebLockGuard l(_lock);
+      _buffers.add(submit.buffer);
+    }
+
+    _sendSubmitted(submit);
+  }
+
+  _cleanBuffers();
 }
 
 /////////////////////////////////////////////////
 
-AsyncWebSocket::~AsyncWebSocket() {}
+void AsyncWebSocket::_sendSubmitted(const AsyncWebSocketSubmit& submit)
+{
+  for (const auto& c : _clients)
+  {
+    if ((c->status() == WS_CONNECTED) && (!submit.id || (c->id() == submit.id)))
+    {
+      if (submit.binary)
+        c->binary(submit.buffer);
+      else
+        c->text(submit.buffer);
+    }
+  }
+
+  submit.buffer->unlock();
+}
 
 void AsyncWebSocket::_handleEvent(AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data,
                                   size_t len)
@@ -1266,7 +1385,11 @@ void AsyncWebSocket::_handleEvent(AsyncWebSocketClient * client, AwsEventType ty
 
 void AsyncWebSocket::_addClient(AsyncWebSocketClient * client)
 {
+  // Sent before this client connected
+  _drainSubmitted();
+
   _clients.add(client);
+  _wakeClient.store(client->client(), std::memory_order_relaxed);
 }
 
 /////////////////////////////////////////////////
@@ -1278,6 +1401,8 @@ void AsyncWebSocket::_handleDisconnect(AsyncWebSocketClient * client)
   {
     return c->id() == client->id();
   });
+
+  _wakeClient.store(_clients.isEmpty() ? NULL : _clients.front()->client(), std::memory_order_relaxed);
 }
 
 /////////////////////////////////////////////////
@@ -1387,6 +1512,11 @@ void AsyncWebSocket::pingAll(uint8_t *data, size_t len)
 
 void AsyncWebSocket::text(uint32_t id, const char * message, size_t len)
 {
+  if (!_onNetworkTask())
+    return _submit(message, len, id, false);
+
+  _drainSubmitted();
+
   AsyncWebSocketClient * c = client(id);
 
   if (c)
@@ -1400,6 +1530,11 @@ void AsyncWebSocket::textAll(AsyncWebSocketMessageBuffer * buffer)
   if (!buffer)
     return;
 
+  if (!_onNetworkTask())
+    return _submit(buffer, 0, false, false);
+
+  _drainSubmitted();
+
   buffer->lock();
 
   for (const auto& c : _clients)
@@ -1418,6 +1553,9 @@ void AsyncWebSocket::textAll(AsyncWebSocketMessageBuffer * buffer)
 
 void AsyncWebSocket::textAll(const char * message, size_t len)
 {
+  if (!_onNetworkTask())
+    return _submit(message, len, 0, false);
+
   AsyncWebSocketMessageBuffer * WSBuffer = makeBuffer((uint8_t *)message, len);
   textAll(WSBuffer);
 }
@@ -1426,6 +1564,11 @@ void AsyncWebSocket::textAll(const char * message, size_t len)
 
 void AsyncWebSocket::binary(uint32_t id, const char * message, size_t len)
 {
+  if (!_onNetworkTask())
+    return _submit(message, len, id, true);
+
+  _drainSubmitted();
+
   AsyncWebSocketClient * c = client(id);
 
   if (c)
@@ -1436,6 +1579,9 @@ void AsyncWebSocket::binary(uint32_t id, const char * message, size_t len)
 
 void AsyncWebSocket::binaryAll(const char * message, size_t len)
 {
+  if (!_onNetworkTask())
+    return _submit(message, len, 0, true);
+
   AsyncWebSocketMessageBuffer * buffer = makeBuffer((uint8_t *)message, len);
   binaryAll(buffer);
 }
@@ -1447,6 +1593,11 @@ void AsyncWebSocket::binaryAll(AsyncWebSocketMessageBuffer * buffer)
   if (!buffer)
     return;
 
+  if (!_onNetworkTask())
+    return _submit(buffer, 0, true, false);
+
+  _drainSubmitted();
+
   buffer->lock();
 
   for (const auto& c : _clients)
@@ -1599,6 +1750,11 @@ void AsyncWebSocket::text(uint32_t id, const String &message)
 
 void AsyncWebSocket::text(uint32_t id, const __FlashStringHelper *message)
 {
+  if (!_onNetworkTask())
+    return text(id, String(message));
+
+  _drainSubmitted();
+
   AsyncWebSocketClient * c = client(id);
 
   if (c != NULL)
@@ -1637,6 +1793,11 @@ void AsyncWebSocket::textAll(const String &message)
 
 void AsyncWebSocket::textAll(const __FlashStringHelper *message)
 {
+  if (!_onNetworkTask())
+    return textAll(String(message));
+
+  _drainSubmitted();
+
   for (const auto& c : _clients)
   {
     if (c->status() == WS_CONNECTED)
@@ -1674,8 +1835,33 @@ void AsyncWebSocket::binary(uint32_t id, const String &message)
 
 /////////////////////////////////////////////////
 
+// Copy of flash data for a send from another task
+static AsyncWebSocketMessageBuffer * flashBuffer(const __FlashStringHelper *message, size_t len)
+{
+  AsyncWebSocketMessageBuffer * buffer = new AsyncWebSocketMessageBuffer(len);
+
+  if (buffer && buffer->get())
+    memcpy_P(buffer->get(), message, len);
+
+  return buffer;
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebSocket::binary(uint32_t id, const __FlashStringHelper *message, size_t len)
 {
+  if (!_onNetworkTask())
+  {
+    AsyncWebSocketMessageBuffer * buffer = flashBuffer(message, len);
+
+    if (buffer)
+      _submit(buffer, id, true, true);
+
+    return;
+  }
+
+  _drainSubmitted();
+
   AsyncWebSocketClient * c = client(id);
 
   if (c != NULL)
@@ -1714,6 +1900,18 @@ void AsyncWebSocket::binaryAll(const String &message)
 
 void AsyncWebSocket::binaryAll(const __FlashStringHelper *message, size_t len)
 {
+  if (!_onNetworkTask())
+  {
+    AsyncWebSocketMessageBuffer * buffer = flashBuffer(message, len);
+
+    if (buffer)
+      _submit(buffer, 0, true, true);
+
+    return;
+  }
+
+  _drainSubmitted();
+
   for (const auto& c : _clients)
   {
     if (c->status() == WS_CONNECTED)
@@ -1754,6 +1952,14 @@ bool AsyncWebSocket::canHandle(AsyncWebServerRequest *request)
 
 /////////////////////////////////////////////////
 
+// Only the Upgrade header tells a handshake from a plain GET of the same url
+bool AsyncWebSocket::routesOnHeaders(AsyncWebServerRequest *request)
+{
+  return _enabled && (request->method() == HTTP_GET) && request->url().equals(_url);
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebSocket::handleRequest(AsyncWebServerRequest *request)
 {
   if (!request->hasHeader(WS_STR_VERSION) || !request->hasHeader(WS_STR_KEY))
@@ -1828,13 +2034,10 @@ void AsyncWebSocket::_cleanBuffers()
 {
   AsyncWebLockGuard l(_lock);
 
-  for (AsyncWebSocketMessageBuffer * c : _buffers)
+  _buffers.remove_if([](AsyncWebSocketMessageBuffer * c)
   {
-    if (c && c->canDelete())
-    {
-      _buffers.remove(c);
-    }
-  }
+    return c && c->canDelete();
+  });
 }
 
 /////////////////////////////////////////////////
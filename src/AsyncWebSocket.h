@@ -47,11 +47,18 @@
 #include "AsyncWebServer_ESP32_ENC.h"
 
 #include "AsyncWebSynchronization.h"
+#include "AsyncMpscRing.h"
+#include "AsyncWebMessagePool.h"
 
 /////////////////////////////////////////////////
 
 #define DEFAULT_MAX_WS_CLIENTS 8
 
+// Sends from other tasks waiting for the async_tcp task, per AsyncWebSocket. Must be a power of 2.
+#ifndef ASYNC_WS_SUBMIT_QUEUE_SIZE
+  #define ASYNC_WS_SUBMIT_QUEUE_SIZE    16
+#endif
+
 /////////////////////////////////////////////////
 
 class AsyncWebSocket;
@@ -213,7 +220,7 @@ class AsyncWebSocketMessageBuffer
 
 /////////////////////////////////////////////////
 
-class AsyncWebSocketMessage
+class AsyncWebSocketMessage : public AsyncWebPooledObject
 {
   protected:
     uint8_t _opcode;
@@ -316,7 +323,7 @@ class AsyncWebSocketClient
     AwsClientStatus _status;
 
     LinkedList<AsyncWebSocketControl *> _controlQueue;
-    LinkedList<AsyncWebSocketMessage *> _messageQueue;
+    SmallVector<AsyncWebSocketMessage *, 4> _messageQueue;
 
     uint8_t _pstate;
     AwsFrameInfo _pinfo;
@@ -450,10 +457,21 @@ AwsEventHandler;
 /////////////////////////////////////////////////
 
 //WebServer Handler implementation that plays the role of a socket server
+// A text or binary send made on another task
+typedef struct
+{
+  AsyncWebSocketMessageBuffer *buffer;    // Locked until it is queued to the clients
+  uint32_t id;                            // 0 = all clients
+  bool binary;
+  bool owned;                             // Made by the submit, not in _buffers yet
+} AsyncWebSocketSubmit;
+
+/////////////////////////////////////////////////
+
 class AsyncWebSocket: public AsyncWebHandler
 {
   public:
-    typedef LinkedList<AsyncWebSocketClient *> AsyncWebSocketClientLinkedList;
+    typedef SmallVector<AsyncWebSocketClient *, 4> AsyncWebSocketClientLinkedList;
 
   private:
     String _url;
@@ -463,6 +481,29 @@ class AsyncWebSocket: public AsyncWebHandler
     bool _enabled;
     AsyncWebLock _lock;
 
+    // The clients belong to the async_tcp task. Other tasks only push to the ring, see _drainSubmitted().
+    AsyncMpscRing<AsyncWebSocketSubmit, ASYNC_WS_SUBMIT_QUEUE_SIZE> _submitted;
+    std::atomic<TaskHandle_t> _networkTask;
+    std::atomic<AsyncClient *> _wakeClient;   // Any client, woken so that it drains the ring, see AsyncWebWake
+    std::atomic<bool> _wakePending;
+
+    /////////////////////////////////////////////////
+
+    inline bool _onNetworkTask() const
+    {
+      return _networkTask.load(std::memory_order_relaxed) == xTaskGetCurrentTaskHandle();
+    }
+
+    /////////////////////////////////////////////////
+
+    void _wakeNetwork();
+
+    /////////////////////////////////////////////////
+
+    void _submit(const char * message, size_t len, uint32_t id, bool binary);
+    void _submit(AsyncWebSocketMessageBuffer * buffer, uint32_t id, bool binary, bool owned);
+    void _sendSubmitted(const AsyncWebSocketSubmit& submit);
+
   public:
     AsyncWebSocket(const String& url);
     ~AsyncWebSocket();
@@ -552,6 +593,14 @@ class AsyncWebSocket: public AsyncWebHandler
 
     /////////////////////////////////////////////////
 
+    // Sends from other tasks refused because too many were waiting for the async_tcp task
+    inline uint32_t submitDropped() const
+    {
+      return _submitted.dropped();
+    }
+
+    /////////////////////////////////////////////////
+
     //event listener
     inline void onEvent(AwsEventHandler handler)
     {
@@ -570,8 +619,10 @@ class AsyncWebSocket: public AsyncWebHandler
 
     void _addClient(AsyncWebSocketClient * client);
     void _handleDisconnect(AsyncWebSocketClient * client);
+    void _drainSubmitted();
     void _handleEvent(AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len);
     virtual bool canHandle(AsyncWebServerRequest *request) override final;
+    virtual bool routesOnHeaders(AsyncWebServerRequest *request) override final;
     virtual void handleRequest(AsyncWebServerRequest *request) override final;
 
     //  messagebuffer functions/objects.
@@ -33,57 +33,306 @@
 #ifndef ASYNCWEBSYNCHRONIZATION_H_
 #define ASYNCWEBSYNCHRONIZATION_H_
 
-// Synchronisation is only available on ESP32, as the ESP8266 isn't using FreeRTOS by default
+// Locks used by the containers shared between the async_tcp task and the user's tasks.
+//
+// AsyncWebLock is a recursive mutex for sections that may run long or allocate. It first tries
+// to take the mutex without blocking, spins for a short while if another core holds it, and only
+// then blocks. The FreeRTOS mutex gives priority inheritance, so a low priority task holding it
+// can't be starved by a busy async_tcp task waiting for it.
+//
+// AsyncWebSpinLock is a portMUX critical section for a handful of instructions : no kernel call,
+// but interrupts are off on this core and the other core spins while it's held.
+//
+// Both are taken with AsyncWebLockGuard. Define ASYNC_WEB_LOCK_PTHREAD to build the pthread
+// version, used to run and benchmark the containers on a host without FreeRTOS.
+
+#if defined(ESP32) && !defined(ASYNC_WEB_LOCK_PTHREAD)
+  #include "AsyncWebServer_ESP32_ENC.h"
+#else
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+#include <atomic>
 
-#include "AsyncWebServer_ESP32_ENC.h"
+/////////////////////////////////////////////////
+
+// Non-blocking attempts before blocking on a contended AsyncWebLock. Spinning only helps
+// when the holder runs on the other core.
+#ifndef ASYNC_WEB_LOCK_SPIN
+  #if defined(ESP32) && !defined(ASYNC_WEB_LOCK_PTHREAD) && (portNUM_PROCESSORS < 2)
+    #define ASYNC_WEB_LOCK_SPIN     0
+  #else
+    #define ASYNC_WEB_LOCK_SPIN     100
+  #endif
+#endif
+
+// Count acquisitions and contention of every AsyncWebLock, see AsyncWebLock::stats()
+#ifndef ASYNC_WEB_LOCK_STATS
+  #define ASYNC_WEB_LOCK_STATS      0
+#endif
 
 /////////////////////////////////////////////////
 
-// This is the ESP32 version of the Sync Lock, using the FreeRTOS Semaphore
-class AsyncWebLock
+typedef struct
+{
+  uint32_t acquired;          // Taken by a task that didn't hold it yet
+  uint32_t contended;         // Held by another task on the first attempt
+  uint32_t blocked;           // Still held after spinning, the task had to block
+} AsyncWebLockStats;
+
+/////////////////////////////////////////////////
+
+#if defined(ESP32) && !defined(ASYNC_WEB_LOCK_PTHREAD)
+
+typedef TaskHandle_t AsyncWebLockOwner;
+
+#define ASYNC_WEB_LOCK_SELF()           xTaskGetCurrentTaskHandle()
+#define ASYNC_WEB_LOCK_RELAX()          do {} while (0)
+
+// ESP32 version, a FreeRTOS mutex (priority inheritance) with the owner tracked outside of it
+class AsyncWebLockMutex
 {
   private:
-    SemaphoreHandle_t _lock;
-    mutable void *_lockedBy;
+    SemaphoreHandle_t _mutex;
 
   public:
-    AsyncWebLock()
+    AsyncWebLockMutex() : _mutex(xSemaphoreCreateMutex()) {}
+
+    ~AsyncWebLockMutex()
+    {
+      vSemaphoreDelete(_mutex);
+    }
+
+    inline bool tryTake()
+    {
+      return xSemaphoreTake(_mutex, 0) == pdTRUE;
+    }
+
+    inline void take()
+    {
+      xSemaphoreTake(_mutex, portMAX_DELAY);
+    }
+
+    inline void give()
     {
-      _lock = xSemaphoreCreateBinary();
-      _lockedBy = NULL;
-      xSemaphoreGive(_lock);
+      xSemaphoreGive(_mutex);
+    }
+};
+
+/////////////////////////////////////////////////
+
+class AsyncWebSpinLock
+{
+  private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  public:
+    // Always true, nesting on the same core is allowed
+    inline bool lock() const
+    {
+      portENTER_CRITICAL(&_mux);
+
+      return true;
     }
 
     /////////////////////////////////////////////////
 
-    ~AsyncWebLock()
+    inline void unlock() const
+    {
+      portEXIT_CRITICAL(&_mux);
+    }
+};
+
+#else
+
+typedef pthread_t AsyncWebLockOwner;
+
+#define ASYNC_WEB_LOCK_SELF()           pthread_self()
+#define ASYNC_WEB_LOCK_RELAX()          sched_yield()
+
+// Host version, a pthread mutex with priority inheritance where the platform has it
+class AsyncWebLockMutex
+{
+  private:
+    pthread_mutex_t _mutex;
+
+  public:
+    AsyncWebLockMutex()
+    {
+      pthread_mutexattr_t attr;
+
+      pthread_mutexattr_init(&attr);
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && (_POSIX_THREAD_PRIO_INHERIT > 0)
+      pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+#endif
+      pthread_mutex_init(&_mutex, &attr);
+      pthread_mutexattr_destroy(&attr);
+    }
+
+    ~AsyncWebLockMutex()
     {
-      vSemaphoreDelete(_lock);
+      pthread_mutex_destroy(&_mutex);
     }
 
+    inline bool tryTake()
+    {
+      return pthread_mutex_trylock(&_mutex) == 0;
+    }
+
+    inline void take()
+    {
+      pthread_mutex_lock(&_mutex);
+    }
+
+    inline void give()
+    {
+      pthread_mutex_unlock(&_mutex);
+    }
+};
+
+/////////////////////////////////////////////////
+
+// Same nesting rule as portMUX : the holder may take it again
+class AsyncWebSpinLock
+{
+  private:
+    mutable std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+    mutable std::atomic<pthread_t> _owner { pthread_t() };
+    mutable uint32_t _depth = 0;
+
+  public:
+    inline bool lock() const
+    {
+      const pthread_t self = pthread_self();
+
+      if (pthread_equal(_owner.load(std::memory_order_relaxed), self))
+      {
+        _depth++;
+
+        return true;
+      }
+
+      while (_flag.test_and_set(std::memory_order_acquire))
+        sched_yield();
+
+      _owner.store(self, std::memory_order_relaxed);
+      _depth = 1;
+
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline void unlock() const
+    {
+      if (--_depth == 0)
+      {
+        _owner.store(pthread_t(), std::memory_order_relaxed);
+        _flag.clear(std::memory_order_release);
+      }
+    }
+};
+
+#endif
+
+/////////////////////////////////////////////////
+
+class AsyncWebLock
+{
+  private:
+    mutable AsyncWebLockMutex _mutex;
+    // Only ever equal to the calling task's handle if that task holds the lock
+    mutable std::atomic<AsyncWebLockOwner> _owner { AsyncWebLockOwner() };
+    mutable std::atomic<bool> _held { false };
+
+#if ASYNC_WEB_LOCK_STATS
+    mutable std::atomic<uint32_t> _acquired { 0 };
+    mutable std::atomic<uint32_t> _contended { 0 };
+    mutable std::atomic<uint32_t> _blocked { 0 };
+#endif
+
+  public:
+    AsyncWebLock() {}
+
+    AsyncWebLock(AsyncWebLock const &) = delete;
+    AsyncWebLock &operator=(AsyncWebLock const &) = delete;
+
     /////////////////////////////////////////////////
 
+    // True if this call took the lock, false if the calling task already holds it.
+    // Only a call that returned true is matched by unlock().
     bool lock() const
     {
-      extern void *pxCurrentTCB;
+      const AsyncWebLockOwner self = ASYNC_WEB_LOCK_SELF();
+
+      if (_held.load(std::memory_order_relaxed) && (_owner.load(std::memory_order_relaxed) == self))
+        return false;
 
-      if (_lockedBy != pxCurrentTCB)
+      if (!_mutex.tryTake())
       {
-        xSemaphoreTake(_lock, portMAX_DELAY);
-        _lockedBy = pxCurrentTCB;
+        bool taken = false;
 
-        return true;
+#if ASYNC_WEB_LOCK_STATS
+        _contended.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+#if (ASYNC_WEB_LOCK_SPIN > 0)
+
+        for (uint32_t i = 0; (i < ASYNC_WEB_LOCK_SPIN) && !taken; i++)
+        {
+          ASYNC_WEB_LOCK_RELAX();
+
+          // Don't hammer the mutex while the holder is still busy
+          if (!_held.load(std::memory_order_relaxed))
+            taken = _mutex.tryTake();
+        }
+
+#endif
+
+        if (!taken)
+        {
+#if ASYNC_WEB_LOCK_STATS
+          _blocked.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+          _mutex.take();
+        }
       }
 
-      return false;
+      _owner.store(self, std::memory_order_relaxed);
+      _held.store(true, std::memory_order_relaxed);
+
+#if ASYNC_WEB_LOCK_STATS
+      _acquired.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+      return true;
     }
 
     /////////////////////////////////////////////////
 
     void unlock() const
     {
-      _lockedBy = NULL;
-      xSemaphoreGive(_lock);
+      _held.store(false, std::memory_order_relaxed);
+      _owner.store(AsyncWebLockOwner(), std::memory_order_relaxed);
+      _mutex.give();
+    }
+
+    /////////////////////////////////////////////////
+
+    // All zero unless built with ASYNC_WEB_LOCK_STATS
+    AsyncWebLockStats stats() const
+    {
+      AsyncWebLockStats s = { 0, 0, 0 };
+
+#if ASYNC_WEB_LOCK_STATS
+      s.acquired  = _acquired.load(std::memory_order_relaxed);
+      s.contended = _contended.load(std::memory_order_relaxed);
+      s.blocked   = _blocked.load(std::memory_order_relaxed);
+#endif
+
+      return s;
     }
 };
 
@@ -93,9 +342,10 @@ class AsyncWebLockGuard
 {
   private:
     const AsyncWebLock *_lock;
+    const AsyncWebSpinLock *_spin;
 
   public:
-    AsyncWebLockGuard(const AsyncWebLock &l)
+    AsyncWebLockGuard(const AsyncWebLock &l) : _spin(NULL)
     {
       if (l.lock())
       {
@@ -109,13 +359,28 @@ class AsyncWebLockGuard
 
     /////////////////////////////////////////////////
 
+    AsyncWebLockGuard(const AsyncWebSpinLock &l) : _lock(NULL), _spin(&l)
+    {
+      l.lock();
+    }
+
+    /////////////////////////////////////////////////
+
     ~AsyncWebLockGuard()
     {
       if (_lock)
       {
         _lock->unlock();
       }
+
+      if (_spin)
+      {
+        _spin->unlock();
+      }
     }
+
+    AsyncWebLockGuard(AsyncWebLockGuard const &) = delete;
+    AsyncWebLockGuard &operator=(AsyncWebLockGuard const &) = delete;
 };
 
 /////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+/****************************************************************************************************************************
+  AsyncWebWake.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBWAKE_H_
+#define ASYNCWEBWAKE_H_
+
+// Lets another task get a connection served now rather than at its next lwIP poll, up to 500ms
+// later. Used when data a response answered RESPONSE_TRY_AGAIN for, or a message queued for a
+// client, becomes ready outside of the async_tcp task.
+//
+// The lwIP thread looks the client up among the active connections and calls the poll callback
+// AsyncTCP registered for it, as lwIP's own poll timer does. AsyncTCP then runs the client's
+// onPoll() handler on the async_tcp task. The client is only used as a key and never dereferenced,
+// so it may already be gone.
+
+class AsyncClient;
+
+/////////////////////////////////////////////////
+
+class AsyncWebWake
+{
+  public:
+    // Any task. False if the lwIP mailbox is full, the regular poll then does it.
+    static bool client(AsyncClient *client);
+};
+
+#endif /* ASYNCWEBWAKE_H_ */
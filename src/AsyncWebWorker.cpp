@@ -0,0 +1,289 @@
+/****************************************************************************************************************************
+  AsyncWebWorker.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#include "AsyncWebWorker.h"
+#include "AsyncWebWake.h"
+
+/////////////////////////////////////////////////
+
+// AsyncWebDeferred::_state
+#define DEFERRED_QUEUED     0
+#define DEFERRED_RUNNING    1
+#define DEFERRED_DONE       2
+
+QueueHandle_t AsyncWebWorker::_queue = NULL;
+AsyncMpscRing<AsyncWebDeferred*, ASYNC_WEB_WORKER_QUEUE_SIZE> AsyncWebWorker::_done;
+AsyncWebWorkerStats AsyncWebWorker::_stats = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+// Guards the state of the jobs and the timing stats, never held across a handler
+static portMUX_TYPE _workerMux = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+bool AsyncWebWorker::begin(uint8_t count, UBaseType_t priority, BaseType_t core)
+{
+  // Only called from the async_tcp task or setup(), no need to guard against a concurrent start
+  if (_queue)
+    return true;
+
+  if (!count)
+    return false;
+
+  // Never fills, no more than ASYNC_WEB_WORKER_QUEUE_SIZE jobs exist
+  _queue = xQueueCreate(ASYNC_WEB_WORKER_QUEUE_SIZE, sizeof(AsyncWebDeferred *));
+
+  if (!_queue)
+  {
+    AWS_LOGERROR(F("[AsyncWebWorker] xQueueCreate failed"));
+
+    return false;
+  }
+
+  uint8_t started = 0;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (xTaskCreatePinnedToCore(_worker, "aws_worker", ASYNC_WEB_WORKER_STACK_SIZE, NULL,
+                                priority, NULL, core) != pdPASS)
+    {
+      AWS_LOGERROR(F("[AsyncWebWorker] xTaskCreatePinnedToCore failed"));
+
+      break;
+    }
+
+    started++;
+  }
+
+  if (!started)
+  {
+    vQueueDelete(_queue);
+    _queue = NULL;
+
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebWorkerStats AsyncWebWorker::stats()
+{
+  portENTER_CRITICAL(&_workerMux);
+  AsyncWebWorkerStats s = _stats;
+  portEXIT_CRITICAL(&_workerMux);
+
+  return s;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebWorker::_worker(void *arg)
+{
+  ESP32_ENC_AWS_UNUSED(arg);
+
+  for (;;)
+  {
+    AsyncWebDeferred *job;
+
+    if (xQueueReceive(_queue, &job, portMAX_DELAY) != pdTRUE)
+      continue;
+
+    const uint32_t start = millis();
+
+    portENTER_CRITICAL(&_workerMux);
+
+    // Nothing to do if the client left while the job was queued, the request is already gone
+    const bool run = !job->_orphaned;
+
+    if (run)
+    {
+      job->_state = DEFERRED_RUNNING;
+
+      _stats.lastWait = start - job->_queuedAt;
+
+      if (_stats.lastWait > _stats.maxWait)
+        _stats.maxWait = _stats.lastWait;
+    }
+
+    portEXIT_CRITICAL(&_workerMux);
+
+    if (run)
+      job->_fn(job->_request);
+
+    const uint32_t elapsed = millis() - start;
+
+    portENTER_CRITICAL(&_workerMux);
+
+    job->_state = DEFERRED_DONE;
+
+    if (run)
+    {
+      _stats.lastRun = elapsed;
+
+      if (elapsed > _stats.maxRun)
+        _stats.maxRun = elapsed;
+    }
+
+    portEXIT_CRITICAL(&_workerMux);
+
+    // The job may be gone as soon as it's pushed
+    AsyncClient *client = job->_client;
+
+    // Can't fail, the ring holds as many jobs as may exist
+    _done.push(job);
+
+    // Gets collect() called now rather than on the next poll or ack of any connection
+    AsyncWebWake::client(client);
+  }
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebWorker::_defer(AsyncWebServerRequest* request, ArRequestHandlerFunction fn)
+{
+  // Only the async_tcp task changes pending
+  if ((_stats.pending >= ASYNC_WEB_WORKER_QUEUE_SIZE) || !begin())
+  {
+    AWS_LOGDEBUG("[AsyncWebWorker] No room for a deferred request");
+
+    portENTER_CRITICAL(&_workerMux);
+    _stats.refused++;
+    portEXIT_CRITICAL(&_workerMux);
+
+    return false;
+  }
+
+  AsyncWebDeferred *job = new AsyncWebDeferred(request, fn);
+
+  // Must be in place before a worker can call send()
+  request->_deferred = job;
+
+  if (xQueueSend(_queue, &job, 0) != pdTRUE)
+  {
+    request->_deferred = NULL;
+    delete job;
+
+    portENTER_CRITICAL(&_workerMux);
+    _stats.refused++;
+    portEXIT_CRITICAL(&_workerMux);
+
+    return false;
+  }
+
+  portENTER_CRITICAL(&_workerMux);
+
+  if (++_stats.pending > _stats.highWater)
+    _stats.highWater = _stats.pending;
+
+  portEXIT_CRITICAL(&_workerMux);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebWorker::_keep(AsyncWebDeferred* job, AsyncWebServerResponse* response)
+{
+  // The handler answered more than once, the last response wins
+  if (job->_response)
+    delete job->_response;
+
+  job->_response = response;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebWorker::_orphan(AsyncWebDeferred* job)
+{
+  portENTER_CRITICAL(&_workerMux);
+
+  job->_orphaned = true;
+
+  const bool queued = (job->_state == DEFERRED_QUEUED);
+
+  // A worker that picks it up later won't run it
+  if (queued)
+    job->_request = NULL;
+
+  portEXIT_CRITICAL(&_workerMux);
+
+  return queued;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebWorker::collect()
+{
+  AsyncWebDeferred *job;
+
+  while (_done.pop(job))
+  {
+    AsyncWebServerRequest *request = job->_request;
+    AsyncWebServerResponse *response = job->_response;
+    const bool orphaned = job->_orphaned;
+
+    delete job;
+
+    portENTER_CRITICAL(&_workerMux);
+
+    _stats.pending--;
+
+    if (orphaned)
+      _stats.orphaned++;
+    else
+      _stats.completed++;
+
+    portEXIT_CRITICAL(&_workerMux);
+
+    if (!request)
+      continue;
+
+    request->_deferred = NULL;
+
+    if (orphaned)
+    {
+      if (response)
+        delete response;
+
+      request->_release();
+
+      continue;
+    }
+
+    // A handler that didn't answer gets a 500, like a missing source
+    if (response)
+      request->send(response);
+    else
+      request->send(500);
+  }
+}
@@ -0,0 +1,144 @@
+/****************************************************************************************************************************
+  AsyncWebWorker.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef ASYNCWEBWORKER_H_
+#define ASYNCWEBWORKER_H_
+
+// Worker tasks for handlers too slow to run on the async_tcp task (Modbus polls, SD card scans,
+// fetching from the cloud...), see AsyncWebServerRequest::defer() and AsyncWebServer::onAsync().
+//
+// The handler runs on a worker with the request and calls send() as usual, which only keeps the
+// response. The finished job goes through a lock-free ring back to the async_tcp task, and the
+// worker wakes the request's connection through AsyncWebWake, whose poll sends the response. If
+// the client disconnects while the handler runs, the request is kept alive until the handler
+// returns, then the response is dropped and the request released, also on the async_tcp task.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncMpscRing.h"
+
+/////////////////////////////////////////////////
+
+// Deferred requests in flight, queued, running or waiting to be sent. A power of 2.
+#ifndef ASYNC_WEB_WORKER_QUEUE_SIZE
+  #define ASYNC_WEB_WORKER_QUEUE_SIZE     8
+#endif
+
+// Workers started by the first defer(), unless begin() was called
+#ifndef ASYNC_WEB_WORKER_COUNT
+  #define ASYNC_WEB_WORKER_COUNT          1
+#endif
+
+#ifndef ASYNC_WEB_WORKER_STACK_SIZE
+  #define ASYNC_WEB_WORKER_STACK_SIZE     8192
+#endif
+
+#ifndef ASYNC_WEB_WORKER_PRIORITY
+  #define ASYNC_WEB_WORKER_PRIORITY       2
+#endif
+
+// Keep the handlers off the core running async_tcp
+#ifndef ASYNC_WEB_WORKER_CORE
+  #if defined(CONFIG_ASYNC_TCP_RUNNING_CORE) && (CONFIG_ASYNC_TCP_RUNNING_CORE >= 0)
+    #define ASYNC_WEB_WORKER_CORE         (1 - CONFIG_ASYNC_TCP_RUNNING_CORE)
+  #else
+    #define ASYNC_WEB_WORKER_CORE         0
+  #endif
+#endif
+
+/////////////////////////////////////////////////
+
+typedef struct
+{
+  size_t pending;       // Deferred requests not handed back to the network task yet
+  size_t highWater;     // Highest pending so far
+  uint32_t completed;   // Responses sent
+  uint32_t orphaned;    // Client gone before the response could be sent
+  uint32_t refused;     // defer() failed, queue full or no worker
+  uint32_t lastWait;    // ms from defer() until a worker started the handler
+  uint32_t maxWait;
+  uint32_t lastRun;     // ms spent in the handler
+  uint32_t maxRun;
+} AsyncWebWorkerStats;
+
+/////////////////////////////////////////////////
+
+class AsyncWebDeferred
+{
+    friend class AsyncWebWorker;
+
+  private:
+    AsyncWebServerRequest* _request;    // NULL once released, the client left before a worker started
+    AsyncClient* _client;               // Woken when done, only used as a key
+    ArRequestHandlerFunction _fn;
+    AsyncWebServerResponse* _response;  // Set by send() on the worker
+    uint32_t _queuedAt;
+    uint8_t _state;
+    bool _orphaned;                     // Client disconnected, the response is dropped
+
+    AsyncWebDeferred(AsyncWebServerRequest* request, ArRequestHandlerFunction fn)
+      : _request(request), _client(request->client()), _fn(fn), _response(NULL), _queuedAt(millis()), _state(0),
+        _orphaned(false) {}
+};
+
+/////////////////////////////////////////////////
+
+class AsyncWebWorker
+{
+  private:
+    static QueueHandle_t _queue;
+    static AsyncMpscRing<AsyncWebDeferred*, ASYNC_WEB_WORKER_QUEUE_SIZE> _done;
+    static AsyncWebWorkerStats _stats;
+
+    static void _worker(void *arg);
+
+  public:
+    // Starts count workers, once. Optional, the first defer() starts them with the defaults.
+    static bool begin(uint8_t count = ASYNC_WEB_WORKER_COUNT, UBaseType_t priority = ASYNC_WEB_WORKER_PRIORITY,
+                      BaseType_t core = ASYNC_WEB_WORKER_CORE);
+
+    static AsyncWebWorkerStats stats();
+
+    // async_tcp task : queue the request for a worker, false if there's no room
+    static bool _defer(AsyncWebServerRequest* request, ArRequestHandlerFunction fn);
+
+    // Worker : send() called by the handler
+    static void _keep(AsyncWebDeferred* job, AsyncWebServerResponse* response);
+
+    // async_tcp task : the client of a deferred request disconnected.
+    // True if no worker touches the request any more and it can be released now.
+    static bool _orphan(AsyncWebDeferred* job);
+
+    // async_tcp task : send the responses of finished handlers and release orphaned requests
+    static void collect();
+};
+
+#endif /* ASYNCWEBWORKER_H_ */
@@ -36,6 +36,9 @@
 #include "stddef.h"
 #include "WString.h"
 
+#include <functional>
+#include <utility>
+
 /////////////////////////////////////////////////
 
 template <typename T>
@@ -305,6 +308,19 @@ class LinkedList
 
     /////////////////////////////////////////////////
 
+    // Removes every element matching predicate, safe where removing while iterating isn't
+    size_t remove_if(Predicate predicate)
+    {
+      size_t removed = 0;
+
+      while (remove_first(predicate))
+        removed++;
+
+      return removed;
+    }
+
+    /////////////////////////////////////////////////
+
     void free()
     {
       while (_root != nullptr)
@@ -327,11 +343,283 @@ class LinkedList
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 
-class StringArray : public LinkedList<String>
+// Same interface as LinkedList, but the elements are contiguous : the first N live inside the
+// object, more go to one heap array that doubles as needed and is kept by free(). length() is O(1),
+// add() doesn't allocate until N is exceeded, and the remover is a plain function pointer.
+// As with LinkedList, the destructor doesn't call the remover, the owner calls free().
+// Iterators are plain pointers and are invalidated by add() and any remove.
+template <typename T, size_t N>
+class SmallVector
+{
+  public:
+    typedef void (*OnRemove)(T);
+    typedef const T* ConstIterator;
+
+  private:
+    T* _data;             // _inline until more than N elements were added
+    size_t _length;
+    size_t _capacity;
+    OnRemove _onRemove;
+    T _inline[N];
+
+    /////////////////////////////////////////////////
+
+    void _reserve(size_t capacity)
+    {
+      if (capacity <= _capacity)
+        return;
+
+      size_t grown = _capacity * 2;
+
+      if (grown < capacity)
+        grown = capacity;
+
+      T* data = new T[grown];
+
+      for (size_t i = 0; i < _length; i++)
+        data[i] = std::move(_data[i]);
+
+      if (_data != _inline)
+      {
+        delete[] _data;
+      }
+      else
+      {
+        for (size_t i = 0; i < _length; i++)
+          _inline[i] = T();
+      }
+
+      _data = data;
+      _capacity = grown;
+    }
+
+    /////////////////////////////////////////////////
+
+    void _removeAt(size_t index)
+    {
+      T value = std::move(_data[index]);
+
+      for (size_t i = index + 1; i < _length; i++)
+        _data[i - 1] = std::move(_data[i]);
+
+      _data[--_length] = T();
+
+      // Unlinked first, the remover may use the list again
+      if (_onRemove)
+        _onRemove(value);
+    }
+
+    /////////////////////////////////////////////////
+
+    void _copy(const SmallVector& other)
+    {
+      _reserve(other._length);
+
+      for (size_t i = 0; i < other._length; i++)
+        _data[i] = other._data[i];
+
+      _length = other._length;
+    }
+
+  public:
+    SmallVector(OnRemove onRemove = nullptr) : _data(_inline), _length(0), _capacity(N), _onRemove(onRemove) {}
+
+    /////////////////////////////////////////////////
+
+    SmallVector(const SmallVector& other) : _data(_inline), _length(0), _capacity(N), _onRemove(other._onRemove)
+    {
+      _copy(other);
+    }
+
+    /////////////////////////////////////////////////
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+      if (this != &other)
+      {
+        for (size_t i = 0; i < _length; i++)
+          _data[i] = T();
+
+        _length = 0;
+        _onRemove = other._onRemove;
+        _copy(other);
+      }
+
+      return *this;
+    }
+
+    /////////////////////////////////////////////////
+
+    ~SmallVector()
+    {
+      if (_data != _inline)
+        delete[] _data;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline ConstIterator begin() const
+    {
+      return _data;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline ConstIterator end() const
+    {
+      return _data + _length;
+    }
+
+    /////////////////////////////////////////////////
+
+    void add(const T& t)
+    {
+      if (_length == _capacity)
+        _reserve(_length + 1);
+
+      _data[_length++] = t;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline T& front()
+    {
+      return _data[0];
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const T& front() const
+    {
+      return _data[0];
+    }
+
+    /////////////////////////////////////////////////
+
+    inline bool isEmpty() const
+    {
+      return _length == 0;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline size_t length() const
+    {
+      return _length;
+    }
+
+    /////////////////////////////////////////////////
+
+    template <typename Predicate>
+    size_t count_if(Predicate predicate) const
+    {
+      size_t count = 0;
+
+      for (size_t i = 0; i < _length; i++)
+      {
+        if (predicate(_data[i]))
+          count++;
+      }
+
+      return count;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline const T* nth(size_t n) const
+    {
+      return (n < _length) ? &_data[n] : nullptr;
+    }
+
+    /////////////////////////////////////////////////
+
+    bool remove(const T& t)
+    {
+      for (size_t i = 0; i < _length; i++)
+      {
+        if (_data[i] == t)
+        {
+          _removeAt(i);
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+
+    template <typename Predicate>
+    bool remove_first(Predicate predicate)
+    {
+      for (size_t i = 0; i < _length; i++)
+      {
+        if (predicate(_data[i]))
+        {
+          _removeAt(i);
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Removes every element matching predicate, safe where removing while iterating isn't
+    template <typename Predicate>
+    size_t remove_if(Predicate predicate)
+    {
+      size_t removed = 0;
+      size_t i = 0;
+
+      while (i < _length)
+      {
+        if (predicate(_data[i]))
+        {
+          _removeAt(i);
+          removed++;
+        }
+        else
+        {
+          i++;
+        }
+      }
+
+      return removed;
+    }
+
+    /////////////////////////////////////////////////
+
+    // Empties the list, the heap array is kept for the next elements
+    void free()
+    {
+      if (!_onRemove)
+      {
+        for (size_t i = 0; i < _length; i++)
+          _data[i] = T();
+
+        _length = 0;
+
+        return;
+      }
+
+      // One at a time as removers may use the list, from the back so nothing is shifted
+      while (_length)
+        _removeAt(_length - 1);
+    }
+};
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+class StringArray : public SmallVector<String, 4>
 {
   public:
 
-    StringArray() : LinkedList(nullptr) {}
+    StringArray() : SmallVector(nullptr) {}
 
     /////////////////////////////////////////////////
 
@@ -34,6 +34,7 @@
 #define ASYNCWEBSERVERHANDLERIMPL_H_
 
 #include <string>
+#include <vector>
 
 #ifdef ASYNCWEBSERVER_REGEX
   #include <regex>
@@ -43,6 +44,7 @@
 #include <time.h>
 
 #include "AsyncWebServer_ESP32_ENC_Debug.h"
+#include "AsyncAssetImage.h"
 
 /////////////////////////////////////////////////
 
@@ -67,6 +69,7 @@ class AsyncStaticWebHandler: public AsyncWebHandler
     bool _isDir;
     bool _gzipFirst;
     uint8_t _gzipStats;
+    uint8_t _prefetchDepth;
 
   public:
     AsyncStaticWebHandler(const char* uri, FS& fs, const char* path, const char* cache_control);
@@ -77,6 +80,8 @@ class AsyncStaticWebHandler: public AsyncWebHandler
     AsyncStaticWebHandler& setCacheControl(const char* cache_control);
     AsyncStaticWebHandler& setLastModified(const char* last_modified);
     AsyncStaticWebHandler& setLastModified(struct tm* last_modified);
+    // Read files ahead in a worker task, see AsyncFileResponse::setPrefetch()
+    AsyncStaticWebHandler& setPrefetch(uint8_t depth);
 
     AsyncStaticWebHandler& setTemplateProcessor(AwsTemplateProcessor newCallback)
     {
@@ -87,6 +92,40 @@ class AsyncStaticWebHandler: public AsyncWebHandler
 
 /////////////////////////////////////////////////
 
+class AsyncAssetWebHandler: public AsyncWebHandler
+{
+  private:
+    const AsyncAssetImageEntry* _findEntry(AsyncWebServerRequest *request) const;
+    const char* _contentType(const AsyncAssetImageEntry* entry);
+
+  protected:
+    AsyncAssetImage _image;
+    // Content-Type per entry, resolved on first use and again after addMimeType()
+    std::vector<int16_t> _mimeCache;
+    uint16_t _mimeGeneration;
+    String _uri;
+    String _default_file;
+    String _cache_control;
+
+  public:
+    AsyncAssetWebHandler(const char* uri, const char* label, const char* cache_control);
+    virtual bool canHandle(AsyncWebServerRequest *request) override final;
+    virtual void handleRequest(AsyncWebServerRequest *request) override final;
+    AsyncAssetWebHandler& setDefaultFile(const char* filename);
+    AsyncAssetWebHandler& setCacheControl(const char* cache_control);
+
+    /////////////////////////////////////////////////
+
+    inline const AsyncAssetImage& image() const
+    {
+      return _image;
+    }
+
+    /////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////
+
 class AsyncCallbackWebHandler: public AsyncWebHandler
 {
   private:
@@ -98,10 +137,14 @@ class AsyncCallbackWebHandler: public AsyncWebHandler
     ArUploadHandlerFunction _onUpload;
     ArBodyHandlerFunction _onBody;
     bool _isRegex;
+    uint32_t _cacheTtl;
+    StringArray _cacheHeaders;
+
+    void _handleCached(AsyncWebServerRequest *request);
 
   public:
     AsyncCallbackWebHandler() : _uri(), _method(HTTP_ANY), _onRequest(NULL), _onUpload(NULL), _onBody(NULL),
-      _isRegex(false) {}
+      _isRegex(false), _cacheTtl(0) {}
 
     /////////////////////////////////////////////////
 
@@ -141,12 +184,19 @@ class AsyncCallbackWebHandler: public AsyncWebHandler
 
     /////////////////////////////////////////////////
 
+    // Keeps rendered 200 responses to GET for ttlMs, see AsyncResponseCache. The key is the url, the query
+    // and the request headers named in the comma separated keyHeaders. 0 turns caching off.
+    AsyncCallbackWebHandler& setCache(uint32_t ttlMs, const char* keyHeaders = NULL);
+
+    /////////////////////////////////////////////////
+
     virtual bool canHandle(AsyncWebServerRequest *request) override final
     {
       if (!_onRequest)
         return false;
 
-      if (!(_method & request->method()))
+      // GET routes answer HEAD too, when no route takes it as HEAD. The response then sends its head only.
+      if (!(_method & request->method()) && !(request->_headAsGet && (_method & HTTP_GET)))
         return false;
 
 #ifdef ASYNCWEBSERVER_REGEX
@@ -203,7 +253,9 @@ class AsyncCallbackWebHandler: public AsyncWebHandler
       if ((_username != "" && _password != "") && !request->authenticate(_username.c_str(), _password.c_str()))
         return request->requestAuthentication();
 
-      if (_onRequest)
+      if (_onRequest && _cacheTtl && (request->method() & (HTTP_GET | HTTP_HEAD)))
+        _handleCached(request);
+      else if (_onRequest)
         _onRequest(request);
       else
         request->send(500);
@@ -239,6 +291,14 @@ class AsyncCallbackWebHandler: public AsyncWebHandler
     {
       return _onRequest ? false : true;
     }
+
+    /////////////////////////////////////////////////
+
+    // An onBody callback gets the body as it arrives, as before spooling existed
+    virtual bool canSpoolBody() override final
+    {
+      return !_onBody;
+    }
 };
 
 #endif /* ASYNCWEBSERVERHANDLERIMPL_H_ */
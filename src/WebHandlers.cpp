@@ -33,6 +33,20 @@
 #include "AsyncWebServer_ESP32_ENC.h"
 
 #include "WebHandlerImpl.h"
+#include "AsyncResponseCache.h"
+
+/////////////////////////////////////////////////
+
+int AsyncWebHandler::checkBody(AsyncWebServerRequest *request)
+{
+  if (_maxContentLength && (request->contentLength() > _maxContentLength))
+    return 413;
+
+  if ((_username != "" && _password != "") && !request->authenticate(_username.c_str(), _password.c_str()))
+    return 401;
+
+  return 0;
+}
 
 /////////////////////////////////////////////////
 
@@ -62,6 +76,8 @@ AsyncStaticWebHandler::AsyncStaticWebHandler(const char* uri, FS& fs, const char
   // Reset stats
   _gzipFirst = false;
   _gzipStats = 0xF8;
+
+  _prefetchDepth = 0;
 }
 
 /////////////////////////////////////////////////
@@ -112,9 +128,18 @@ AsyncStaticWebHandler& AsyncStaticWebHandler::setLastModified(struct tm* last_mo
 
 /////////////////////////////////////////////////
 
+AsyncStaticWebHandler& AsyncStaticWebHandler::setPrefetch(uint8_t depth)
+{
+  _prefetchDepth = depth;
+
+  return *this;
+}
+
+/////////////////////////////////////////////////
+
 bool AsyncStaticWebHandler::canHandle(AsyncWebServerRequest *request)
 {
-  if (request->method() != HTTP_GET || !request->url().startsWith(_uri)
+  if (!(request->method() & (HTTP_GET | HTTP_HEAD)) || !request->url().startsWith(_uri)
       || !request->isExpectedRequestedConnType(RCT_DEFAULT, RCT_HTTP) )
   {
     return false;
@@ -206,10 +231,13 @@ bool AsyncStaticWebHandler::_fileExists(AsyncWebServerRequest *request, const St
 
   if (found)
   {
-    // Extract the file name from the path and keep it in _tempObject
+    // Extract the file name from the path and keep it in _tempObject, released with the request
     size_t pathLen = path.length();
-    char * _tempPath = (char*)malloc(pathLen + 1);
-    snprintf(_tempPath, pathLen + 1, "%s", path.c_str());
+    char * _tempPath = (char*)request->tempAlloc(pathLen + 1);
+
+    if (_tempPath)
+      memcpy(_tempPath, path.c_str(), pathLen + 1);
+
     request->_tempObject = (void*)_tempPath;
 
     // Calculate gzip statistic
@@ -243,9 +271,8 @@ uint8_t AsyncStaticWebHandler::_countBits(const uint8_t value) const
 
 void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest *request)
 {
-  // Get the filename from request->_tempObject and free it
-  String filename = String((char*)request->_tempObject);
-  free(request->_tempObject);
+  // Get the filename from request->_tempObject, its memory goes with the request
+  String filename = request->_tempObject ? String((char*)request->_tempObject) : String();
   request->_tempObject = NULL;
 
   if ((_username != "" && _password != "") && !request->authenticate(_username.c_str(), _password.c_str()))
@@ -264,6 +291,12 @@ void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest *request)
              && request->header("If-None-Match").equals(etag))
     {
       request->_tempFile.close();
+
+      AsyncCannedHeader headers[] = { { "Cache-Control", _cache_control.c_str() }, { "ETag", etag.c_str() } };
+
+      if (request->_sendCanned(304, headers, 2))
+        return;
+
       AsyncWebServerResponse * response = new AsyncBasicResponse(304); // Not modified
 
       response->addHeader("Cache-Control", _cache_control);
@@ -272,7 +305,10 @@ void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest *request)
     }
     else
     {
-      AsyncWebServerResponse * response = new AsyncFileResponse(request->_tempFile, filename, String(), false, _callback);
+      AsyncFileResponse * response = new AsyncFileResponse(request->_tempFile, filename, String(), false, _callback);
+
+      if (_prefetchDepth && (request->method() != HTTP_HEAD))
+        response->setPrefetch(_prefetchDepth);
 
       if (_last_modified.length())
         response->addHeader("Last-Modified", _last_modified);
@@ -291,3 +327,293 @@ void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest *request)
     request->send(404);
   }
 }
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+// _mimeCache values besides AsyncWebMimeTypes indexes (-1 : unknown extension)
+#define ASSET_MIME_UNRESOLVED     -3
+#define ASSET_MIME_IMAGE          -2      // The type recorded by the image builder
+
+AsyncAssetWebHandler::AsyncAssetWebHandler(const char* uri, const char* label, const char* cache_control)
+  : _mimeGeneration(AsyncWebMimeTypes::generation()), _uri(uri), _default_file("index.htm"), _cache_control(cache_control)
+{
+  // Ensure leading '/', and remove the trailing one. Notice that root will be "" not "/"
+  if (_uri.length() == 0 || _uri[0] != '/')
+    _uri = "/" + _uri;
+
+  if (_uri[_uri.length() - 1] == '/')
+    _uri = _uri.substring(0, _uri.length() - 1);
+
+  if (_image.begin(label))
+    _mimeCache.assign(_image.count(), ASSET_MIME_UNRESOLVED);
+}
+
+/////////////////////////////////////////////////
+
+AsyncAssetWebHandler& AsyncAssetWebHandler::setDefaultFile(const char* filename)
+{
+  _default_file = String(filename);
+
+  return *this;
+}
+
+/////////////////////////////////////////////////
+
+AsyncAssetWebHandler& AsyncAssetWebHandler::setCacheControl(const char* cache_control)
+{
+  _cache_control = String(cache_control);
+
+  return *this;
+}
+
+/////////////////////////////////////////////////
+
+const AsyncAssetImageEntry* AsyncAssetWebHandler::_findEntry(AsyncWebServerRequest *request) const
+{
+  // Look the path up in place, without building a substring
+  const char* path = request->url().c_str() + _uri.length();
+  size_t pathLen = request->url().length() - _uri.length();
+
+  if (pathLen && path[pathLen - 1] != '/')
+    return _image.find(path, pathLen);
+
+  if (_default_file.length() == 0)
+    return NULL;
+
+  // Request to the root of a directory, try the default file
+  String defaultPath = String(path);
+
+  if (pathLen == 0)
+    defaultPath += "/";
+
+  defaultPath += _default_file;
+
+  return _image.find(defaultPath.c_str(), defaultPath.length());
+}
+
+/////////////////////////////////////////////////
+
+// Precedence : a type registered with addMimeType(), then the type recorded by the image builder,
+// then the built-in table. Cached as table indexes, which stay valid when types are added.
+const char* AsyncAssetWebHandler::_contentType(const AsyncAssetImageEntry* entry)
+{
+  if (_mimeGeneration != AsyncWebMimeTypes::generation())
+  {
+    _mimeGeneration = AsyncWebMimeTypes::generation();
+    std::fill(_mimeCache.begin(), _mimeCache.end(), ASSET_MIME_UNRESOLVED);
+  }
+
+  size_t index = entry - _image.entry(0);
+
+  if (_mimeCache[index] == ASSET_MIME_UNRESOLVED)
+  {
+    int16_t found = AsyncWebMimeTypes::index(_image.path(entry), entry->pathLength);
+
+    if (_image.mime(entry) && !AsyncWebMimeTypes::registered(found))
+      found = ASSET_MIME_IMAGE;
+
+    _mimeCache[index] = found;
+  }
+
+  if (_mimeCache[index] == ASSET_MIME_IMAGE)
+    return _image.mime(entry);
+
+  return (_mimeCache[index] < 0) ? "text/plain" : AsyncWebMimeTypes::type(_mimeCache[index]);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncAssetWebHandler::canHandle(AsyncWebServerRequest *request)
+{
+  if (!(request->method() & (HTTP_GET | HTTP_HEAD)) || !_image.mapped() || !request->url().startsWith(_uri)
+      || !request->isExpectedRequestedConnType(RCT_DEFAULT, RCT_HTTP) )
+  {
+    return false;
+  }
+
+  if (_findEntry(request))
+  {
+    // Image entries always carry an ETag
+    request->addInterestingHeader("If-None-Match");
+
+    AWS_LOGDEBUG("[AsyncAssetWebHandler::canHandle] TRUE");
+
+    return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncAssetWebHandler::handleRequest(AsyncWebServerRequest *request)
+{
+  if ((_username != "" && _password != "") && !request->authenticate(_username.c_str(), _password.c_str()))
+    return request->requestAuthentication();
+
+  const AsyncAssetImageEntry* entry = _findEntry(request);
+
+  if (!entry)
+  {
+    request->send(404);
+
+    return;
+  }
+
+  char etag[11];
+  snprintf(etag, sizeof(etag), "\"%08x\"", (unsigned int) entry->etag);
+
+  AsyncWebServerResponse * response;
+
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match").equals(etag))
+  {
+    AsyncCannedHeader headers[] = { { "Cache-Control", _cache_control.c_str() }, { "ETag", etag } };
+
+    // Cache-Control only when configured
+    if (_cache_control.length() ? request->_sendCanned(304, headers, 2) : request->_sendCanned(304, &headers[1], 1))
+      return;
+
+    response = new AsyncBasicResponse(304); // Not modified
+  }
+  else
+  {
+    response = new AsyncAssetResponse(200, _contentType(entry), _image.data(entry), entry->dataLength);
+
+    if (entry->flags & ASYNC_ASSET_FLAG_GZIP)
+      response->addHeader("Content-Encoding", "gzip");
+  }
+
+  if (_cache_control.length())
+    response->addHeader("Cache-Control", _cache_control);
+
+  response->addHeader("ETag", etag);
+  request->send(response);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+AsyncCallbackWebHandler& AsyncCallbackWebHandler::setCache(uint32_t ttlMs, const char* keyHeaders)
+{
+  _cacheTtl = ttlMs;
+  _cacheHeaders.free();
+
+  String list = keyHeaders ? keyHeaders : "";
+
+  while (list.length())
+  {
+    int comma = list.indexOf(',');
+    String name = (comma < 0) ? list : list.substring(0, comma);
+
+    list = (comma < 0) ? String() : list.substring(comma + 1);
+    name.trim();
+
+    if (name.length())
+      _cacheHeaders.add(name);
+  }
+
+  return *this;
+}
+
+/////////////////////////////////////////////////
+
+// If-None-Match holds the etag, as a list and weak comparison allowed (RFC 7232, 3.2)
+static bool etagMatches(const String& ifNoneMatch, const char* etag)
+{
+  int start = 0;
+
+  while (start < (int) ifNoneMatch.length())
+  {
+    int comma = ifNoneMatch.indexOf(',', start);
+
+    if (comma < 0)
+      comma = ifNoneMatch.length();
+
+    String tag = ifNoneMatch.substring(start, comma);
+    tag.trim();
+
+    if (tag.startsWith("W/"))
+      tag = tag.substring(2);
+
+    if (tag == "*" || tag == etag)
+      return true;
+
+    start = comma + 1;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncCallbackWebHandler::_handleCached(AsyncWebServerRequest *request)
+{
+  // HEAD shares the entry of GET, only the head is sent
+  String key = F("GET ");
+  key += request->url();
+
+  char sep = '?';
+
+  for (size_t i = 0; i < request->params(); i++)
+  {
+    AsyncWebParameter* param = request->getParam(i);
+
+    if (param->isPost() || param->isFile())
+      continue;
+
+    key += sep;
+    key += param->name();
+    key += '=';
+    key += param->value();
+    sep = '&';
+  }
+
+  for (const auto& name : _cacheHeaders)
+  {
+    key += '\n';
+    key += name;
+    key += ": ";
+
+    AsyncWebHeader* header = request->getHeader(name);
+
+    if (header)
+      key += header->value();
+  }
+
+  const uint32_t hash = AsyncResponseCache::hash(key);
+  AsyncCacheEntryPtr entry = AsyncResponseCache::find(key, hash);
+
+  if (entry)
+  {
+    if (request->hasHeader("If-None-Match") && etagMatches(request->header("If-None-Match"), entry->etag))
+    {
+      AsyncCannedHeader headers[] = { { "ETag", entry->etag } };
+
+      if (request->_sendCanned(304, headers, 1))
+        return;
+
+      AsyncWebServerResponse * response = new AsyncBasicResponse(304); // Not modified
+
+      response->addHeader("ETag", entry->etag);
+      request->send(response);
+
+      return;
+    }
+
+    request->send(new AsyncCachedResponse(entry));
+
+    return;
+  }
+
+  // Only a GET renders the whole body, the response sent by the callback fills the entry
+  if (request->method() == HTTP_GET && AsyncResponseCache::budget())
+    request->_capture = new AsyncCacheCapture(key, hash, _cacheTtl);
+
+  _onRequest(request);
+
+  // Nothing was sent (deferred, or send() refused the response)
+  delete request->_capture;
+  request->_capture = NULL;
+}
+
@@ -35,6 +35,9 @@
 
 #include "WebResponseImpl.h"
 #include "WebAuthentication.h"
+#include "AsyncBodySpool.h"
+#include "AsyncResponseCache.h"
+#include "AsyncWebWorker.h"
 
 #ifndef ESP8266
   #define os_strlen strlen
@@ -50,6 +53,152 @@ enum { PARSE_REQ_START, PARSE_REQ_HEADERS, PARSE_REQ_BODY, PARSE_REQ_END, PARSE_
 
 /////////////////////////////////////////////////
 
+// Indexed by AsyncWebHeaderId
+static constexpr const char* knownHeaderNames[AWS_HEADER_KNOWN] =
+{
+  "Host",
+  "Content-Type",
+  "Content-Length",
+  "Authorization",
+  "Cookie",
+  "If-None-Match",
+  "If-Modified-Since",
+  "Accept",
+  "Accept-Encoding",
+  "Expect",
+  "Connection",
+  "Upgrade",
+  "Origin",
+  "Range",
+  "User-Agent",
+  "Last-Event-ID",
+  "Sec-WebSocket-Key",
+  "Sec-WebSocket-Version",
+  "Sec-WebSocket-Protocol",
+  "Sec-WebSocket-Extensions"
+};
+
+// Known headers _parseReqHeader() takes request state from, whether or not they are stored
+static const uint32_t parsedHeaders = (1UL << AWS_HEADER_HOST) | (1UL << AWS_HEADER_CONTENT_TYPE)
+                                      | (1UL << AWS_HEADER_CONTENT_LENGTH) | (1UL << AWS_HEADER_EXPECT)
+                                      | (1UL << AWS_HEADER_ACCEPT_ENCODING) | (1UL << AWS_HEADER_AUTHORIZATION)
+                                      | (1UL << AWS_HEADER_UPGRADE) | (1UL << AWS_HEADER_ACCEPT);
+
+/////////////////////////////////////////////////
+
+uint32_t AsyncWebHeader::nameHash(const char* name)
+{
+  uint32_t hash = asyncWebHeaderHash("");
+
+  for (; *name; name++)
+  {
+    const uint8_t c = (uint8_t) (((*name >= 'A') && (*name <= 'Z')) ? (*name + 32) : *name);
+
+    hash = (hash ^ c) * 16777619UL;
+  }
+
+  return hash;
+}
+
+/////////////////////////////////////////////////
+
+uint8_t AsyncWebHeader::knownId(const char* name, uint32_t hash)
+{
+  uint8_t id;
+
+  // The case labels are computed at compile time, a collision between two known names wouldn't build
+  switch (hash)
+  {
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_HOST]):
+      id = AWS_HEADER_HOST;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_CONTENT_TYPE]):
+      id = AWS_HEADER_CONTENT_TYPE;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_CONTENT_LENGTH]):
+      id = AWS_HEADER_CONTENT_LENGTH;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_AUTHORIZATION]):
+      id = AWS_HEADER_AUTHORIZATION;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_COOKIE]):
+      id = AWS_HEADER_COOKIE;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_IF_NONE_MATCH]):
+      id = AWS_HEADER_IF_NONE_MATCH;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_IF_MODIFIED_SINCE]):
+      id = AWS_HEADER_IF_MODIFIED_SINCE;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_ACCEPT]):
+      id = AWS_HEADER_ACCEPT;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_ACCEPT_ENCODING]):
+      id = AWS_HEADER_ACCEPT_ENCODING;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_EXPECT]):
+      id = AWS_HEADER_EXPECT;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_CONNECTION]):
+      id = AWS_HEADER_CONNECTION;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_UPGRADE]):
+      id = AWS_HEADER_UPGRADE;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_ORIGIN]):
+      id = AWS_HEADER_ORIGIN;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_RANGE]):
+      id = AWS_HEADER_RANGE;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_USER_AGENT]):
+      id = AWS_HEADER_USER_AGENT;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_LAST_EVENT_ID]):
+      id = AWS_HEADER_LAST_EVENT_ID;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_SEC_WEBSOCKET_KEY]):
+      id = AWS_HEADER_SEC_WEBSOCKET_KEY;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_SEC_WEBSOCKET_VERSION]):
+      id = AWS_HEADER_SEC_WEBSOCKET_VERSION;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_SEC_WEBSOCKET_PROTOCOL]):
+      id = AWS_HEADER_SEC_WEBSOCKET_PROTOCOL;
+      break;
+
+    case asyncWebHeaderHash(knownHeaderNames[AWS_HEADER_SEC_WEBSOCKET_EXTENSIONS]):
+      id = AWS_HEADER_SEC_WEBSOCKET_EXTENSIONS;
+      break;
+
+    default:
+      return AWS_HEADER_OTHER;
+  }
+
+  // Rule out an unknown name with the same hash
+  return (strcasecmp(name, knownHeaderNames[id]) == 0) ? id : (uint8_t) AWS_HEADER_OTHER;
+}
+
+/////////////////////////////////////////////////
+
 AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
   : _client(c)
   , _server(s)
@@ -69,20 +218,29 @@ AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
   , _isMultipart(false)
   , _isPlainPost(false)
   , _expectingContinue(false)
+  , _expectationFailed(false)
+  , _acceptEncoding(0)
   , _contentLength(0)
   , _parsedLength(0)
-  , _headers(LinkedList<AsyncWebHeader * >([](AsyncWebHeader * h)
-{
-  delete h;
-}))
-, _params(LinkedList<AsyncWebParameter *>([](AsyncWebParameter *p)
-{
-  delete p;
-}))
-, _pathParams(LinkedList<String *>([](String *p)
-{
-  delete p;
-}))
+  , _headers([](AsyncWebHeader * h)
+{
+  h->~AsyncWebHeader();
+})
+, _knownHeaders()
+, _params([](AsyncWebParameter *p)
+{
+  p->~AsyncWebParameter();
+})
+, _query()
+, _queryParsed(false)
+, _queryCount(-1)
+, _queryIndex(NULL)
+, _cookieCount(-1)
+, _cookieIndex(NULL)
+, _pathParams([](String *p)
+{
+  p->~String();
+})
 , _multiParseState(0)
 , _boundaryPosition(0)
 , _itemStartIndex(0)
@@ -94,8 +252,25 @@ AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
 , _itemBuffer(0)
 , _itemBufferIndex(0)
 , _itemIsFile(false)
+, _bodySpool(NULL)
+, _capture(NULL)
+, _pooled(false)
+, _deferred(NULL)
+, _earlyRouting(false)
+, _answered(false)
+, _headAsGet(false)
 , _tempObject(NULL)
 {
+  if (c)
+    _bind(c);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServerRequest::_bind(AsyncClient* c)
+{
+  _client = c;
+
   c->onError([](void *r, AsyncClient * c, int8_t error)
   {
     ESP32_ENC_AWS_UNUSED(c);
@@ -155,10 +330,134 @@ AsyncWebServerRequest::~AsyncWebServerRequest()
     delete _response;
   }
 
-  if (_tempObject != NULL)
+  if ((_tempObject != NULL) && !_arena.owns(_tempObject))
+  {
+    free(_tempObject);
+  }
+
+  if (_bodySpool != NULL)
+  {
+    delete _bodySpool;
+  }
+
+  if (_capture != NULL)
+  {
+    delete _capture;
+  }
+}
+
+/////////////////////////////////////////////////
+
+// Back to the state of a new request, the lists and Strings keep their allocations for the next connection
+void AsyncWebServerRequest::_recycle()
+{
+  _headers.free();
+  memset(_knownHeaders, 0, sizeof(_knownHeaders));
+
+  _params.free();
+  _pathParams.free();
+
+  _query = "";
+  _queryParsed = false;
+  _queryCount = -1;
+  _queryIndex = NULL;
+  _cookieCount = -1;
+  _cookieIndex = NULL;
+
+  _interestingHeaders.free();
+
+  if (_response != NULL)
+  {
+    delete _response;
+    _response = NULL;
+  }
+
+  if ((_tempObject != NULL) && !_arena.owns(_tempObject))
   {
     free(_tempObject);
   }
+
+  _tempObject = NULL;
+
+  // Everything made from the arena is destroyed by now
+  _arena.reset();
+
+  if (_bodySpool != NULL)
+  {
+    delete _bodySpool;
+    _bodySpool = NULL;
+  }
+
+  if (_capture != NULL)
+  {
+    delete _capture;
+    _capture = NULL;
+  }
+
+  if (_itemBuffer != NULL)
+  {
+    free(_itemBuffer);
+    _itemBuffer = NULL;
+  }
+
+  _tempFile = File();
+
+  _client = NULL;
+  _handler = NULL;
+  _onDisconnectfn = NULL;
+  _deferred = NULL;
+  _earlyRouting = false;
+  _answered = false;
+  _headAsGet = false;
+
+  _temp = "";
+  _parseState = 0;
+  _version = 0;
+  _method = HTTP_ANY;
+  _url = "";
+  _host = "";
+  _contentType = "";
+  _boundary = "";
+  _authorization = "";
+  _reqconntype = RCT_HTTP;
+  _isDigest = false;
+  _isMultipart = false;
+  _isPlainPost = false;
+  _expectingContinue = false;
+  _expectationFailed = false;
+  _acceptEncoding = 0;
+  _contentLength = 0;
+  _parsedLength = 0;
+
+  _multiParseState = 0;
+  _boundaryPosition = 0;
+  _itemStartIndex = 0;
+  _itemSize = 0;
+  _itemName = "";
+  _itemFilename = "";
+  _itemType = "";
+  _itemValue = "";
+  _itemBufferIndex = 0;
+  _itemIsFile = false;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServerRequest::_release()
+{
+  _server->_releaseRequest(this);
+}
+
+/////////////////////////////////////////////////
+
+void* AsyncWebServerRequest::tempAlloc(size_t size)
+{
+  void *p = _arena.alloc(size);
+
+  if (p)
+    memset(p, 0, size);
+
+  return p;
 }
 
 /////////////////////////////////////////////////
@@ -248,9 +547,37 @@ void AsyncWebServerRequest::_onData(void *buf, size_t len)
               _isPlainPost = true;
             }
           }
+
+          // Only worth it when a handler waits for the whole body
+          if (!_isPlainPost && needParse && _handler->canSpoolBody())
+          {
+            // The PSRAM block is sized from the Content-Length the client claims
+            if (_server->_spoolsBody(_contentLength) && (_contentLength > ASYNC_BODY_SPOOL_MAX_LENGTH))
+            {
+              _parseState = PARSE_REQ_END;
+              send(413);
+
+              break;
+            }
+
+            _bodySpool = _server->_spoolBody(_contentLength);
+          }
         }
 
-        if (!_isPlainPost)
+        if (_bodySpool)
+        {
+          if (!_bodySpool->append((uint8_t*)buf, len))
+          {
+            // Out of space, the rest of the body is never read
+            _parseState = PARSE_REQ_END;
+            send(507);
+
+            break;
+          }
+
+          _parsedLength += len;
+        }
+        else if (!_isPlainPost)
         {
           //check if authenticated before calling the body
           if (_handler)
@@ -278,6 +605,13 @@ void AsyncWebServerRequest::_onData(void *buf, size_t len)
       {
         _parseState = PARSE_REQ_END;
 
+        if (_bodySpool && !_bodySpool->finish())
+        {
+          send(507);
+
+          break;
+        }
+
         //check if authenticated before calling handleRequest and request auth instead
         if (_handler)
           _handler->handleRequest(this);
@@ -293,17 +627,37 @@ void AsyncWebServerRequest::_onData(void *buf, size_t len)
 
 /////////////////////////////////////////////////
 
+bool AsyncWebServerRequest::_isInterestingHeader(const String& name)
+{
+  return _interestingHeaders.containsIgnoreCase("ANY") || _interestingHeaders.containsIgnoreCase(name);
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServerRequest::_removeNotInterestingHeaders()
 {
   if (_interestingHeaders.containsIgnoreCase("ANY"))
     return; // nothing to do
 
-  for (const auto& header : _headers)
+  _headers.remove_if([this](AsyncWebHeader * header)
   {
-    if (!_interestingHeaders.containsIgnoreCase(header->name().c_str()))
-    {
-      _headers.remove(header);
-    }
+    return !_interestingHeaders.containsIgnoreCase(header->name());
+  });
+
+  _indexHeaders();
+}
+
+/////////////////////////////////////////////////
+
+// Points each known header slot at the first such header left in _headers
+void AsyncWebServerRequest::_indexHeaders()
+{
+  memset(_knownHeaders, 0, sizeof(_knownHeaders));
+
+  for (const auto& h : _headers)
+  {
+    if ((h->id() < AWS_HEADER_KNOWN) && !_knownHeaders[h->id()])
+      _knownHeaders[h->id()] = h;
   }
 }
 
@@ -311,7 +665,14 @@ void AsyncWebServerRequest::_removeNotInterestingHeaders()
 
 void AsyncWebServerRequest::_onPoll()
 {
-  if (_response != NULL && _client != NULL && _client->canSend() && !_response->_finished())
+  AsyncWebWorker::collect();
+
+  if (_response == NULL)
+  {
+    if (_handler != NULL && _deferred == NULL && !_answered)
+      _handler->handlePoll(this);
+  }
+  else if (_client != NULL && _client->canSend() && !_response->_finished())
   {
     _response->_ack(this, 0, 0);
   }
@@ -336,6 +697,8 @@ void AsyncWebServerRequest::_onAck(size_t len, uint32_t time)
       delete r;
     }
   }
+
+  AsyncWebWorker::collect();
 }
 
 /////////////////////////////////////////////////
@@ -372,26 +735,69 @@ void AsyncWebServerRequest::_onDisconnect()
     _onDisconnectfn();
   }
 
+  if (_deferred)
+  {
+    // The client is deleted after this returns
+    _client = NULL;
+
+    // Still used by a worker, AsyncWebWorker::collect() releases it once the handler is done
+    if (!AsyncWebWorker::_orphan(_deferred))
+      return;
+
+    _deferred = NULL;
+  }
+
   _server->_handleDisconnect(this);
 }
 
 /////////////////////////////////////////////////
 
-void AsyncWebServerRequest::_addParam(AsyncWebParameter *p)
+void AsyncWebServerRequest::_addParam(const String& name, const String& value, bool form, bool file, size_t size)
 {
-  _params.add(p);
+  // Query parameters come first
+  if (form)
+    _parseQuery();
+
+  AsyncWebParameter *p = _arena.create<AsyncWebParameter>(name, value, form, file, size);
+
+  if (p)
+    _params.add(p);
 }
 
 /////////////////////////////////////////////////
 
 void AsyncWebServerRequest::_addPathParam(const char *p)
 {
-  _pathParams.add(new String(p));
+  String *param = _arena.create<String>(p);
+
+  if (param)
+    _pathParams.add(param);
 }
 
 /////////////////////////////////////////////////
 
+// Only kept raw here, see _parseQuery() and queryArg()
 void AsyncWebServerRequest::_addGetParams(const String& params)
+{
+  if (!params.length())
+    return;
+
+  if (_query.length())
+    _query += '&';
+
+  _query += params;
+
+  // Offsets stay valid, but the table misses the new pairs
+  _queryCount = -1;
+  _queryIndex = NULL;
+
+  if (_queryParsed)
+    _addQueryParams(params);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServerRequest::_addQueryParams(const String& params)
 {
   size_t start = 0;
 
@@ -409,13 +815,28 @@ void AsyncWebServerRequest::_addGetParams(const String& params)
 
     String name = params.substring(start, equal);
     String value = equal + 1 < end ? params.substring(equal + 1, end) : String();
-    _addParam(new AsyncWebParameter(urlDecode(name), urlDecode(value)));
+    _addParam(urlDecode(name), urlDecode(value));
     start = end + 1;
   }
 }
 
 /////////////////////////////////////////////////
 
+// Splits the query string into _params on the first read of a parameter, or before the first body parameter.
+// Lazy, the request is logically unchanged, hence const.
+void AsyncWebServerRequest::_parseQuery() const
+{
+  if (_queryParsed)
+    return;
+
+  AsyncWebServerRequest *self = const_cast<AsyncWebServerRequest *>(this);
+
+  self->_queryParsed = true;
+  self->_addQueryParams(_query);
+}
+
+/////////////////////////////////////////////////
+
 bool AsyncWebServerRequest::_parseReqHead()
 {
   // Split the head into method, url and version
@@ -516,61 +937,105 @@ bool AsyncWebServerRequest::_parseReqHeader()
   if (index)
   {
     String name = _temp.substring(0, index);
-    String value = _temp.substring(index + 2);
 
-    if (name.equalsIgnoreCase("Host"))
-    {
-      _host = value;
-    }
-    else if (name.equalsIgnoreCase("Content-Type"))
-    {
-      _contentType = value.substring(0, value.indexOf(';'));
+    // The name is hashed and matched once here, lookups by handlers then use the id or the hash
+    const uint32_t hash = AsyncWebHeader::nameHash(name.c_str());
+    const uint8_t id = AsyncWebHeader::knownId(name.c_str(), hash);
 
-      if (value.startsWith("multipart/"))
-      {
-        _boundary = value.substring(value.indexOf('=') + 1);
-        _boundary.replace("\"", "");
-        _isMultipart = true;
-      }
-    }
-    else if (name.equalsIgnoreCase("Content-Length"))
+    // Routed at the request line : a header the handler won't read is never stored, nor even copied
+    // out of the line when the request doesn't parse it either
+    const bool store = !_handler || _isInterestingHeader(name);
+
+    if (!store && !((id < AWS_HEADER_KNOWN) && (parsedHeaders & (1UL << id))))
     {
-      _contentLength = atoi(value.c_str());
+      _temp = String();
+
+      return true;
     }
-    else if (name.equalsIgnoreCase("Expect") && value == "100-continue")
+
+    String value = _temp.substring(index + 2);
+
+    switch (id)
     {
-      _expectingContinue = true;
+      case AWS_HEADER_HOST:
+        _host = value;
+        break;
+
+      case AWS_HEADER_CONTENT_TYPE:
+        _contentType = value.substring(0, value.indexOf(';'));
+
+        if (value.startsWith("multipart/"))
+        {
+          _boundary = value.substring(value.indexOf('=') + 1);
+          _boundary.replace("\"", "");
+          _isMultipart = true;
+        }
+
+        break;
+
+      case AWS_HEADER_CONTENT_LENGTH:
+        _contentLength = atoi(value.c_str());
+        break;
+
+      case AWS_HEADER_EXPECT:
+        if (value.equalsIgnoreCase("100-continue"))
+          _expectingContinue = true;
+        else
+          _expectationFailed = true;
+
+        break;
+
+      case AWS_HEADER_ACCEPT_ENCODING:
+        _acceptEncoding = AsyncWebDeflate::parseAcceptEncoding(value.c_str());
+        break;
+
+      case AWS_HEADER_AUTHORIZATION:
+        if (value.length() > 5 && value.substring(0, 5).equalsIgnoreCase("Basic"))
+        {
+          _authorization = value.substring(6);
+        }
+        else if (value.length() > 6 && value.substring(0, 6).equalsIgnoreCase("Digest"))
+        {
+          _isDigest = true;
+          _authorization = value.substring(7);
+        }
+
+        break;
+
+      case AWS_HEADER_UPGRADE:
+        // WebSocket request can be uniquely identified by header: [Upgrade: websocket]
+        if (value.equalsIgnoreCase("websocket"))
+          _reqconntype = RCT_WS;
+
+        break;
+
+      case AWS_HEADER_ACCEPT:
+        // WebEvent request can be uniquely identified by header:  [Accept: text/event-stream]
+        if (strContains(value, "text/event-stream", false))
+          _reqconntype = RCT_EVENT;
+
+        break;
+
+      default:
+        break;
     }
-    else if (name.equalsIgnoreCase("Authorization"))
+
+    if (!store)
     {
-      if (value.length() > 5 && value.substring(0, 5).equalsIgnoreCase("Basic"))
-      {
-        _authorization = value.substring(6);
-      }
-      else if (value.length() > 6 && value.substring(0, 6).equalsIgnoreCase("Digest"))
-      {
-        _isDigest = true;
-        _authorization = value.substring(7);
-      }
+      _temp = String();
+
+      return true;
     }
-    else
+
+    AsyncWebHeader *header = _arena.create<AsyncWebHeader>(name, value, hash, id);
+
+    if (header)
     {
-      if (name.equalsIgnoreCase("Upgrade") && value.equalsIgnoreCase("websocket"))
-      {
-        // WebSocket request can be uniquely identified by header: [Upgrade: websocket]
-        _reqconntype = RCT_WS;
-      }
-      else
-      {
-        if (name.equalsIgnoreCase("Accept") && strContains(value, "text/event-stream", false))
-        {
-          // WebEvent request can be uniquely identified by header:  [Accept: text/event-stream]
-          _reqconntype = RCT_EVENT;
-        }
-      }
-    }
+      _headers.add(header);
 
-    _headers.add(new AsyncWebHeader(name, value));
+      if ((id < AWS_HEADER_KNOWN) && !_knownHeaders[id])
+        _knownHeaders[id] = header;
+    }
   }
 
   _temp = String();
@@ -596,7 +1061,7 @@ void AsyncWebServerRequest::_parsePlainPostChar(uint8_t data)
       value = _temp.substring(_temp.indexOf('=') + 1);
     }
 
-    _addParam(new AsyncWebParameter(urlDecode(name), urlDecode(value), true));
+    _addParam(urlDecode(name), urlDecode(value), true);
     _temp = String();
   }
 }
@@ -842,7 +1307,7 @@ void AsyncWebServerRequest::_parseMultipartPostByte(uint8_t data, bool last)
 
       if (!_itemIsFile)
       {
-        _addParam(new AsyncWebParameter(_itemName, _itemValue, true));
+        _addParam(_itemName, _itemValue, true);
       }
       else
       {
@@ -853,7 +1318,7 @@ void AsyncWebServerRequest::_parseMultipartPostByte(uint8_t data, bool last)
             _handler->handleUpload(this, _itemFilename, _itemSize - _itemBufferIndex, _itemBuffer, _itemBufferIndex, true);
 
           _itemBufferIndex = 0;
-          _addParam(new AsyncWebParameter(_itemName, _itemFilename, true, true, _itemSize));
+          _addParam(_itemName, _itemFilename, true, true, _itemSize);
         }
 
         free(_itemBuffer);
@@ -942,6 +1407,7 @@ void AsyncWebServerRequest::_parseLine()
     else
     {
       _parseReqHead();
+      _earlyRouting = _server->_routeEarly(this);
       _parseState = PARSE_REQ_HEADERS;
     }
 
@@ -953,18 +1419,27 @@ void AsyncWebServerRequest::_parseLine()
     if (!_temp.length())
     {
       //end of headers
-      _server->_rewriteRequest(this);
-      _server->_attachHandler(this);
-      _removeNotInterestingHeaders();
+      if (!_earlyRouting)
+        _server->_rewriteRequest(this);
 
-      if (_expectingContinue)
+      // Routed early : the headers were already filtered as they arrived
+      if (!_handler)
       {
-        const char * response = "HTTP/1.1 100 Continue\r\n\r\n";
-        //_client->write(response, os_strlen(response));
+        _server->_attachHandler(this);
+        _removeNotInterestingHeaders();
+      }
+
+      // Turn down an unwanted body before promising or reading any of it
+      if ((_contentLength || _expectingContinue || _expectationFailed) && _rejectBody())
+        return;
+
+      if (_expectingContinue)
+      {
+        const char * response = "HTTP/1.1 100 Continue\r\n\r\n";
+        //_client->write(response, os_strlen(response));
         _client->write(response, strlen(response));
       }
 
-      //check handler for authentication
       if (_contentLength)
       {
         _parseState = PARSE_REQ_BODY;
@@ -986,6 +1461,40 @@ void AsyncWebServerRequest::_parseLine()
 
 /////////////////////////////////////////////////
 
+bool AsyncWebServerRequest::_rejectBody()
+{
+  int code = 0;
+
+  if (_expectationFailed)
+    code = 417;
+  else if (_handler)
+    code = _handler->checkBody(this);
+
+  if (!code)
+    return false;
+
+  AWS_LOGDEBUG3("Body rejected: code =", code, ", length =", _contentLength);
+
+  // The body is never read, the response closes the connection
+  _parseState = PARSE_REQ_END;
+
+  if (code == 401)
+    requestAuthentication();
+  else
+    send(code);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
+Stream* AsyncWebServerRequest::body()
+{
+  return (_parseState == PARSE_REQ_END) ? _bodySpool : NULL;
+}
+
+/////////////////////////////////////////////////
+
 size_t AsyncWebServerRequest::headers() const
 {
   return _headers.length();
@@ -995,84 +1504,75 @@ size_t AsyncWebServerRequest::headers() const
 
 bool AsyncWebServerRequest::hasHeader(const String& name) const
 {
-  for (const auto& h : _headers)
-  {
-    if (h->name().equalsIgnoreCase(name))
-    {
-      return true;
-    }
-  }
+  return (_findHeader(name.c_str()) != nullptr);
+}
 
-  return false;
+/////////////////////////////////////////////////
+
+bool AsyncWebServerRequest::hasHeader(const char* name) const
+{
+  return (_findHeader(name) != nullptr);
 }
 
 /////////////////////////////////////////////////
 
 bool AsyncWebServerRequest::hasHeader(const __FlashStringHelper * data) const
 {
-  PGM_P p = reinterpret_cast<PGM_P>(data);
-  size_t n = 0;
-
-  while (1)
-  {
-    if (pgm_read_byte(p + n) == 0)
-      break;
+  return (_findHeader(reinterpret_cast<const char *>(data)) != nullptr);
+}
 
-    n += 1;
-  }
+/////////////////////////////////////////////////
 
-  char * name = (char*) malloc(n + 1);
-  name[n] = 0;
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) const
+{
+  return _findHeader(name.c_str());
+}
 
-  if (name)
-  {
-    for (size_t b = 0; b < n; b++)
-      name[b] = pgm_read_byte(p++);
+/////////////////////////////////////////////////
 
-    bool result = hasHeader( String(name) );
-    free(name);
-    return result;
-  }
-  else
-  {
-    return false;
-  }
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const
+{
+  return _findHeader(name);
 }
 
 /////////////////////////////////////////////////
 
-AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) const
+// Flash is memory mapped on ESP32, the name is read in place instead of copied to the heap
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const __FlashStringHelper * data) const
 {
-  for (const auto& h : _headers)
-  {
-    if (h->name().equalsIgnoreCase(name))
-    {
-      return h;
-    }
-  }
+  return _findHeader(reinterpret_cast<const char *>(data));
+}
 
-  return nullptr;
+/////////////////////////////////////////////////
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(AsyncWebHeaderId id) const
+{
+  return (id < AWS_HEADER_KNOWN) ? _knownHeaders[id] : nullptr;
 }
 
 /////////////////////////////////////////////////
 
-AsyncWebHeader* AsyncWebServerRequest::getHeader(const __FlashStringHelper * data) const
+// Known headers come from their slot, others are compared by hash first. Never allocates.
+AsyncWebHeader* AsyncWebServerRequest::_findHeader(const char* name) const
 {
-  PGM_P p = reinterpret_cast<PGM_P>(data);
-  size_t n = strlen_P(p);
-  char * name = (char*) malloc(n + 1);
+  if (!name)
+    return nullptr;
 
-  if (name)
-  {
-    strcpy_P(name, p);
-    AsyncWebHeader* result = getHeader( String(name));
-    free(name);
-    return result;
-  }
-  else
+  const uint32_t hash = AsyncWebHeader::nameHash(name);
+  const uint8_t id = AsyncWebHeader::knownId(name, hash);
+
+  if (id < AWS_HEADER_KNOWN)
+    return _knownHeaders[id];
+
+  for (const auto& h : _headers)
   {
-    return nullptr;
+    if ((h->hash() == hash) && (strcasecmp(h->name().c_str(), name) == 0))
+    {
+      return h;
+    }
   }
+
+  return nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -1088,6 +1588,8 @@ AsyncWebHeader* AsyncWebServerRequest::getHeader(size_t num) const
 
 size_t AsyncWebServerRequest::params() const
 {
+  _parseQuery();
+
   return _params.length();
 }
 
@@ -1095,6 +1597,8 @@ size_t AsyncWebServerRequest::params() const
 
 bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const
 {
+  _parseQuery();
+
   for (const auto& p : _params)
   {
     if (p->name() == name && p->isPost() == post && p->isFile() == file)
@@ -1134,6 +1638,8 @@ bool AsyncWebServerRequest::hasParam(const __FlashStringHelper * data, bool post
 
 AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) const
 {
+  _parseQuery();
+
   for (const auto& p : _params)
   {
     if (p->name() == name && p->isPost() == post && p->isFile() == file)
@@ -1171,6 +1677,8 @@ AsyncWebParameter* AsyncWebServerRequest::getParam(const __FlashStringHelper * d
 
 AsyncWebParameter* AsyncWebServerRequest::getParam(size_t num) const
 {
+  _parseQuery();
+
   auto param = _params.nth(num);
 
   return (param ? *param : nullptr);
@@ -1186,8 +1694,42 @@ void AsyncWebServerRequest::addInterestingHeader(const String& name)
 
 /////////////////////////////////////////////////
 
+bool AsyncWebServerRequest::defer(ArRequestHandlerFunction fn)
+{
+  if (_deferred || _response || _answered || !fn)
+    return false;
+
+  if (!AsyncWebWorker::_defer(this, fn))
+    return false;
+
+  // The handler may take longer than the client is given to send the request
+  _client->setRxTimeout(0);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServerRequest::send(AsyncWebServerResponse *response)
 {
+  // Called by a deferred handler on its worker, the response is sent later on the async_tcp task
+  if (_deferred)
+  {
+    AsyncWebWorker::_keep(_deferred, response);
+
+    return;
+  }
+
+  if (_answered)
+  {
+    AWS_LOGDEBUG("send: request already answered, response dropped");
+
+    if (response)
+      delete response;
+
+    return;
+  }
+
   _response = response;
 
   if (_response == NULL)
@@ -1205,8 +1747,32 @@ void AsyncWebServerRequest::send(AsyncWebServerResponse *response)
     _response = NULL;
     send(500);
   }
+  else if (_response->_templated() && (AsyncWebHeap::check() != ASYNC_HEAP_NORMAL))
+  {
+    // Each placeholder allocates its value and a cache, not worth the risk below the low heap mark
+    delete response;
+    _response = NULL;
+    AsyncWebHeap::_refused();
+
+    AsyncCannedHeader retry = { "Retry-After", ASYNC_WEB_HEAP_RETRY_AFTER };
+
+    if (_sendCanned(503, &retry, 1))
+      return;
+
+    AsyncWebServerResponse *r = beginResponse(503);
+
+    r->addHeader("Retry-After", ASYNC_WEB_HEAP_RETRY_AFTER);
+    send(r);
+  }
   else
   {
+    if (_capture)
+    {
+      _response->_setCapture(_capture);
+      _capture = NULL;
+    }
+
+    _answered = true;
     _client->setRxTimeout(0);
     _response->_respond(this);
   }
@@ -1226,6 +1792,13 @@ AsyncWebServerResponse * AsyncWebServerRequest::beginResponse(int code, const St
   return new AsyncBasicResponse(code, contentType, content);
 }
 
+/////////////////////////////////////////////////
+
+AsyncWebServerResponse * AsyncWebServerRequest::beginResponse(int code, const String& contentType, String&& content)
+{
+  return new AsyncBasicResponse(code, contentType, std::move(content));
+}
+
 /////////////////////////////////////////////////
 // KH add for favicon
 AsyncWebServerResponse * AsyncWebServerRequest::beginResponse(int code, const String& contentType,
@@ -1295,6 +1868,21 @@ AsyncResponseStream * AsyncWebServerRequest::beginResponseStream(const String& c
   return new AsyncResponseStream(contentType, bufferSize);
 }
 
+/////////////////////////////////////////////////
+
+AsyncResponseStream * AsyncWebServerRequest::beginChunkedResponseStream(const String& contentType)
+{
+  return new AsyncResponseStream(contentType, 0, true);
+}
+
+/////////////////////////////////////////////////
+
+AsyncWebServerResponse * AsyncWebServerRequest::beginMultipartStreamResponse(AsyncFrameSource *source,
+                                                                             const String& partType)
+{
+  return new AsyncMultipartStreamResponse(source, partType);
+}
+
 AsyncWebServerResponse * AsyncWebServerRequest::beginResponse_P(int code, const String& contentType,
                                                                 const uint8_t * content, size_t len,
                                                                 AwsTemplateProcessor callback)
@@ -1328,11 +1916,101 @@ void AsyncWebServerRequest::send(int code, const String& contentType, const char
 
 void AsyncWebServerRequest::send(int code, const String& contentType, const String& content)
 {
+  // Plain status replies (404, 304, 500...) don't need a response object
+  if (!contentType.length() && !content.length() && _sendCanned(code))
+    return;
+
   send(beginResponse(code, contentType, content));
 }
 
 /////////////////////////////////////////////////
 
+void AsyncWebServerRequest::send(int code, const String& contentType, String&& content)
+{
+  send(beginResponse(code, contentType, std::move(content)));
+}
+
+/////////////////////////////////////////////////
+
+// Same bytes and header order as an AsyncBasicResponse without content, serialized on the stack
+// so the TCP stack gets the whole reply in a single add()
+bool AsyncWebServerRequest::_sendCanned(int code, const AsyncCannedHeader* extra, size_t count)
+{
+  static const char cannedVersion0[]     = "HTTP/1.0 ";
+  static const char cannedVersion1[]     = "HTTP/1.1 ";
+  static const char cannedLength[]       = "Content-Length: 0\r\n";
+  static const char cannedConnection[]   = "Connection: close\r\n";
+  static const char cannedAcceptRanges[] = "Accept-Ranges: none\r\n";
+
+  size_t statusLen;
+  const char* status = AsyncWebServerResponse::_statusLine(code, statusLen);
+
+  if (!status || _response || _deferred || _answered)
+    return false;
+
+  const String& defaults = DefaultHeaders::Instance().serialized();
+
+  size_t len = sizeof(cannedVersion1) - 1 + statusLen + sizeof(cannedLength) - 1 + defaults.length()
+               + sizeof(cannedConnection) - 1 + (_version ? sizeof(cannedAcceptRanges) - 1 : 0) + 2;
+
+  for (size_t i = 0; i < count; i++)
+    len += strlen(extra[i].name) + 2 + strlen(extra[i].value) + 2;
+
+  if ((len > ASYNC_WEB_CANNED_SIZE) || (_client->space() < len))
+    return false;
+
+  char buf[ASYNC_WEB_CANNED_SIZE];
+  char* out = buf;
+
+  auto put = [&out](const char* data, size_t size)
+  {
+    memcpy(out, data, size);
+    out += size;
+  };
+
+  put(_version ? cannedVersion1 : cannedVersion0, sizeof(cannedVersion1) - 1);
+  put(status, statusLen);
+  put(cannedLength, sizeof(cannedLength) - 1);
+  put(defaults.c_str(), defaults.length());
+  put(cannedConnection, sizeof(cannedConnection) - 1);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    put(extra[i].name, strlen(extra[i].name));
+    put(": ", 2);
+    put(extra[i].value, strlen(extra[i].value));
+    put("\r\n", 2);
+  }
+
+  if (_version)
+    put(cannedAcceptRanges, sizeof(cannedAcceptRanges) - 1);
+
+  put("\r\n", 2);
+
+  size_t added = _client->add(buf, len);
+
+  // Nothing queued, the caller falls back to a response object
+  if (added == 0)
+    return false;
+
+  _answered = true;
+
+  // A truncated reply can't be completed, the client sees the connection close instead
+  if (added != len)
+  {
+    _client->close(true);
+
+    return true;
+  }
+
+  _client->setRxTimeout(0);
+  _client->send();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServerRequest::send(FS &fs, const String& path, const String& contentType, bool download,
                                  AwsTemplateProcessor callback)
 {
@@ -1399,6 +2077,11 @@ void AsyncWebServerRequest::send_P(int code, const String& contentType, PGM_P co
 
 void AsyncWebServerRequest::redirect(const String& url)
 {
+  AsyncCannedHeader location = { "Location", url.c_str() };
+
+  if (_sendCanned(302, &location, 1))
+    return;
+
   AsyncWebServerResponse * response = beginResponse(302);
 
   response->addHeader("Location", url);
@@ -1476,26 +2159,33 @@ bool AsyncWebServerRequest::authenticate(const char * hash)
 
 void AsyncWebServerRequest::requestAuthentication(const char * realm, bool isDigest)
 {
-  AsyncWebServerResponse * r = beginResponse(401);
+  static const char defaultChallenge[] = "Basic realm=\"Login Required\"";
+
+  String header;
 
   if (!isDigest && realm == NULL)
   {
-    r->addHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
+    // Leave header empty, no need for a copy
   }
   else if (!isDigest)
   {
-    String header = "Basic realm=\"";
+    header = "Basic realm=\"";
     header.concat(realm);
     header.concat("\"");
-    r->addHeader("WWW-Authenticate", header);
   }
   else
   {
-    String header = "Digest ";
+    header = "Digest ";
     header.concat(requestDigestAuthentication(realm));
-    r->addHeader("WWW-Authenticate", header);
   }
 
+  AsyncCannedHeader authenticate = { "WWW-Authenticate", header.length() ? header.c_str() : defaultChallenge };
+
+  if (_sendCanned(401, &authenticate, 1))
+    return;
+
+  AsyncWebServerResponse * r = beginResponse(401);
+  r->addHeader("WWW-Authenticate", authenticate.value);
   send(r);
 }
 
@@ -1503,6 +2193,8 @@ void AsyncWebServerRequest::requestAuthentication(const char * realm, bool isDig
 
 bool AsyncWebServerRequest::hasArg(const char* name) const
 {
+  _parseQuery();
+
   for (const auto& arg : _params)
   {
     if (arg->name() == name)
@@ -1540,6 +2232,8 @@ bool AsyncWebServerRequest::hasArg(const __FlashStringHelper * data) const
 
 const String& AsyncWebServerRequest::arg(const String& name) const
 {
+  _parseQuery();
+
   for (const auto& arg : _params)
   {
     if (arg->name() == name)
@@ -1589,6 +2283,278 @@ const String& AsyncWebServerRequest::argName(size_t i) const
 
 /////////////////////////////////////////////////
 
+static int hexDigit(char c)
+{
+  if ((c >= '0') && (c <= '9'))
+    return c - '0';
+
+  c |= 0x20;
+
+  return ((c >= 'a') && (c <= 'f')) ? (c - 'a' + 10) : -1;
+}
+
+/////////////////////////////////////////////////
+
+// Decoded char at src[i] of a percent encoded string, i moves past it
+static char urlDecodeNext(const char* src, size_t len, size_t& i)
+{
+  const char c = src[i++];
+
+  if ((c == '%') && (i + 1 < len))
+  {
+    const int high = hexDigit(src[i]);
+    const int low = hexDigit(src[i + 1]);
+
+    if ((high >= 0) && (low >= 0))
+    {
+      i += 2;
+
+      return (char) ((high << 4) | low);
+    }
+  }
+
+  return (c == '+') ? ' ' : c;
+}
+
+/////////////////////////////////////////////////
+
+// Copies len chars of src, percent decoded if urlEncoded. Like snprintf(), writes at most size - 1 chars
+// and a NUL to dst and returns the full length.
+static size_t copyValue(const char* src, size_t len, char* dst, size_t size, bool urlEncoded)
+{
+  size_t n = 0;
+
+  for (size_t i = 0; i < len; n++)
+  {
+    const char c = urlEncoded ? urlDecodeNext(src, len, i) : src[i++];
+
+    if (n + 1 < size)
+      dst[n] = c;
+  }
+
+  if (size)
+    dst[(n < size) ? n : (size - 1)] = 0;
+
+  return n;
+}
+
+/////////////////////////////////////////////////
+
+static bool urlDecodeEquals(const char* src, size_t len, const char* name)
+{
+  size_t i = 0;
+
+  while ((i < len) && *name)
+  {
+    if (urlDecodeNext(src, len, i) != *name++)
+      return false;
+  }
+
+  return (i == len) && !*name;
+}
+
+/////////////////////////////////////////////////
+
+// Offset table of the name=value pairs of a query string ('&') or Cookie header ("; ", quoted values), in the arena
+AsyncWebPairRange* AsyncWebServerRequest::_indexPairs(const String& text, bool cookies, int16_t& count)
+{
+  const char separator = cookies ? ';' : '&';
+  const char *p = text.c_str();
+  const size_t len = std::min<size_t>(text.length(), UINT16_MAX);
+  size_t pairs = 1;
+
+  count = 0;
+
+  if (!len)
+    return NULL;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    if (p[i] == separator)
+      pairs++;
+  }
+
+  pairs = std::min<size_t>(pairs, INT16_MAX);
+
+  AsyncWebPairRange *table = (AsyncWebPairRange *) _arena.alloc(pairs * sizeof(AsyncWebPairRange));
+
+  if (!table)
+    return NULL;
+
+  for (size_t start = 0; (start < len) && ((size_t) count < pairs); )
+  {
+    size_t end = start;
+
+    while ((end < len) && (p[end] != separator))
+      end++;
+
+    size_t name = start;
+
+    while (cookies && (name < end) && (p[name] == ' '))
+      name++;
+
+    size_t equal = name;
+
+    while ((equal < end) && (p[equal] != '='))
+      equal++;
+
+    size_t value = (equal < end) ? (equal + 1) : end;
+    size_t valueEnd = end;
+
+    if (cookies && (valueEnd - value >= 2) && (p[value] == '"') && (p[valueEnd - 1] == '"'))
+    {
+      value++;
+      valueEnd--;
+    }
+
+    // Skip empty pairs, like "a=1&&b=2"
+    if (equal > name)
+    {
+      table[count].name = name;
+      table[count].nameLength = equal - name;
+      table[count].value = value;
+      table[count].valueLength = valueEnd - value;
+      count++;
+    }
+
+    start = end + 1;
+  }
+
+  return table;
+}
+
+/////////////////////////////////////////////////
+
+const AsyncWebPairRange* AsyncWebServerRequest::_findQueryArg(const char* name)
+{
+  queryArgs();
+
+  for (int16_t i = 0; i < _queryCount; i++)
+  {
+    if (urlDecodeEquals(_query.c_str() + _queryIndex[i].name, _queryIndex[i].nameLength, name))
+      return &_queryIndex[i];
+  }
+
+  return NULL;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncWebServerRequest::queryArgs()
+{
+  if (_queryCount < 0)
+    _queryIndex = _indexPairs(_query, false, _queryCount);
+
+  return _queryCount;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebServerRequest::hasQueryArg(const char* name)
+{
+  return (_findQueryArg(name) != NULL);
+}
+
+/////////////////////////////////////////////////
+
+int AsyncWebServerRequest::queryArg(const char* name, char* buf, size_t size)
+{
+  const AsyncWebPairRange *arg = _findQueryArg(name);
+
+  if (!arg)
+    return -1;
+
+  return copyValue(_query.c_str() + arg->value, arg->valueLength, buf, size, true);
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncWebServerRequest::queryArg(const char* name)
+{
+  const AsyncWebPairRange *arg = _findQueryArg(name);
+
+  if (!arg)
+    return NULL;
+
+  const size_t len = copyValue(_query.c_str() + arg->value, arg->valueLength, NULL, 0, true);
+  char *value = (char *) _arena.alloc(len + 1);
+
+  if (value)
+    copyValue(_query.c_str() + arg->value, arg->valueLength, value, len + 1, true);
+
+  return value;
+}
+
+/////////////////////////////////////////////////
+
+// Cookie names are case sensitive and their values aren't percent decoded
+const AsyncWebPairRange* AsyncWebServerRequest::_findCookie(const char* name)
+{
+  if (!cookies())
+    return NULL;
+
+  AsyncWebHeader *h = getHeader(AWS_HEADER_COOKIE);
+  const size_t len = strlen(name);
+
+  for (int16_t i = 0; i < _cookieCount; i++)
+  {
+    if ((_cookieIndex[i].nameLength == len) && !memcmp(h->value().c_str() + _cookieIndex[i].name, name, len))
+      return &_cookieIndex[i];
+  }
+
+  return NULL;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncWebServerRequest::cookies()
+{
+  AsyncWebHeader *h = getHeader(AWS_HEADER_COOKIE);
+
+  if (h && (_cookieCount < 0))
+    _cookieIndex = _indexPairs(h->value(), true, _cookieCount);
+
+  return (_cookieCount < 0) ? 0 : _cookieCount;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebServerRequest::hasCookie(const char* name)
+{
+  return (_findCookie(name) != NULL);
+}
+
+/////////////////////////////////////////////////
+
+int AsyncWebServerRequest::cookie(const char* name, char* buf, size_t size)
+{
+  const AsyncWebPairRange *c = _findCookie(name);
+
+  if (!c)
+    return -1;
+
+  return copyValue(getHeader(AWS_HEADER_COOKIE)->value().c_str() + c->value, c->valueLength, buf, size, false);
+}
+
+/////////////////////////////////////////////////
+
+const char* AsyncWebServerRequest::cookie(const char* name)
+{
+  const AsyncWebPairRange *c = _findCookie(name);
+
+  if (!c)
+    return NULL;
+
+  char *value = (char *) _arena.alloc(c->valueLength + 1);
+
+  if (value)
+    copyValue(getHeader(AWS_HEADER_COOKIE)->value().c_str() + c->value, c->valueLength, value, c->valueLength + 1, false);
+
+  return value;
+}
+
+/////////////////////////////////////////////////
+
 const String& AsyncWebServerRequest::pathArg(size_t i) const
 {
   auto param = _pathParams.nth(i);
@@ -1600,7 +2566,7 @@ const String& AsyncWebServerRequest::pathArg(size_t i) const
 
 const String& AsyncWebServerRequest::header(const char* name) const
 {
-  AsyncWebHeader* h = getHeader(String(name));
+  AsyncWebHeader* h = _findHeader(name);
 
   return (h ? h->value() : SharedEmptyString);
 }
@@ -1609,23 +2575,9 @@ const String& AsyncWebServerRequest::header(const char* name) const
 
 const String& AsyncWebServerRequest::header(const __FlashStringHelper * data) const
 {
-  PGM_P p = reinterpret_cast<PGM_P>(data);
-  size_t n = strlen_P(p);
-  char * name = (char*) malloc(n + 1);
-
-  if (name)
-  {
-    strcpy_P(name, p);
-    const String & result = header( (const char *)name );
-    free(name);
+  return header(reinterpret_cast<const char *>(data));
+}
 
-    return result;
-  }
-  else
-  {
-    return SharedEmptyString;
-  }
-};
 /////////////////////////////////////////////////
 
 const String& AsyncWebServerRequest::header(size_t i) const
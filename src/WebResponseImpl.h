@@ -40,6 +40,10 @@
 #endif
 
 #include <vector>
+#include <memory>
+#include <atomic>
+
+#include "AsyncWebSynchronization.h"
 
 // It is possible to restore these defines, but one can use _min and _max instead. Or std::min, std::max.
 
@@ -49,15 +53,21 @@ class AsyncBasicResponse: public AsyncWebServerResponse
 {
   private:
     String _content;
+    const char *_contentCstr;      // RSMOD, not owned
+    String _head;
+    size_t _headOffset;
 
-    char *_contentCstr;      // RSMOD
-    String _partialHeader;
+    void _setContent(size_t len);
+    size_t _send(AsyncWebServerRequest *request);
 
   public:
     AsyncBasicResponse(int code, const String& contentType = String(), const String& content = String());
 
     AsyncBasicResponse(int code, const String& contentType, const char *content = nullptr);     // RSMOD
 
+    // Takes over the content buffer, no copy
+    AsyncBasicResponse(int code, const String& contentType, String&& content);
+
     void _respond(AsyncWebServerRequest *request);
     size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
 
@@ -84,17 +94,34 @@ class AsyncAbstractResponse: public AsyncWebServerResponse
     std::vector<uint8_t> _cache;
     size_t _readDataFromCacheOrContent(uint8_t* data, const size_t len);
     size_t _fillBufferAndProcessTemplates(uint8_t* buf, size_t maxLen);
+    size_t _fillContent(uint8_t* buf, size_t maxLen);
+
+    // Set by _respond() when setCompress() was asked for and the client accepts gzip or deflate
+    AsyncWebDeflate *_deflate;
+    size_t _rawLength;              // Content-Length the body had before compression, 0 if unknown
+    bool _headOnly;                 // HEAD request, the body is never produced
+    bool _hasHeader(const char* name) const;
+    void _beginCompress(AsyncWebServerRequest *request);
+    size_t _fillBufferAndCompress(uint8_t* buf, size_t maxLen);
 
   protected:
     AwsTemplateProcessor _callback;
 
   public:
     AsyncAbstractResponse(AwsTemplateProcessor callback = nullptr);
+    ~AsyncAbstractResponse();
     void _respond(AsyncWebServerRequest *request);
     size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
 
     /////////////////////////////////////////////////
 
+    inline bool _templated() const
+    {
+      return (bool) _callback;
+    }
+
+    /////////////////////////////////////////////////
+
     inline bool _sourceValid() const
     {
       return false;
@@ -118,6 +145,8 @@ class AsyncAbstractResponse: public AsyncWebServerResponse
 
 #define TEMPLATE_PARAM_NAME_LENGTH    32
 
+class AsyncFilePrefetch;
+
 /////////////////////////////////////////////////
 
 class AsyncFileResponse: public AsyncAbstractResponse
@@ -128,6 +157,7 @@ class AsyncFileResponse: public AsyncAbstractResponse
   private:
     File _content;
     String _path;
+    AsyncFilePrefetch *_prefetch;       // Owns the file once read-ahead has started
     void _setContentType(const String& path);
 
   public:
@@ -138,15 +168,20 @@ class AsyncFileResponse: public AsyncAbstractResponse
 
     ~AsyncFileResponse();
 
+    // Read the file ahead in a worker task, depth buffers of ASYNC_FILE_PREFETCH_BUFFER_SIZE.
+    // Not for templates. False if it can't be used, the file is then read synchronously.
+    bool setPrefetch(uint8_t depth);
+
     /////////////////////////////////////////////////
 
     inline bool _sourceValid() const
     {
-      return !!(_content);
+      return _prefetch || !!(_content);
     }
 
     /////////////////////////////////////////////////
 
+    virtual void _respond(AsyncWebServerRequest *request) override;
     virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) override;
 };
 
@@ -246,19 +281,101 @@ class AsyncProgmemResponse: public AsyncAbstractResponse
 
 /////////////////////////////////////////////////
 
-class cbuf;
+// Content is memory-mapped flash (see AsyncAssetImage) that outlives the response, so it is handed
+// to the TCP stack by reference instead of being copied into a RAM buffer for every segment
+class AsyncAssetResponse: public AsyncWebServerResponse
+{
+  private:
+    String _head;
+    size_t _headOffset;
+    const uint8_t * _content;
+
+  public:
+    AsyncAssetResponse(int code, const String& contentType, const uint8_t * content, size_t len);
+
+    void _respond(AsyncWebServerRequest *request);
+    size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
+
+    /////////////////////////////////////////////////
+
+    inline bool _sourceValid() const
+    {
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////
+
+#ifndef ASYNC_RESPONSE_STREAM_SEGMENT_SIZE
+  #define ASYNC_RESPONSE_STREAM_SEGMENT_SIZE      512
+#endif
+
+// Number of free segments kept for reuse by all AsyncResponseStream instances
+#ifndef ASYNC_RESPONSE_STREAM_POOL_SIZE
+  #define ASYNC_RESPONSE_STREAM_POOL_SIZE         8
+#endif
+
+struct AsyncStreamSegment;
+struct AsyncStreamLink;
 
 /////////////////////////////////////////////////
 
+// Producer side of a chunked AsyncResponseStream, for writing from another task. The request
+// deletes the response when the client disconnects or the response is complete, the handle is
+// then detached : write() returns 0 and end() does nothing. Copies share the same stream.
+class AsyncResponseStreamHandle: public Print
+{
+  private:
+    AsyncStreamLink *_link;
+
+  public:
+    AsyncResponseStreamHandle() : _link(NULL) {}
+    explicit AsyncResponseStreamHandle(AsyncStreamLink *link);
+    AsyncResponseStreamHandle(const AsyncResponseStreamHandle& other);
+    AsyncResponseStreamHandle& operator=(const AsyncResponseStreamHandle& other);
+    ~AsyncResponseStreamHandle();
+
+    // False once the response is gone
+    bool attached() const;
+
+    void end();
+    size_t write(const uint8_t *data, size_t len);
+    size_t write(uint8_t data);
+    using Print::write;
+};
+
+/////////////////////////////////////////////////
+
+// Content is kept in a chain of fixed-size segments taken from a shared pool, so growing the
+// stream never moves what was already written, and drained segments go back to the pool at once.
+//
+// By default everything is written before the response is sent, with a Content-Length.
+// A chunked stream (beginChunkedResponseStream()) can be sent right away and written to while
+// the response is in flight, until end() is called. A write or end() while the connection waits
+// for data wakes it. Another task must write through handle(), taken before the response is sent.
 class AsyncResponseStream: public AsyncAbstractResponse, public Print
 {
   private:
-    cbuf *_content;
+    AsyncStreamSegment *_first;
+    AsyncStreamSegment *_last;
+    bool _streaming;
+    bool _ended;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    AsyncStreamLink *_link;                     // Chunked streams, shared with the handles
+    std::atomic<AsyncClient *> _wakeClient { NULL };
+    std::atomic<bool> _waiting { false };       // _fillBuffer() ran dry, the next write wakes the client
+
+    void _wake();
 
   public:
-    AsyncResponseStream(const String& contentType, size_t bufferSize);
+    // bufferSize is kept for compatibility, storage grows by whole segments
+    AsyncResponseStream(const String& contentType, size_t bufferSize, bool chunked = false);
     ~AsyncResponseStream();
 
+    void _respond(AsyncWebServerRequest *request);
+
     /////////////////////////////////////////////////
 
     inline bool _sourceValid() const
@@ -268,10 +385,112 @@ class AsyncResponseStream: public AsyncAbstractResponse, public Print
 
     /////////////////////////////////////////////////
 
+    // Chunked streams only, detached otherwise
+    AsyncResponseStreamHandle handle();
+
+    // Chunked streams only : no more data will be written, the final chunk can be sent
+    void end();
+
     virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) override;
     size_t write(const uint8_t *data, size_t len);
     size_t write(uint8_t data);
     using Print::write;
 };
 
+/////////////////////////////////////////////////
+
+#ifndef ASYNC_MULTIPART_BOUNDARY
+  #define ASYNC_MULTIPART_BOUNDARY      "aws-frame"
+#endif
+
+class AsyncFrameSource;
+struct AsyncFrame;
+
+/////////////////////////////////////////////////
+
+// A response waiting for the next frame, linked into its AsyncFrameSource until it is woken
+struct AsyncFrameWaiter
+{
+  AsyncClient *client;
+  AsyncFrameWaiter *next;
+  bool linked;
+};
+
+/////////////////////////////////////////////////
+
+// Endless multipart/x-mixed-replace body, one part per frame of an AsyncFrameSource. After each
+// frame the newest one is sent, frames published meanwhile are skipped. While there is nothing
+// new the response waits, and the next publish() wakes the connection.
+class AsyncMultipartStreamResponse: public AsyncAbstractResponse
+{
+  private:
+    AsyncFrameSource *_source;
+    String _partType;             // Boundary and Content-Type lines, up to the Content-Length value
+    AsyncFrame *_frame;           // Being sent, with a reference
+    AsyncFrameWaiter _waiter;
+    uint32_t _lastSeq;
+    size_t _partPos;              // In part type + part length + frame + CRLF
+    char _partLength[16];         // Content-Length value and the blank line
+    size_t _partHeadLen;
+    uint32_t _sentFrames;
+    uint32_t _skippedFrames;
+
+  public:
+    AsyncMultipartStreamResponse(AsyncFrameSource *source, const String& partType);
+    ~AsyncMultipartStreamResponse();
+
+    /////////////////////////////////////////////////
+
+    inline bool _sourceValid() const
+    {
+      return _source != NULL;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t sentFrames() const
+    {
+      return _sentFrames;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline uint32_t skippedFrames() const
+    {
+      return _skippedFrames;
+    }
+
+    /////////////////////////////////////////////////
+
+    virtual void _respond(AsyncWebServerRequest *request) override;
+    virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) override;
+};
+
+/////////////////////////////////////////////////
+
+struct AsyncCacheEntry;
+
+// Body, headers and ETag of an AsyncResponseCache entry, the entry is kept alive until sent
+class AsyncCachedResponse: public AsyncAbstractResponse
+{
+  private:
+    std::shared_ptr<AsyncCacheEntry> _entry;
+    size_t _readLength;
+
+  public:
+    AsyncCachedResponse(const std::shared_ptr<AsyncCacheEntry>& entry);
+    ~AsyncCachedResponse();
+
+    /////////////////////////////////////////////////
+
+    inline bool _sourceValid() const
+    {
+      return true;
+    }
+
+    /////////////////////////////////////////////////
+
+    virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) override;
+};
+
 #endif /* ASYNCWEBSERVERRESPONSEIMPL_H_ */
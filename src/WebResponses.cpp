@@ -33,7 +33,10 @@
 #include "AsyncWebServer_ESP32_ENC.h"
 
 #include "WebResponseImpl.h"
-#include "cbuf.h"
+#include "AsyncFilePrefetch.h"
+#include "AsyncFrameSource.h"
+#include "AsyncResponseCache.h"
+#include "AsyncWebWake.h"
 
 /////////////////////////////////////////////////
 
@@ -53,133 +56,106 @@ void* memchr(void* ptr, int ch, size_t count)
 /*
    Abstract Response
  * */
-const char* AsyncWebServerResponse::_responseCodeToString(int code)
-{
-  switch (code)
-  {
-    case 100:
-      return "Continue";
-
-    case 101:
-      return "Switching Protocols";
-
-    case 200:
-      return "OK";
-
-    case 201:
-      return "Created";
-
-    case 202:
-      return "Accepted";
-
-    case 203:
-      return "Non-Authoritative Information";
-
-    case 204:
-      return "No Content";
-
-    case 205:
-      return "Reset Content";
-
-    case 206:
-      return "Partial Content";
-
-    case 300:
-      return "Multiple Choices";
-
-    case 301:
-      return "Moved Permanently";
-
-    case 302:
-      return "Found";
-
-    case 303:
-      return "See Other";
-
-    case 304:
-      return "Not Modified";
 
-    case 305:
-      return "Use Proxy";
-
-    case 307:
-      return "Temporary Redirect";
-
-    case 400:
-      return "Bad Request";
-
-    case 401:
-      return "Unauthorized";
-
-    case 402:
-      return "Payment Required";
-
-    case 403:
-      return "Forbidden";
-
-    case 404:
-      return "Not Found";
-
-    case 405:
-      return "Method Not Allowed";
-
-    case 406:
-      return "Not Acceptable";
-
-    case 407:
-      return "Proxy Authentication Required";
-
-    case 408:
-      return "Request Time-out";
-
-    case 409:
-      return "Conflict";
+typedef struct
+{
+  uint16_t code;
+  uint8_t lineLength;
+  const char* reason;
+  const char* line;
+} AsyncStatusLine;
 
-    case 410:
-      return "Gone";
+// Status line after "HTTP/1.x ", ready to be copied as is. Sorted by code for the binary search.
+#define ASYNC_STATUS_LINE(code, reason)   { code, sizeof(#code " " reason "\r\n") - 1, reason, #code " " reason "\r\n" }
 
-    case 411:
-      return "Length Required";
+static const AsyncStatusLine _statusLines[] =
+{
+  ASYNC_STATUS_LINE(100, "Continue"),
+  ASYNC_STATUS_LINE(101, "Switching Protocols"),
+  ASYNC_STATUS_LINE(200, "OK"),
+  ASYNC_STATUS_LINE(201, "Created"),
+  ASYNC_STATUS_LINE(202, "Accepted"),
+  ASYNC_STATUS_LINE(203, "Non-Authoritative Information"),
+  ASYNC_STATUS_LINE(204, "No Content"),
+  ASYNC_STATUS_LINE(205, "Reset Content"),
+  ASYNC_STATUS_LINE(206, "Partial Content"),
+  ASYNC_STATUS_LINE(300, "Multiple Choices"),
+  ASYNC_STATUS_LINE(301, "Moved Permanently"),
+  ASYNC_STATUS_LINE(302, "Found"),
+  ASYNC_STATUS_LINE(303, "See Other"),
+  ASYNC_STATUS_LINE(304, "Not Modified"),
+  ASYNC_STATUS_LINE(305, "Use Proxy"),
+  ASYNC_STATUS_LINE(307, "Temporary Redirect"),
+  ASYNC_STATUS_LINE(400, "Bad Request"),
+  ASYNC_STATUS_LINE(401, "Unauthorized"),
+  ASYNC_STATUS_LINE(402, "Payment Required"),
+  ASYNC_STATUS_LINE(403, "Forbidden"),
+  ASYNC_STATUS_LINE(404, "Not Found"),
+  ASYNC_STATUS_LINE(405, "Method Not Allowed"),
+  ASYNC_STATUS_LINE(406, "Not Acceptable"),
+  ASYNC_STATUS_LINE(407, "Proxy Authentication Required"),
+  ASYNC_STATUS_LINE(408, "Request Time-out"),
+  ASYNC_STATUS_LINE(409, "Conflict"),
+  ASYNC_STATUS_LINE(410, "Gone"),
+  ASYNC_STATUS_LINE(411, "Length Required"),
+  ASYNC_STATUS_LINE(412, "Precondition Failed"),
+  ASYNC_STATUS_LINE(413, "Request Entity Too Large"),
+  ASYNC_STATUS_LINE(414, "Request-URI Too Large"),
+  ASYNC_STATUS_LINE(415, "Unsupported Media Type"),
+  ASYNC_STATUS_LINE(416, "Requested range not satisfiable"),
+  ASYNC_STATUS_LINE(417, "Expectation Failed"),
+  ASYNC_STATUS_LINE(500, "Internal Server Error"),
+  ASYNC_STATUS_LINE(501, "Not Implemented"),
+  ASYNC_STATUS_LINE(502, "Bad Gateway"),
+  ASYNC_STATUS_LINE(503, "Service Unavailable"),
+  ASYNC_STATUS_LINE(504, "Gateway Time-out"),
+  ASYNC_STATUS_LINE(505, "HTTP Version not supported"),
+  ASYNC_STATUS_LINE(507, "Insufficient Storage"),
+};
+
+#define STATUS_LINES_COUNT    ( sizeof(_statusLines) / sizeof(_statusLines[0]) )
 
-    case 412:
-      return "Precondition Failed";
+/////////////////////////////////////////////////
 
-    case 413:
-      return "Request Entity Too Large";
+static const AsyncStatusLine* _findStatusLine(int code)
+{
+  size_t lo = 0;
+  size_t hi = STATUS_LINES_COUNT;
 
-    case 414:
-      return "Request-URI Too Large";
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2;
 
-    case 415:
-      return "Unsupported Media Type";
+    if (_statusLines[mid].code == code)
+      return &_statusLines[mid];
 
-    case 416:
-      return "Requested range not satisfiable";
+    if (_statusLines[mid].code > code)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
 
-    case 417:
-      return "Expectation Failed";
+  return NULL;
+}
 
-    case 500:
-      return "Internal Server Error";
+/////////////////////////////////////////////////
 
-    case 501:
-      return "Not Implemented";
+const char* AsyncWebServerResponse::_statusLine(int code, size_t& len)
+{
+  const AsyncStatusLine* status = _findStatusLine(code);
 
-    case 502:
-      return "Bad Gateway";
+  len = status ? status->lineLength : 0;
 
-    case 503:
-      return "Service Unavailable";
+  return status ? status->line : NULL;
+}
 
-    case 504:
-      return "Gateway Time-out";
+/////////////////////////////////////////////////
 
-    case 505:
-      return "HTTP Version not supported";
+const char* AsyncWebServerResponse::_responseCodeToString(int code)
+{
+  const AsyncStatusLine* status = _findStatusLine(code);
 
-    default:
-      return "";
-  }
+  return status ? status->reason : "";
 }
 
 /////////////////////////////////////////////////
@@ -199,11 +175,10 @@ AsyncWebServerResponse::AsyncWebServerResponse()
 , _ackedLength(0)
 , _writtenLength(0)
 , _state(RESPONSE_SETUP)
+, _compress(false)
+, _capture(NULL)
 {
-  for (auto header : DefaultHeaders::Instance())
-  {
-    _headers.add(new AsyncWebHeader(header->name(), header->value()));
-  }
+  // DefaultHeaders are not copied here, their serialized form is written with the head
 }
 
 /////////////////////////////////////////////////
@@ -211,6 +186,56 @@ AsyncWebServerResponse::AsyncWebServerResponse()
 AsyncWebServerResponse::~AsyncWebServerResponse()
 {
   _headers.free();
+
+  delete _capture;
+}
+
+/////////////////////////////////////////////////
+
+// Only meant for the client the response is sent to
+static bool _privateHeader(const AsyncWebHeader *header)
+{
+  if (header->name().equalsIgnoreCase("Set-Cookie") || header->name().equalsIgnoreCase("Set-Cookie2"))
+    return true;
+
+  if (!header->name().equalsIgnoreCase("Cache-Control"))
+    return false;
+
+  String value = header->value();
+  value.toLowerCase();
+
+  return (value.indexOf("no-store") >= 0) || (value.indexOf("private") >= 0);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServerResponse::_setCapture(AsyncCacheCapture* capture)
+{
+  delete _capture;
+  _capture = NULL;
+
+  bool cacheable = (_code == 200);
+
+  for (const auto& header : _headers)
+    cacheable = cacheable && !_privateHeader(header);
+
+  if (!cacheable)
+  {
+    delete capture;
+
+    return;
+  }
+
+  capture->setResponse(_code, _contentType, _compress);
+
+  for (const auto& header : _headers)
+  {
+    // Added again by the response sending the entry
+    if (!header->name().equalsIgnoreCase("Connection") && !header->name().equalsIgnoreCase("ETag"))
+      capture->addHeader(header->name(), header->value());
+  }
+
+  _capture = capture;
 }
 
 /////////////////////////////////////////////////
@@ -244,8 +269,32 @@ void AsyncWebServerResponse::addHeader(const String& name, const String& value)
 
 /////////////////////////////////////////////////
 
-String AsyncWebServerResponse::_assembleHead(uint8_t version)
+// Decimal digits of value into buf (at least 20 chars), returns the length
+static size_t _sizeToDec(size_t value, char* buf)
+{
+  char tmp[20];
+  size_t len = 0;
+
+  do
+  {
+    tmp[len++] = '0' + (value % 10);
+    value /= 10;
+  } while (value);
+
+  for (size_t i = 0; i < len; i++)
+    buf[i] = tmp[len - 1 - i];
+
+  return len;
+}
+
+/////////////////////////////////////////////////
+
+// Add the protocol headers and compute the exact head length, once
+size_t AsyncWebServerResponse::_prepareHead(uint8_t version)
 {
+  if (_headLength)
+    return _headLength;
+
   if (version)
   {
     addHeader("Accept-Ranges", "none");
@@ -254,35 +303,122 @@ String AsyncWebServerResponse::_assembleHead(uint8_t version)
       addHeader("Transfer-Encoding", "chunked");
   }
 
-  String out = String();
-  int bufSize = 300;
-  char buf[bufSize];
+  const AsyncStatusLine* status = _findStatusLine(_code);
+
+  // "HTTP/1.x " + status line, unknown codes as "nnn \r\n"
+  size_t len = 9 + (status ? status->lineLength : 6);
+
+  if (_sendContentLength)
+  {
+    char digits[20];
+    len += 16 + _sizeToDec(_contentLength, digits) + 2;
+  }
+
+  if (_contentType.length())
+    len += 14 + _contentType.length() + 2;
+
+  len += DefaultHeaders::Instance().serialized().length();
+
+  for (const auto& header : _headers)
+    len += header->name().length() + 2 + header->value().length() + 2;
+
+  _headLength = len + 2;
+
+  return _headLength;
+}
+
+/////////////////////////////////////////////////
+
+template<typename Sink>
+void AsyncWebServerResponse::_serializeHead(uint8_t version, Sink sink)
+{
+  const AsyncStatusLine* status = _findStatusLine(_code);
+
+  char buf[20];
+
+  sink("HTTP/1.", 7);
+  buf[0] = '0' + version;
+  buf[1] = ' ';
+  sink(buf, 2);
 
-  snprintf(buf, bufSize, "HTTP/1.%d %d %s\r\n", version, _code, _responseCodeToString(_code));
-  out.concat(buf);
+  if (status)
+  {
+    sink(status->line, status->lineLength);
+  }
+  else
+  {
+    buf[0] = '0' + (_code / 100) % 10;
+    buf[1] = '0' + (_code / 10) % 10;
+    buf[2] = '0' + _code % 10;
+    buf[3] = ' ';
+    buf[4] = '\r';
+    buf[5] = '\n';
+    sink(buf, 6);
+  }
 
   if (_sendContentLength)
   {
-    snprintf(buf, bufSize, "Content-Length: %d\r\n", _contentLength);
-    out.concat(buf);
+    sink("Content-Length: ", 16);
+    sink(buf, _sizeToDec(_contentLength, buf));
+    sink("\r\n", 2);
   }
 
   if (_contentType.length())
   {
-    snprintf(buf, bufSize, "Content-Type: %s\r\n", _contentType.c_str());
-    out.concat(buf);
+    sink("Content-Type: ", 14);
+    sink(_contentType.c_str(), _contentType.length());
+    sink("\r\n", 2);
   }
 
+  const String& defaults = DefaultHeaders::Instance().serialized();
+
+  if (defaults.length())
+    sink(defaults.c_str(), defaults.length());
+
   for (const auto& header : _headers)
   {
-    snprintf(buf, bufSize, "%s: %s\r\n", header->name().c_str(), header->value().c_str());
-    out.concat(buf);
+    sink(header->name().c_str(), header->name().length());
+    sink(": ", 2);
+    sink(header->value().c_str(), header->value().length());
+    sink("\r\n", 2);
   }
 
   _headers.free();
 
-  out.concat("\r\n");
-  _headLength = out.length();
+  sink("\r\n", 2);
+}
+
+/////////////////////////////////////////////////
+
+// Write exactly _prepareHead(version) bytes into dst, no terminating NUL
+void AsyncWebServerResponse::_writeHead(char* dst, uint8_t version)
+{
+  _prepareHead(version);
+
+  _serializeHead(version, [&dst](const char* data, size_t len)
+  {
+    memcpy(dst, data, len);
+    dst += len;
+  });
+}
+
+/////////////////////////////////////////////////
+
+String AsyncWebServerResponse::_assembleHead(uint8_t version)
+{
+  String out;
+
+  if (!out.reserve(_prepareHead(version)))
+  {
+    AWS_LOGERROR1(F("[AsyncWebServerResponse::_assembleHead] reserve failed, size ="), _headLength);
+
+    return out;
+  }
+
+  _serializeHead(version, [&out](const char* data, size_t len)
+  {
+    out.concat(data, len);
+  });
 
   return out;
 }
@@ -317,6 +453,13 @@ bool AsyncWebServerResponse::_sourceValid() const
 
 /////////////////////////////////////////////////
 
+bool AsyncWebServerResponse::_templated() const
+{
+  return false;
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServerResponse::_respond(AsyncWebServerRequest *request)
 {
   _state = RESPONSE_END;
@@ -340,44 +483,43 @@ size_t AsyncWebServerResponse::_ack(AsyncWebServerRequest *request, size_t len,
    String/Code Response
  * */
 AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const char *content)
+  : _contentCstr(content), _headOffset(0)    // RSMOD
 {
   _code = code;
-  _content = String("");
-  _contentCstr = (char *)content;    // RSMOD
   _contentType = contentType;
-  _partialHeader = String();
 
-  int iLen;
+  _setContent(_contentCstr ? strlen(_contentCstr) : 0);
+}
 
-  if ((iLen = strlen(_contentCstr)))
-  {
-    _contentLength = iLen;
+/////////////////////////////////////////////////
 
-    if (!_contentType.length())
-      _contentType = "text/plain";
-  }
+AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const String& content)
+  : _content(content), _contentCstr(nullptr), _headOffset(0)
+{
+  _code = code;
+  _contentType = contentType;
 
-  addHeader("Connection", "close");
+  _setContent(_content.length());
 }
 
 /////////////////////////////////////////////////
 
-/*
-   String/Code Response
- * */
-AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const String& content)
+AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, String&& content)
+  : _content(std::move(content)), _contentCstr(nullptr), _headOffset(0)
 {
   _code = code;
-  _content = content;
+  _contentType = contentType;
 
-  _contentCstr = nullptr;        // RSMOD
+  _setContent(_content.length());
+}
 
-  _contentType = contentType;
-  _partialHeader = String();
+/////////////////////////////////////////////////
 
-  if (_content.length())
+void AsyncBasicResponse::_setContent(size_t len)
+{
+  if (len)
   {
-    _contentLength = _content.length();
+    _contentLength = len;
 
     if (!_contentType.length())
       _contentType = "text/plain";
@@ -391,117 +533,90 @@ AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, cons
 void AsyncBasicResponse::_respond(AsyncWebServerRequest *request)
 {
   _state = RESPONSE_HEADERS;
-  String out = _assembleHead(request->version());
-  size_t outLen = out.length();
-  size_t space = request->client()->space();
-
-  AWS_LOGDEBUG3("AsyncBasicResponse::_respond : Pre_respond, _contentLength =", _contentLength, ", out =", out );
-  AWS_LOGDEBUG3("outLen =", outLen, ", _contentCstr =", _contentCstr);
+  _head = _assembleHead(request->version());
 
-  if (!_contentLength && space >= outLen)
-  {
-    AWS_LOGDEBUG("Step 1");
+  AWS_LOGDEBUG3("AsyncBasicResponse::_respond : _contentLength =", _contentLength, ", head =", _head);
 
-    _writtenLength += request->client()->write(out.c_str(), outLen);
-    _state = RESPONSE_WAIT_ACK;
-  }
-  else if (_contentLength && space >= outLen + _contentLength)
+  if (_head.length() != _headLength)
   {
-    AWS_LOGDEBUG("Step 2");
-
-    if (_contentCstr)
-    {
-      _content = String(
-                   _contentCstr);    // short _contentCstr - so just send as Arduino String - not much of a penalty - fall into below
-    }
+    AWS_LOGERROR("AsyncBasicResponse::_respond: Out of heap");
 
-    out += _content;
-    outLen += _contentLength;
-    _writtenLength += request->client()->write(out.c_str(), outLen);
+    _state = RESPONSE_FAILED;
+    request->client()->close();
 
-    _state = RESPONSE_WAIT_ACK;
+    return;
   }
-  else if (space && space < outLen)
+
+  if (_capture)
   {
-    String partial = out.substring(0, space);
+    _capture->append((const uint8_t*) (_contentCstr ? _contentCstr : _content.c_str()), _contentLength);
+    _capture->complete();
+  }
 
-    AWS_LOGDEBUG("Step 3");
+  if (request->method() == HTTP_HEAD)
+  {
+    // Content-Length is already in the head, there is no body to send
+    _sentLength = _contentLength;
+    _content = String();
+  }
 
-    if (_contentCstr)
-    {
-      _partialHeader = out.substring(space);
-    }
-    else
-    {
-      _content = out.substring(space) + _content;
-      _contentLength += outLen - space;
-    }
+  _state = RESPONSE_CONTENT;
+  _send(request);
+}
 
-    AWS_LOGDEBUG1("partial =", partial);
+/////////////////////////////////////////////////
 
-    _writtenLength += request->client()->write(partial.c_str(), partial.length());
+// Send as much of the head, then of the content, as fits. Both are added to the same TCP write and pushed with
+// a single send(). Progress is kept as offsets, the content is never split or copied into temporary Strings.
+size_t AsyncBasicResponse::_send(AsyncWebServerRequest *request)
+{
+  AsyncClient* client = request->client();
+  size_t space = client->space();
+  size_t written = 0;
 
-    _state = RESPONSE_CONTENT;
-  }
-  else if (space > outLen && space < (outLen + _contentLength))
+  if (_headOffset < _headLength)
   {
-    size_t shift = space - outLen;
-
-    AWS_LOGDEBUG("Step 4");
+    size_t outLen = std::min(space, _headLength - _headOffset);
 
-    outLen += shift;
-    _sentLength += shift;
-
-    if (_contentCstr)
+    if (outLen)
     {
-      char *s = (char *)malloc(shift + 1);
-
-      if (s != nullptr)
-      {
-        strncpy(s, _contentCstr, shift);
-        s[shift] = '\0';
-        out += String(s);
-        _contentCstr += shift;
+      outLen = client->add(_head.c_str() + _headOffset, outLen);
+      _headOffset += outLen;
+      space -= outLen;
+      written += outLen;
+    }
 
-        free(s);
-      }
-      else
-      {
-        AWS_LOGERROR("AsyncBasicResponse::_respond: Out of heap");
+    if (_headOffset == _headLength)
+      _head = String();
+  }
 
-        return;
-      }
-    }
-    else
-    {
-      out += _content.substring(0, shift);
-      _content = _content.substring(shift);
-    }
+  if (_headOffset == _headLength && _sentLength < _contentLength && space)
+  {
+    const char* content = _contentCstr ? _contentCstr : _content.c_str();
+    size_t outLen = std::min(space, _contentLength - _sentLength);
 
-    AWS_LOGDEBUG1("out =", out);
+    // Copied by the stack : the content may not outlive a closed connection's pending segments
+    outLen = client->add(content + _sentLength, outLen);
+    _sentLength += outLen;
+    written += outLen;
 
-    _writtenLength += request->client()->write(out.c_str(), outLen);
-    _state = RESPONSE_CONTENT;
+    // Everything is in the stack's buffers now
+    if (_sentLength == _contentLength && !_contentCstr)
+      _content = String();
   }
-  else
+
+  if (written)
   {
-    AWS_LOGDEBUG("Step 5");
+    client->send();
+    _writtenLength += written;
+  }
 
-    if (_contentCstr)
-    {
-      _partialHeader = out;
-    }
-    else
-    {
-      _content = out + _content;
-      _contentLength += outLen;
-    }
+  if (_headOffset == _headLength && _sentLength == _contentLength)
+    _state = RESPONSE_WAIT_ACK;
 
-    _state = RESPONSE_CONTENT;
-  }
+  AWS_LOGDEBUG3("AsyncBasicResponse::_send : written =", written, ", _sentLength =", _sentLength);
 
-  AWS_LOGDEBUG3("AsyncBasicResponse::_respond : Post_respond, _contentLength =", _contentLength, ", out =", out );
-  AWS_LOGDEBUG3("outLen =", outLen, ", _contentCstr =", _contentCstr);
+  return written;
 }
 
 /////////////////////////////////////////////////
@@ -510,143 +625,125 @@ size_t AsyncBasicResponse::_ack(AsyncWebServerRequest *request, size_t len, uint
 {
   ESP32_ENC_AWS_UNUSED(time);
 
-  AWS_LOGDEBUG1("AsyncBasicResponse::_ack : Pre_ack, _contentLength =", _contentLength);
-
   _ackedLength += len;
 
   if (_state == RESPONSE_CONTENT)
   {
-    String out;
-    size_t available = _contentLength - _sentLength;
-    size_t space = request->client()->space();
-
-    if (_partialHeader.length() > 0)
+    return _send(request);
+  }
+  else if (_state == RESPONSE_WAIT_ACK)
+  {
+    if (_ackedLength >= _writtenLength)
     {
-      if (_partialHeader.length() > space)
-      {
-        // Header longer than space - send a piece of it, and make the _partialHeader = to what remains
-        String _subHeader;
-        String tmpString;
-
-        _subHeader = _partialHeader.substring(0, space);
-        tmpString = _partialHeader.substring(space);
-        _partialHeader = tmpString;
+      _state = RESPONSE_END;
+    }
+  }
 
-        _writtenLength += request->client()->write(_subHeader.c_str(), space);
+  return 0;
+}
 
-        return (_partialHeader.length());
-      }
-      else
-      {
-        // _partialHeader is <= space length - therefore send the whole thing, and make the remaining length = to the _contrentLength
-        _writtenLength += request->client()->write(_partialHeader.c_str(), _partialHeader.length());
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
 
-        _partialHeader = String();
+/*
+   Abstract Response
+ * */
 
-        return (_contentLength);
-      }
-    }
+AsyncAbstractResponse::AsyncAbstractResponse(AwsTemplateProcessor callback): _deflate(NULL), _rawLength(0), _headOnly(false), _callback(callback)
+{
+  // In case of template processing, we're unable to determine real response size
+  if (callback)
+  {
+    _contentLength = 0;
+    _sendContentLength = false;
+    _chunked = true;
+  }
+}
 
-    // if we are here - there is no _partialHJeader to send
+/////////////////////////////////////////////////
 
-    AWS_LOGDEBUG3("AsyncBasicResponse::_ack : available =", available, ", space =", space );
+AsyncAbstractResponse::~AsyncAbstractResponse()
+{
+  if (_deflate)
+  {
+    AWS_LOGDEBUG3("[AsyncAbstractResponse] deflate in =", _deflate->totalIn(), ", out =", _deflate->totalOut());
 
-    //we can fit in this packet
-    if (space > available)
-    {
-      AWS_LOGDEBUG1("AsyncBasicResponse::_ack : Pre_ack, _contentLength =", _contentLength);
+    delete _deflate;
+  }
+}
 
-      if (_contentCstr)
-      {
-        AWS_LOGDEBUG1("In space>available : output =", _contentCstr);
+/////////////////////////////////////////////////
 
-        _writtenLength += request->client()->write(_contentCstr, available);
-        //_contentCstr[0] = '\0';
-      }
-      else
-      {
-        _writtenLength += request->client()->write(_content.c_str(), available);
-        _content = String();
-      }
+bool AsyncAbstractResponse::_hasHeader(const char* name) const
+{
+  for (const auto& h : _headers)
+  {
+    if (h->name().equalsIgnoreCase(name))
+      return true;
+  }
 
-      _state = RESPONSE_WAIT_ACK;
+  return false;
+}
 
-      return available;
-    }
+/////////////////////////////////////////////////
 
-    //send some data, the rest on ack
-    if (_contentCstr)
-    {
-      char *s = (char *)malloc(space + 1);
+// Compressed bodies go out chunked, so this needs HTTP/1.1 and a body that isn't encoded already
+void AsyncAbstractResponse::_beginCompress(AsyncWebServerRequest *request)
+{
+  const AsyncWebEncoding encoding = AsyncWebDeflate::select(request->acceptEncoding());
 
-      if (s != nullptr)
-      {
-        strncpy(s, _contentCstr, space);
-        s[space] = '\0';
-        out = String(s);
-        _contentCstr += space;
+  if ( (encoding == ASYNC_ENCODING_NONE) || !request->version() || (_code == 204) || (_code == 304)
+       || (_sendContentLength && (_contentLength < ASYNC_DEFLATE_MIN_LENGTH)) || _hasHeader("Content-Encoding") )
+  {
+    return;
+  }
 
-        free(s);
-      }
-      else
-      {
-        AWS_LOGERROR("AsyncBasicResponse::_ack: Out of heap");
+  // HEAD gets the same headers as GET, without a compressor that would never run
+  if (!_headOnly)
+  {
+    _deflate = new AsyncWebDeflate();
 
-        return 0;
-      }
-    }
-    else
+    if (!_deflate->begin(encoding))
     {
-      out = _content.substring(0, space);
-      _content = _content.substring(space);
-    }
-
-    _sentLength += space;
-
-    AWS_LOGDEBUG1("In space>available : output =", out);
+      // Out of memory, send it as is
+      delete _deflate;
+      _deflate = NULL;
 
-    _writtenLength += request->client()->write(out.c_str(), space);
-
-    return space;
-  }
-  else if (_state == RESPONSE_WAIT_ACK)
-  {
-    if (_ackedLength >= _writtenLength)
-    {
-      _state = RESPONSE_END;
+      return;
     }
   }
 
-  AWS_LOGDEBUG3("AsyncBasicResponse::_ack : Post_ack, _contentLength =", _contentLength, ", _contentCstr =",
-                _contentCstr);
+  // A known length still bounds how much is read from the source
+  _rawLength = _sendContentLength ? _contentLength : 0;
+  _sendContentLength = false;
+  _chunked = true;
 
-  return 0;
+  addHeader("Content-Encoding", AsyncWebDeflate::name(encoding));
+  addHeader("Vary", "Accept-Encoding");
 }
 
 /////////////////////////////////////////////////
-/////////////////////////////////////////////////
-
-/*
-   Abstract Response
- * */
 
-AsyncAbstractResponse::AsyncAbstractResponse(AwsTemplateProcessor callback): _callback(callback)
+void AsyncAbstractResponse::_respond(AsyncWebServerRequest *request)
 {
-  // In case of template processing, we're unable to determine real response size
-  if (callback)
-  {
-    _contentLength = 0;
-    _sendContentLength = false;
-    _chunked = true;
-  }
-}
+  _headOnly = (request->method() == HTTP_HEAD);
 
-/////////////////////////////////////////////////
+  // Short on heap : no compressor, and _ack() sends from smaller buffers
+  const bool lowHeap = (AsyncWebHeap::check() != ASYNC_HEAP_NORMAL);
+
+  if (lowHeap)
+    AsyncWebHeap::_degraded();
+
+  if (_compress && !lowHeap)
+    _beginCompress(request);
 
-void AsyncAbstractResponse::_respond(AsyncWebServerRequest *request)
-{
   addHeader("Connection", "close");
-  _head = _assembleHead(request->version());
+  // The head is normally serialized straight into the first send buffer, see _ack()
+  _prepareHead(request->version());
+
+  if (_headOnly)
+    _head = _assembleHead(request->version());
+
   _state = RESPONSE_HEADERS;
   _ack(request, 0, 0);
 }
@@ -668,12 +765,29 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
   size_t space = request->client()->space();
 
   size_t headLen = _head.length();
+  bool headDirect = false;
 
   if (_state == RESPONSE_HEADERS)
   {
+    if (!headLen && space >= _headLength)
+    {
+      headLen = _headLength;
+      headDirect = true;
+    }
+    else if (!headLen)
+    {
+      // Not enough room for the whole head, keep it as a String and send it in pieces
+      _head = _assembleHead(request->version());
+      headLen = _head.length();
+    }
+
     if (space >= headLen)
     {
-      _state = RESPONSE_CONTENT;
+      // A head written straight into the send buffer is only under way once that buffer is filled,
+      // until then an early return leaves it to the next _ack()
+      if (!headDirect)
+        _state = RESPONSE_CONTENT;
+
       space -= headLen;
     }
     else
@@ -685,8 +799,30 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       return out.length();
     }
   }
+  else if (headLen && (_state == RESPONSE_CONTENT))
+  {
+    // Head kept back by a RESPONSE_TRY_AGAIN, it goes out in front of the first content
+    if (space < headLen)
+      return 0;
+
+    space -= headLen;
+  }
 
-  if (_state == RESPONSE_CONTENT)
+  if ((_state == RESPONSE_CONTENT) && _headOnly)
+  {
+    // HEAD : the head is all there is, _fillBuffer() is never called
+    if (headLen)
+    {
+      _writtenLength += request->client()->write(_head.c_str(), headLen);
+      _head = String();
+    }
+
+    _state = RESPONSE_WAIT_ACK;
+
+    return headLen;
+  }
+
+  if ((_state == RESPONSE_CONTENT) || headDirect)
   {
     size_t outLen;
 
@@ -708,6 +844,9 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       outLen = ((_contentLength - _sentLength) > space) ? space : (_contentLength - _sentLength);
     }
 
+    if ((AsyncWebHeap::mode() != ASYNC_HEAP_NORMAL) && (outLen > ASYNC_WEB_HEAP_LOW_BUFFER))
+      outLen = ASYNC_WEB_HEAP_LOW_BUFFER;
+
     uint8_t *buf = (uint8_t *)malloc(outLen + headLen);
 
     if (!buf)
@@ -717,7 +856,12 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       return 0;
     }
 
-    if (headLen)
+    if (headDirect)
+    {
+      _writeHead((char*) buf, request->version());
+      _state = RESPONSE_CONTENT;
+    }
+    else if (headLen)
     {
       memcpy(buf, _head.c_str(), _head.length());
     }
@@ -728,15 +872,20 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
     {
       // HTTP 1.1 allows leading zeros in chunk length. Or spaces may be added.
       // See RFC2616 sections 2, 3.6.1.
-      readLen = _fillBufferAndProcessTemplates(buf + headLen + 6, outLen - 8);
+      readLen = _deflate ? _fillBufferAndCompress(buf + headLen + 6, outLen - 8)
+                : _fillContent(buf + headLen + 6, outLen - 8);
 
       if (readLen == RESPONSE_TRY_AGAIN)
       {
+        // Keep a directly written head for the next attempt, _headers are gone by now
+        if (headDirect)
+          _head.concat((const char*) buf, headLen);
+
         free(buf);
         return 0;
       }
 
-      outLen = sprintf((char*)buf + headLen, "%x", readLen) + headLen;
+      outLen = sprintf((char*)buf + headLen, "%x", (unsigned int) readLen) + headLen;
 
       while (outLen < headLen + 4)
         buf[outLen++] = ' ';
@@ -749,10 +898,14 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
     }
     else
     {
-      readLen = _fillBufferAndProcessTemplates(buf + headLen, outLen);
+      readLen = _fillContent(buf + headLen, outLen);
 
       if (readLen == RESPONSE_TRY_AGAIN)
       {
+        // Keep a directly written head for the next attempt, _headers are gone by now
+        if (headDirect)
+          _head.concat((const char*) buf, headLen);
+
         free(buf);
         return 0;
       }
@@ -784,6 +937,9 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
     if ((_chunked && readLen == 0) || (!_sendContentLength && outLen == 0) || (!_chunked && _sentLength == _contentLength))
     {
       _state = RESPONSE_WAIT_ACK;
+
+      if (_capture)
+        _capture->complete();
     }
 
     return outLen;
@@ -825,6 +981,50 @@ size_t AsyncAbstractResponse::_readDataFromCacheOrContent(uint8_t* data, const s
 
 /////////////////////////////////////////////////
 
+// Raw content is read straight into the compressor's window, compressed output is drained into buf
+size_t AsyncAbstractResponse::_fillBufferAndCompress(uint8_t* buf, size_t maxLen)
+{
+  size_t outLen = _deflate->read(buf, maxLen);
+
+  while ( (outLen < maxLen) && !_deflate->done() )
+  {
+    size_t room;
+    uint8_t* in = _deflate->inputBuffer(room);
+
+    if (_rawLength && (room > _rawLength - _deflate->totalIn()))
+      room = _rawLength - _deflate->totalIn();
+
+    const size_t readLen = room ? _fillContent(in, room) : 0;
+
+    if (readLen == RESPONSE_TRY_AGAIN)
+      return outLen ? outLen : RESPONSE_TRY_AGAIN;
+
+    if (readLen)
+      _deflate->commit(readLen);
+    else
+      _deflate->finish();
+
+    outLen += _deflate->read(buf + outLen, maxLen - outLen);
+  }
+
+  return outLen;
+}
+
+/////////////////////////////////////////////////
+
+// The uncompressed, template processed body, also copied for the response cache
+size_t AsyncAbstractResponse::_fillContent(uint8_t* data, size_t len)
+{
+  const size_t readLen = _fillBufferAndProcessTemplates(data, len);
+
+  if (_capture && (readLen != RESPONSE_TRY_AGAIN))
+    _capture->append(data, readLen);
+
+  return readLen;
+}
+
+/////////////////////////////////////////////////
+
 size_t AsyncAbstractResponse::_fillBufferAndProcessTemplates(uint8_t* data, size_t len)
 {
   if (!_callback)
@@ -851,7 +1051,7 @@ size_t AsyncAbstractResponse::_fillBufferAndProcessTemplates(uint8_t* data, size
     if (pTemplateEnd)
     {
       // prepare argument to callback
-      const size_t paramNameLength = std::min(sizeof(buf) - 1, (unsigned int)(pTemplateEnd - pTemplateStart - 1));
+      const size_t paramNameLength = std::min<size_t>(sizeof(buf) - 1, pTemplateEnd - pTemplateStart - 1);
 
       if (paramNameLength)
       {
@@ -968,58 +1168,37 @@ size_t AsyncAbstractResponse::_fillBufferAndProcessTemplates(uint8_t* data, size
 
 AsyncFileResponse::~AsyncFileResponse()
 {
+  if (_prefetch)
+    _prefetch->release();
+
   if (_content)
     _content.close();
 }
 
 /////////////////////////////////////////////////
 
+bool AsyncFileResponse::setPrefetch(uint8_t depth)
+{
+  // Templates may need to push data back, which doesn't mix with RESPONSE_TRY_AGAIN
+  if (_prefetch || _callback || _started())
+    return false;
+
+  _prefetch = AsyncFilePrefetch::start(_content, depth);
+
+  return (_prefetch != NULL);
+}
+
+/////////////////////////////////////////////////
+
 void AsyncFileResponse::_setContentType(const String& path)
 {
-  if (path.endsWith(".html"))
-    _contentType = "text/html";
-  else if (path.endsWith(".htm"))
-    _contentType = "text/html";
-  else if (path.endsWith(".css"))
-    _contentType = "text/css";
-  else if (path.endsWith(".json"))
-    _contentType = "application/json";
-  else if (path.endsWith(".js"))
-    _contentType = "application/javascript";
-  else if (path.endsWith(".png"))
-    _contentType = "image/png";
-  else if (path.endsWith(".gif"))
-    _contentType = "image/gif";
-  else if (path.endsWith(".jpg"))
-    _contentType = "image/jpeg";
-  else if (path.endsWith(".ico"))
-    _contentType = "image/x-icon";
-  else if (path.endsWith(".svg"))
-    _contentType = "image/svg+xml";
-  else if (path.endsWith(".eot"))
-    _contentType = "font/eot";
-  else if (path.endsWith(".woff"))
-    _contentType = "font/woff";
-  else if (path.endsWith(".woff2"))
-    _contentType = "font/woff2";
-  else if (path.endsWith(".ttf"))
-    _contentType = "font/ttf";
-  else if (path.endsWith(".xml"))
-    _contentType = "text/xml";
-  else if (path.endsWith(".pdf"))
-    _contentType = "application/pdf";
-  else if (path.endsWith(".zip"))
-    _contentType = "application/zip";
-  else if (path.endsWith(".gz"))
-    _contentType = "application/x-gzip";
-  else
-    _contentType = "text/plain";
+  _contentType = AsyncWebMimeTypes::lookup(path);
 }
 
 /////////////////////////////////////////////////
 
 AsyncFileResponse::AsyncFileResponse(FS &fs, const String& path, const String& contentType, bool download,
-                                     AwsTemplateProcessor callback): AsyncAbstractResponse(callback)
+                                     AwsTemplateProcessor callback): AsyncAbstractResponse(callback), _prefetch(NULL)
 {
   _code = 200;
   _path = path;
@@ -1057,12 +1236,16 @@ AsyncFileResponse::AsyncFileResponse(FS &fs, const String& path, const String& c
   }
 
   addHeader("Content-Disposition", buf);
+
+#if (ASYNC_FILE_PREFETCH_DEPTH > 0)
+  setPrefetch(ASYNC_FILE_PREFETCH_DEPTH);
+#endif
 }
 
 /////////////////////////////////////////////////
 
 AsyncFileResponse::AsyncFileResponse(File content, const String& path, const String& contentType, bool download,
-                                     AwsTemplateProcessor callback): AsyncAbstractResponse(callback)
+                                     AwsTemplateProcessor callback): AsyncAbstractResponse(callback), _prefetch(NULL)
 {
   _code = 200;
   _path = path;
@@ -1097,12 +1280,29 @@ AsyncFileResponse::AsyncFileResponse(File content, const String& path, const Str
   }
 
   addHeader("Content-Disposition", buf);
+
+#if (ASYNC_FILE_PREFETCH_DEPTH > 0)
+  setPrefetch(ASYNC_FILE_PREFETCH_DEPTH);
+#endif
+}
+
+/////////////////////////////////////////////////
+
+void AsyncFileResponse::_respond(AsyncWebServerRequest *request)
+{
+  if (_prefetch)
+    _prefetch->setClient(request->client());
+
+  AsyncAbstractResponse::_respond(request);
 }
 
 /////////////////////////////////////////////////
 
 size_t AsyncFileResponse::_fillBuffer(uint8_t *data, size_t len)
 {
+  if (_prefetch)
+    return _prefetch->read(data, len);
+
   return _content.read(data, len);
 }
 
@@ -1243,47 +1443,476 @@ size_t AsyncProgmemResponse::_fillBuffer(uint8_t *data, size_t len)
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 
+/*
+   Asset Response (memory-mapped content, sent without copy)
+ * */
+
+AsyncAssetResponse::AsyncAssetResponse(int code, const String& contentType, const uint8_t * content, size_t len)
+  : _headOffset(0), _content(content)
+{
+  _code = code;
+  _contentType = contentType;
+  _contentLength = len;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncAssetResponse::_respond(AsyncWebServerRequest *request)
+{
+  addHeader("Connection", "close");
+  _head = _assembleHead(request->version());
+
+  // Content-Length comes from the image entry, no body for HEAD
+  if (request->method() == HTTP_HEAD)
+    _sentLength = _contentLength;
+
+  _state = RESPONSE_HEADERS;
+  _ack(request, 0, 0);
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncAssetResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time)
+{
+  ESP32_ENC_AWS_UNUSED(time);
+
+  _ackedLength += len;
+
+  if (_state == RESPONSE_HEADERS || _state == RESPONSE_CONTENT)
+  {
+    AsyncClient* client = request->client();
+    size_t space = client->space();
+    size_t written = 0;
+
+    if (_state == RESPONSE_HEADERS)
+    {
+      // The head is short-lived, let the stack copy it
+      size_t outLen = std::min(space, _headLength - _headOffset);
+
+      if (outLen)
+      {
+        outLen = client->add(_head.c_str() + _headOffset, outLen);
+        _headOffset += outLen;
+        written += outLen;
+        space -= outLen;
+      }
+
+      if (_headOffset == _headLength)
+      {
+        _head = String();
+        _state = RESPONSE_CONTENT;
+      }
+    }
+
+    if (_state == RESPONSE_CONTENT)
+    {
+      size_t outLen = std::min(space, _contentLength - _sentLength);
+
+      if (outLen)
+      {
+        // No ASYNC_WRITE_FLAG_COPY : the segments reference the mapped flash directly
+        outLen = client->add((const char*) _content + _sentLength, outLen, 0);
+        _sentLength += outLen;
+        written += outLen;
+      }
+
+      if (_sentLength == _contentLength)
+        _state = RESPONSE_WAIT_ACK;
+    }
+
+    if (written)
+    {
+      client->send();
+      _writtenLength += written;
+    }
+
+    return written;
+  }
+  else if (_state == RESPONSE_WAIT_ACK)
+  {
+    if (_ackedLength >= _writtenLength)
+      _state = RESPONSE_END;
+  }
+
+  return 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
 /*
    Response Stream (You can print/write/printf to it, up to the contentLen bytes)
  * */
 
-AsyncResponseStream::AsyncResponseStream(const String& contentType, size_t bufferSize)
+struct AsyncStreamSegment
 {
+  AsyncStreamSegment *next;
+  size_t start;             // Read position, only touched by _fillBuffer()
+  size_t end;               // Write position
+  uint8_t data[ASYNC_RESPONSE_STREAM_SEGMENT_SIZE];
+};
+
+/////////////////////////////////////////////////
+
+static AsyncStreamSegment *_streamPool         = NULL;
+static size_t              _streamPoolCount    = 0;
+static portMUX_TYPE        _streamPoolMux      = portMUX_INITIALIZER_UNLOCKED;
+
+/////////////////////////////////////////////////
+
+static AsyncStreamSegment * _streamSegmentGet()
+{
+  portENTER_CRITICAL(&_streamPoolMux);
+
+  AsyncStreamSegment *seg = _streamPool;
+
+  if (seg)
+  {
+    _streamPool = seg->next;
+    _streamPoolCount--;
+  }
+
+  portEXIT_CRITICAL(&_streamPoolMux);
+
+  if (!seg)
+  {
+    seg = (AsyncStreamSegment *) malloc(sizeof(AsyncStreamSegment));
+
+    if (!seg)
+    {
+      AWS_LOGERROR1(F("[AsyncResponseStream] segment malloc failed, size ="), sizeof(AsyncStreamSegment));
+
+      return NULL;
+    }
+  }
+
+  seg->next  = NULL;
+  seg->start = 0;
+  seg->end   = 0;
+
+  return seg;
+}
+
+/////////////////////////////////////////////////
+
+static void _streamSegmentRelease(AsyncStreamSegment *seg)
+{
+  portENTER_CRITICAL(&_streamPoolMux);
+
+  if (_streamPoolCount < ASYNC_RESPONSE_STREAM_POOL_SIZE)
+  {
+    seg->next = _streamPool;
+    _streamPool = seg;
+    _streamPoolCount++;
+    seg = NULL;
+  }
+
+  portEXIT_CRITICAL(&_streamPoolMux);
+
+  if (seg)
+    free(seg);
+}
+
+/////////////////////////////////////////////////
+
+// Outlives the stream as long as a handle has it. A handle holds the lock for a whole write, the
+// stream's destructor takes it to detach, so a write never runs on a deleted stream.
+struct AsyncStreamLink
+{
+  AsyncWebLock lock;
+  AsyncResponseStream *stream;      // NULL once the stream is deleted
+  std::atomic<uint32_t> refs;       // The stream and every handle
+};
+
+/////////////////////////////////////////////////
+
+static void _streamLinkRelease(AsyncStreamLink *link)
+{
+  if (link && (link->refs.fetch_sub(1, std::memory_order_acq_rel) == 1))
+    delete link;
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStreamHandle::AsyncResponseStreamHandle(AsyncStreamLink *link) : _link(link)
+{
+  if (_link)
+    _link->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStreamHandle::AsyncResponseStreamHandle(const AsyncResponseStreamHandle& other)
+  : AsyncResponseStreamHandle(other._link)
+{
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStreamHandle& AsyncResponseStreamHandle::operator=(const AsyncResponseStreamHandle& other)
+{
+  if (other._link)
+    other._link->refs.fetch_add(1, std::memory_order_relaxed);
+
+  _streamLinkRelease(_link);
+  _link = other._link;
+
+  return *this;
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStreamHandle::~AsyncResponseStreamHandle()
+{
+  _streamLinkRelease(_link);
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncResponseStreamHandle::attached() const
+{
+  if (!_link)
+    return false;
+
+  AsyncWebLockGuard l(_link->lock);
+
+  return _link->stream != NULL;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseStreamHandle::end()
+{
+  if (!_link)
+    return;
+
+  AsyncWebLockGuard l(_link->lock);
+
+  if (_link->stream)
+    _link->stream->end();
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncResponseStreamHandle::write(const uint8_t *data, size_t len)
+{
+  if (!_link)
+    return 0;
+
+  AsyncWebLockGuard l(_link->lock);
+
+  return _link->stream ? _link->stream->write(data, len) : 0;
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncResponseStreamHandle::write(uint8_t data)
+{
+  return write(&data, 1);
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStream::AsyncResponseStream(const String& contentType, size_t bufferSize, bool chunked)
+  : _first(NULL), _last(NULL), _streaming(chunked), _ended(false), _link(NULL)
+{
+  ESP32_ENC_AWS_UNUSED(bufferSize);
+
   _code = 200;
   _contentLength = 0;
   _contentType = contentType;
-  _content = new cbuf(bufferSize);
+
+  if (_streaming)
+  {
+    _sendContentLength = false;
+    _chunked = true;
+
+    _link = new AsyncStreamLink();
+    _link->stream = this;
+    _link->refs.store(1, std::memory_order_relaxed);
+  }
 }
 
 /////////////////////////////////////////////////
 
 AsyncResponseStream::~AsyncResponseStream()
 {
-  delete _content;
+  if (_link)
+  {
+    // Waits for a handle's write in progress, later ones see the stream is gone
+    {
+      AsyncWebLockGuard l(_link->lock);
+      _link->stream = NULL;
+    }
+
+    _streamLinkRelease(_link);
+  }
+
+  while (_first)
+  {
+    AsyncStreamSegment *next = _first->next;
+    _streamSegmentRelease(_first);
+    _first = next;
+  }
 }
 
 /////////////////////////////////////////////////
 
+void AsyncResponseStream::_respond(AsyncWebServerRequest *request)
+{
+  // HTTP/1.0 has no chunked encoding, the end of the body is marked by closing the connection
+  if (_streaming && !request->version())
+    _chunked = false;
+
+  _wakeClient.store(request->client(), std::memory_order_relaxed);
+
+  AsyncAbstractResponse::_respond(request);
+}
+
+/////////////////////////////////////////////////
+
+AsyncResponseStreamHandle AsyncResponseStream::handle()
+{
+  return AsyncResponseStreamHandle(_link);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncResponseStream::end()
+{
+  portENTER_CRITICAL(&_mux);
+  _ended = true;
+  portEXIT_CRITICAL(&_mux);
+
+  _wake();
+}
+
+/////////////////////////////////////////////////
+
+// Only once per time the response ran dry, not on every write
+void AsyncResponseStream::_wake()
+{
+  AsyncClient *client = _wakeClient.load(std::memory_order_relaxed);
+
+  if (client && _waiting.exchange(false, std::memory_order_acq_rel))
+    AsyncWebWake::client(client);
+}
+
+/////////////////////////////////////////////////
+
+// The writer only appends behind _last->end and the reader only advances start, so the lock just
+// covers linking, unlinking and publishing end. Copies run outside of it. A segment is released
+// only once it is full and drained, so the writer can never be holding it.
 size_t AsyncResponseStream::_fillBuffer(uint8_t *buf, size_t maxLen)
 {
-  return _content->read((char*)buf, maxLen);
+  size_t copied = 0;
+
+  // Set before draining, a write from now on wakes the client again if this runs dry
+  _waiting.store(_streaming, std::memory_order_release);
+
+  // Read before draining : everything written before end() is then drained below. Reading it
+  // after could end the response on data written meanwhile, which would be lost.
+  portENTER_CRITICAL(&_mux);
+  const bool ended = _ended;
+  portEXIT_CRITICAL(&_mux);
+
+  while (copied < maxLen)
+  {
+    portENTER_CRITICAL(&_mux);
+    AsyncStreamSegment *seg = _first;
+    size_t end = seg ? seg->end : 0;
+    portEXIT_CRITICAL(&_mux);
+
+    if (!seg)
+      break;
+
+    size_t n = std::min(end - seg->start, maxLen - copied);
+
+    memcpy(buf + copied, seg->data + seg->start, n);
+    seg->start += n;
+    copied += n;
+
+    if (seg->start < ASYNC_RESPONSE_STREAM_SEGMENT_SIZE)
+    {
+      // Drained up to what has been written so far
+      if (seg->start == end)
+        break;
+
+      continue;
+    }
+
+    // Already copied to the send buffer, no need to wait for the ack to reuse it
+    portENTER_CRITICAL(&_mux);
+    _first = seg->next;
+
+    if (!_first)
+      _last = NULL;
+
+    portEXIT_CRITICAL(&_mux);
+
+    _streamSegmentRelease(seg);
+  }
+
+  if (!copied && _streaming && !ended)
+    return RESPONSE_TRY_AGAIN;
+
+  // Not waiting for data, the ack or poll that follows asks again
+  _waiting.store(false, std::memory_order_relaxed);
+
+  return copied;
 }
 
 /////////////////////////////////////////////////
 
 size_t AsyncResponseStream::write(const uint8_t *data, size_t len)
 {
-  if (_started())
+  if (_streaming ? (_ended || _state >= RESPONSE_WAIT_ACK) : _started())
     return 0;
 
-  if (len > _content->room())
+  size_t written = 0;
+
+  while (written < len)
   {
-    size_t needed = len - _content->room();
-    _content->resizeAdd(needed);
+    portENTER_CRITICAL(&_mux);
+    AsyncStreamSegment *seg = _last;
+    size_t end = seg ? seg->end : ASYNC_RESPONSE_STREAM_SEGMENT_SIZE;
+    portEXIT_CRITICAL(&_mux);
+
+    if (end == ASYNC_RESPONSE_STREAM_SEGMENT_SIZE)
+    {
+      seg = _streamSegmentGet();
+
+      if (!seg)
+        break;
+
+      end = 0;
+
+      portENTER_CRITICAL(&_mux);
+
+      if (_last)
+        _last->next = seg;
+      else
+        _first = seg;
+
+      _last = seg;
+      portEXIT_CRITICAL(&_mux);
+    }
+
+    size_t n = std::min(len - written, (size_t) (ASYNC_RESPONSE_STREAM_SEGMENT_SIZE - end));
+
+    memcpy(seg->data + end, data + written, n);
+
+    portENTER_CRITICAL(&_mux);
+    seg->end = end + n;
+    portEXIT_CRITICAL(&_mux);
+
+    written += n;
   }
 
-  size_t written = _content->write((const char*)data, len);
-  _contentLength += written;
+  if (!_streaming)
+    _contentLength += written;
+  else if (written)
+    _wake();
 
   return written;
 }
@@ -1296,4 +1925,158 @@ size_t AsyncResponseStream::write(uint8_t data)
 }
 
 /////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+/*
+   Multipart Stream Response
+ * */
 
+AsyncMultipartStreamResponse::AsyncMultipartStreamResponse(AsyncFrameSource *source, const String& partType)
+  : AsyncAbstractResponse()
+  , _source(source)
+  , _partType("--" ASYNC_MULTIPART_BOUNDARY "\r\nContent-Type: " + partType + "\r\nContent-Length: ")
+  , _frame(NULL)
+  , _waiter { NULL, NULL, false }
+  , _lastSeq(0)
+  , _partPos(0)
+  , _partHeadLen(0)
+  , _sentFrames(0)
+  , _skippedFrames(0)
+{
+  _code = 200;
+  _contentLength = 0;
+  _sendContentLength = false;
+  _contentType = "multipart/x-mixed-replace;boundary=" ASYNC_MULTIPART_BOUNDARY;
+
+  addHeader("Cache-Control", "no-cache");
+}
+
+/////////////////////////////////////////////////
+
+AsyncMultipartStreamResponse::~AsyncMultipartStreamResponse()
+{
+  _source->forget(&_waiter);
+
+  if (_frame)
+    _source->release(_frame);
+
+  AWS_LOGDEBUG3("[AsyncMultipartStreamResponse] Frames sent =", _sentFrames, ", skipped =", _skippedFrames);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncMultipartStreamResponse::_respond(AsyncWebServerRequest *request)
+{
+  _waiter.client = request->client();
+
+  AsyncAbstractResponse::_respond(request);
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncMultipartStreamResponse::_fillBuffer(uint8_t *data, size_t len)
+{
+  size_t filled = 0;
+
+  while (filled < len)
+  {
+    if (!_frame)
+    {
+      // Nothing new links the waiter in, the next publish() wakes the connection
+      _frame = _source->acquire(_lastSeq, &_waiter);
+
+      if (!_frame)
+        break;
+
+      // Published while the previous frame was being sent, never copied for this client
+      if (_lastSeq)
+        _skippedFrames += _frame->seq - _lastSeq - 1;
+
+      _lastSeq = _frame->seq;
+      _partPos = 0;
+      _partHeadLen = _partType.length() + snprintf(_partLength, sizeof(_partLength), "%u\r\n\r\n",
+                                                   (unsigned) _frame->len);
+    }
+
+    const size_t frameEnd = _partHeadLen + _frame->len;
+    const size_t partEnd = frameEnd + 2;
+    size_t n;
+
+    if (_partPos < _partType.length())
+    {
+      n = std::min(len - filled, _partType.length() - _partPos);
+      memcpy(data + filled, _partType.c_str() + _partPos, n);
+    }
+    else if (_partPos < _partHeadLen)
+    {
+      n = std::min(len - filled, _partHeadLen - _partPos);
+      memcpy(data + filled, _partLength + (_partPos - _partType.length()), n);
+    }
+    else if (_partPos < frameEnd)
+    {
+      n = std::min(len - filled, frameEnd - _partPos);
+      memcpy(data + filled, _frame->data() + (_partPos - _partHeadLen), n);
+    }
+    else
+    {
+      n = std::min(len - filled, partEnd - _partPos);
+      memcpy(data + filled, "\r\n" + (_partPos - frameEnd), n);
+    }
+
+    filled += n;
+    _partPos += n;
+
+    if (_partPos == partEnd)
+    {
+      _source->release(_frame);
+      _frame = NULL;
+      _sentFrames++;
+    }
+  }
+
+  // Nothing new yet, a return of 0 would end the response
+  return filled ? filled : RESPONSE_TRY_AGAIN;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+/*
+   Cached Response
+ * */
+
+AsyncCachedResponse::AsyncCachedResponse(const std::shared_ptr<AsyncCacheEntry>& entry)
+  : AsyncAbstractResponse()
+  , _entry(entry)
+  , _readLength(0)
+{
+  _code = entry->code;
+  _contentType = entry->contentType;
+  _contentLength = entry->length;
+
+  for (const auto& header : entry->headers)
+    addHeader(header.first, header.second);
+
+  addHeader("ETag", entry->etag);
+
+  // Stored uncompressed, compressed again for each client that accepts it
+  setCompress(entry->compress);
+}
+
+/////////////////////////////////////////////////
+
+AsyncCachedResponse::~AsyncCachedResponse()
+{
+}
+
+/////////////////////////////////////////////////
+
+size_t AsyncCachedResponse::_fillBuffer(uint8_t *data, size_t len)
+{
+  const size_t n = std::min(len, _entry->length - _readLength);
+
+  memcpy(data, _entry->body + _readLength, n);
+  _readLength += n;
+
+  return n;
+}
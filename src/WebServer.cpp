@@ -32,6 +32,9 @@
 
 #include "AsyncWebServer_ESP32_ENC.h"
 #include "WebHandlerImpl.h"
+#include "AsyncBodySpool.h"
+#include "AsyncWebWorker.h"
+#include "AsyncWebHeap.h"
 
 /////////////////////////////////////////////////
 
@@ -49,6 +52,51 @@ bool ON_AP_FILTER(AsyncWebServerRequest *request)
 
 /////////////////////////////////////////////////
 
+static const char _poolRefusal[] = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\n"
+                                   "Connection: close\r\n\r\n";
+
+static const char _heapRefusal[] = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: " ASYNC_WEB_HEAP_RETRY_AFTER
+                                   "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+// Answers a connection with a canned 503 without creating a request for it, the client is freed
+// once the answer is acked or the connection goes away
+static void refuseClient(AsyncClient* c, const char* answer, size_t len)
+{
+  c->onData(NULL, NULL);
+
+  c->onAck([](void *r, AsyncClient * c, size_t len, uint32_t time)
+  {
+    ESP32_ENC_AWS_UNUSED(r);
+    ESP32_ENC_AWS_UNUSED(len);
+    ESP32_ENC_AWS_UNUSED(time);
+    c->close();
+  }, NULL);
+
+  c->onPoll([](void *r, AsyncClient * c)
+  {
+    ESP32_ENC_AWS_UNUSED(r);
+    c->close();
+  }, NULL);
+
+  c->onTimeout([](void *r, AsyncClient * c, uint32_t time)
+  {
+    ESP32_ENC_AWS_UNUSED(r);
+    ESP32_ENC_AWS_UNUSED(time);
+    c->close();
+  }, NULL);
+
+  c->onDisconnect([](void *r, AsyncClient * c)
+  {
+    ESP32_ENC_AWS_UNUSED(r);
+    delete c;
+  }, NULL);
+
+  if (c->add(answer, len) == 0 || !c->send())
+    c->close(true);
+}
+
+/////////////////////////////////////////////////
+
 AsyncWebServer::AsyncWebServer(uint16_t port)
   : _server(port),
     _rewrites(LinkedList<AsyncWebRewrite * >([](AsyncWebRewrite * r)
@@ -58,7 +106,15 @@ AsyncWebServer::AsyncWebServer(uint16_t port)
 _handlers(LinkedList<AsyncWebHandler*>([](AsyncWebHandler* h)
 {
   delete h;
-}))
+})),
+_spoolThreshold(0),
+_spoolFs(NULL),
+_requestPool(NULL),
+_poolSize(0),
+_poolFree(0),
+_poolOverflow(false),
+_poolStats(),
+_earlyRouting(false)
 {
   _catchAllHandler = new AsyncCallbackWebHandler();
 
@@ -70,10 +126,30 @@ _handlers(LinkedList<AsyncWebHandler*>([](AsyncWebHandler* h)
     if (c == NULL)
       return;
 
+    // Finished deferred requests may hold pooled requests
+    AsyncWebWorker::collect();
+
     c->setRxTimeout(3);
-    AsyncWebServerRequest *r = new AsyncWebServerRequest((AsyncWebServer*)s, c);
+    AsyncWebServer *server = (AsyncWebServer*)s;
+
+    // Too little heap left for a request, a response and their buffers, answer from flash
+    if (AsyncWebHeap::check() == ASYNC_HEAP_CRITICAL)
+    {
+      AsyncWebHeap::_refused();
+      refuseClient(c, _heapRefusal, sizeof(_heapRefusal) - 1);
+
+      return;
+    }
+
+    AsyncWebServerRequest *r = server->_acquireRequest(c);
 
-    if (r == NULL)
+    if ((r == NULL) && server->_poolSize && !server->_poolOverflow)
+    {
+      // Every pooled request is in use
+      server->_poolStats.refused++;
+      refuseClient(c, _poolRefusal, sizeof(_poolRefusal) - 1);
+    }
+    else if (r == NULL)
     {
       c->close(true);
       c->free();
@@ -84,6 +160,92 @@ _handlers(LinkedList<AsyncWebHandler*>([](AsyncWebHandler* h)
 
 /////////////////////////////////////////////////
 
+/////////////////////////////////////////////////
+
+AsyncWebServerRequest* AsyncWebServer::_acquireRequest(AsyncClient* c)
+{
+  if (_poolFree)
+  {
+    AsyncWebServerRequest *r = _requestPool[--_poolFree];
+
+    if (_poolFree < _poolStats.lowWater)
+      _poolStats.lowWater = _poolFree;
+
+    _poolStats.reused++;
+    r->_bind(c);
+
+    return r;
+  }
+
+  if (_poolSize && !_poolOverflow)
+  {
+    AWS_LOGDEBUG("[AsyncWebServer] Request pool empty");
+
+    return NULL;
+  }
+
+  if (_poolSize)
+    _poolStats.overflow++;
+
+  return new AsyncWebServerRequest(this, c);
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServer::_releaseRequest(AsyncWebServerRequest *request)
+{
+  if (!request->_pooled)
+  {
+    delete request;
+
+    return;
+  }
+
+  request->_recycle();
+  _requestPool[_poolFree++] = request;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServer::setRequestPool(size_t size, bool overflow)
+{
+  if (_requestPool)
+  {
+    AWS_LOGERROR("[AsyncWebServer] setRequestPool() must be called before begin()");
+
+    return;
+  }
+
+  _poolSize = size;
+  _poolOverflow = overflow;
+}
+
+/////////////////////////////////////////////////
+
+AsyncRequestPoolStats AsyncWebServer::requestPoolStats() const
+{
+  AsyncRequestPoolStats stats = _poolStats;
+  stats.available = _poolFree;
+
+  return stats;
+}
+
+/////////////////////////////////////////////////
+
+void AsyncWebServer::setHeapWatermarks(size_t low, size_t critical)
+{
+  AsyncWebHeap::setWatermarks(low, critical);
+}
+
+/////////////////////////////////////////////////
+
+AsyncHeapStatus AsyncWebServer::heapStatus() const
+{
+  return AsyncWebHeap::status();
+}
+
+/////////////////////////////////////////////////
+
 AsyncWebServer::~AsyncWebServer()
 {
   reset();
@@ -91,6 +253,12 @@ AsyncWebServer::~AsyncWebServer()
 
   if (_catchAllHandler)
     delete _catchAllHandler;
+
+  // Requests still in use are not tracked, their connections must be closed by now
+  while (_poolFree)
+    delete _requestPool[--_poolFree];
+
+  delete[] _requestPool;
 }
 
 /////////////////////////////////////////////////
@@ -136,6 +304,22 @@ bool AsyncWebServer::removeHandler(AsyncWebHandler *handler)
 
 void AsyncWebServer::begin()
 {
+  if (_poolSize && !_requestPool)
+  {
+    _requestPool = new AsyncWebServerRequest*[_poolSize];
+
+    while (_poolFree < _poolSize)
+    {
+      AsyncWebServerRequest *r = new AsyncWebServerRequest(this, NULL);
+      r->_pooled = true;
+
+      _requestPool[_poolFree++] = r;
+    }
+
+    _poolStats.size = _poolSize;
+    _poolStats.lowWater = _poolSize;
+  }
+
   _server.setNoDelay(true);
   _server.begin();
 }
@@ -169,7 +353,7 @@ void AsyncWebServer::beginSecure(const char *cert, const char *key, const char *
 
 void AsyncWebServer::_handleDisconnect(AsyncWebServerRequest *request)
 {
-  delete request;
+  _releaseRequest(request);
 }
 
 /////////////////////////////////////////////////
@@ -188,14 +372,62 @@ void AsyncWebServer::_rewriteRequest(AsyncWebServerRequest *request)
 
 /////////////////////////////////////////////////
 
+void AsyncWebServer::setEarlyRouting(bool enable)
+{
+  _earlyRouting = enable;
+}
+
+/////////////////////////////////////////////////
+
+// Request line only : applies the rewrites and attaches the first handler that can decide without the headers.
+// False if early routing is off, the request then does both at the end of the headers.
+bool AsyncWebServer::_routeEarly(AsyncWebServerRequest *request)
+{
+  if (!_earlyRouting)
+    return false;
+
+  _rewriteRequest(request);
+
+  for (uint8_t pass = 0; pass < _routingPasses(request); pass++)
+  {
+    request->_headAsGet = (pass == 1);
+
+    for (const auto& h : _handlers)
+    {
+      // Can't tell yet, the request keeps every header and is attached at their end
+      if (h->routesOnHeaders(request))
+        return true;
+
+      if (h->filter(request) && h->canHandle(request))
+      {
+        request->setHandler(h);
+
+        return true;
+      }
+    }
+  }
+
+  request->addInterestingHeader("ANY");
+  request->setHandler(_catchAllHandler);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServer::_attachHandler(AsyncWebServerRequest *request)
 {
-  for (const auto& h : _handlers)
+  for (uint8_t pass = 0; pass < _routingPasses(request); pass++)
   {
-    if (h->filter(request) && h->canHandle(request))
+    request->_headAsGet = (pass == 1);
+
+    for (const auto& h : _handlers)
     {
-      request->setHandler(h);
-      return;
+      if (h->filter(request) && h->canHandle(request))
+      {
+        request->setHandler(h);
+        return;
+      }
     }
   }
 
@@ -264,6 +496,28 @@ AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, ArRequestHandlerFun
 
 /////////////////////////////////////////////////
 
+AsyncCallbackWebHandler& AsyncWebServer::onAsync(const char* uri, WebRequestMethodComposite method,
+                                                 ArRequestHandlerFunction onRequest)
+{
+  return on(uri, method, [onRequest](AsyncWebServerRequest * request)
+  {
+    if (request->defer(onRequest))
+      return;
+
+    AsyncCannedHeader retry = { "Retry-After", "1" };
+
+    if (request->_sendCanned(503, &retry, 1))
+      return;
+
+    AsyncWebServerResponse * response = request->beginResponse(503);
+
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+  });
+}
+
+/////////////////////////////////////////////////
+
 AsyncStaticWebHandler& AsyncWebServer::serveStatic(const char* uri, fs::FS& fs, const char* path,
                                                    const char* cache_control)
 {
@@ -275,6 +529,23 @@ AsyncStaticWebHandler& AsyncWebServer::serveStatic(const char* uri, fs::FS& fs,
 
 /////////////////////////////////////////////////
 
+AsyncAssetWebHandler& AsyncWebServer::serveAssets(const char* uri, const char* label, const char* cache_control)
+{
+  AsyncAssetWebHandler* handler = new AsyncAssetWebHandler(uri, label, cache_control);
+  addHandler(handler);
+
+  return *handler;
+}
+
+/////////////////////////////////////////////////
+
+bool AsyncWebServer::addMimeType(const char* extension, const char* type)
+{
+  return AsyncWebMimeTypes::add(extension, type);
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServer::onNotFound(ArRequestHandlerFunction fn)
 {
   _catchAllHandler->onRequest(fn);
@@ -296,6 +567,28 @@ void AsyncWebServer::onRequestBody(ArBodyHandlerFunction fn)
 
 /////////////////////////////////////////////////
 
+void AsyncWebServer::setBodySpool(size_t threshold, fs::FS* fs, const char* dir)
+{
+  _spoolThreshold = threshold;
+  _spoolFs = fs;
+  _spoolDir = dir ? dir : "";
+
+  while (_spoolDir.endsWith("/"))
+    _spoolDir.remove(_spoolDir.length() - 1);
+}
+
+/////////////////////////////////////////////////
+
+AsyncBodySpool* AsyncWebServer::_spoolBody(size_t length)
+{
+  if (!_spoolsBody(length))
+    return NULL;
+
+  return AsyncBodySpool::create(length, _spoolFs, _spoolDir);
+}
+
+/////////////////////////////////////////////////
+
 void AsyncWebServer::reset()
 {
   _rewrites.free();
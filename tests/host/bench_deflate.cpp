@@ -0,0 +1,89 @@
+/****************************************************************************************************************************
+  bench_deflate.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+// Ratio, speed and heap use of AsyncWebDeflate, with zlib -6 as a reference point for the ratio.
+// Speed is host speed, only meaningful relative to the other rows.
+
+#include "deflate_corpus.h"
+#include "host_test.h"
+
+#include <malloc.h>
+#include <zlib.h>
+
+/////////////////////////////////////////////////
+
+static void bench(const char* name, const std::string& input)
+{
+  std::string packed;
+  int rounds = 0;
+  const double start = hostTestNow();
+  double elapsed;
+
+  do
+  {
+    packed = deflateAll(input, ASYNC_ENCODING_GZIP);
+    rounds++;
+    elapsed = hostTestNow() - start;
+  } while (elapsed < 0.5);
+
+  uLongf zlibLen = compressBound(input.size());
+  std::string reference(zlibLen, '\0');
+
+  compress2((Bytef*) &reference[0], &zlibLen, (const Bytef*) input.data(), input.size(), 6);
+
+  printf("%-14s %8zu -> %8zu  %5.2fx  %7.1f MB/s   zlib -6: %8lu  %5.2fx\n", name, input.size(), packed.size(),
+         (double) input.size() / packed.size(), input.size() * (double) rounds / elapsed / 1e6, (unsigned long) zlibLen,
+         (double) input.size() / zlibLen);
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  printf("AsyncWebDeflate, window %lu, hash %lu, chain %d, input %d\n\n", ASYNC_DEFLATE_WINDOW_SIZE,
+         ASYNC_DEFLATE_HASH_SIZE, ASYNC_DEFLATE_MAX_CHAIN, ASYNC_DEFLATE_INPUT_SIZE);
+
+  bench("html table", corpusHtml(400));
+  bench("json array", corpusJson(400));
+  bench("random", corpusRandom(20000, 1));
+
+  // Everything is in the single allocation made by begin()
+  AsyncWebDeflate deflate;
+  const size_t before = mallinfo2().uordblks;
+
+  deflate.begin(ASYNC_ENCODING_GZIP);
+
+  printf("\nheap per compressing response: %zu bytes (memoryUsage() %zu)\n", mallinfo2().uordblks - before,
+         AsyncWebDeflate::memoryUsage());
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/****************************************************************************************************************************
+  bench_early_routing.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// Heap allocations and time to parse a request carrying 1.8KB of Cookie and User-Agent headers, for a
+// handler that reads one header, with early routing on and off. Runs the library's request parser
+// over the host core in stubs/, allocations are counted from the first byte until the handler runs.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "host_test.h"
+
+#include <new>
+#include <string>
+
+/////////////////////////////////////////////////
+
+static size_t heapCalls;
+static bool counting;
+
+void* operator new(size_t size)
+{
+  if (counting)
+    heapCalls++;
+
+  void* p = malloc(size);
+
+  if (!p)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+// Not inlined, so that gcc doesn't take free() after operator new for a mismatch
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+/////////////////////////////////////////////////
+
+class KeepHandler : public AsyncWebHandler
+{
+  public:
+    size_t handled = 0;
+    size_t headers = 0;
+
+    bool canHandle(AsyncWebServerRequest* request) override
+    {
+      if (!request->url().startsWith("/keep"))
+        return false;
+
+      request->addInterestingHeader("X-Keep");
+
+      return true;
+    }
+
+    void handleRequest(AsyncWebServerRequest* request) override
+    {
+      counting = false;
+      handled++;
+      headers = request->headers();
+      request->send(200);
+    }
+};
+
+/////////////////////////////////////////////////
+
+static void bench(AsyncWebServer& server, KeepHandler* handler, bool early, const std::string& request)
+{
+  const int rounds = 20000;
+  size_t calls = 0;
+
+  server.setEarlyRouting(early);
+
+  // The first request fills the request pool
+  AsyncClient* first = AsyncServer::connect(80);
+  std::string buffer = request;
+
+  first->receive(&buffer[0], buffer.size());
+  first->disconnect();
+
+  handler->handled = 0;
+
+  const double start = hostTestNow();
+
+  for (int r = 0; r < rounds; r++)
+  {
+    AsyncClient* client = AsyncServer::connect(80);
+
+    // The parser works in place, like on the pbuf
+    buffer = request;
+
+    heapCalls = 0;
+    counting = true;
+    client->receive(&buffer[0], buffer.size());
+    counting = false;
+    calls += heapCalls;
+
+    client->disconnect();
+  }
+
+  const double us = (hostTestNow() - start) * 1e6 / rounds;
+
+  printf("early routing %-3s  %5.1f heap allocations, %5.2f us per request, %zu headers kept%s\n", early ? "on" : "off",
+         (double) calls / rounds, us, handler->headers, (handler->handled == (size_t) rounds) ? "" : "  HANDLER NOT RUN");
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  AsyncWebServer server(80);
+  KeepHandler* handler = new KeepHandler();
+
+  server.addHandler(handler);
+  server.begin();
+
+  const std::string request = "GET /keep HTTP/1.1\r\nHost: device.local\r\nCookie: " + std::string(1500, 'c')
+                              + "\r\nUser-Agent: " + std::string(300, 'u') + "\r\nAccept: */*\r\nX-Keep: 1\r\n\r\n";
+
+  printf("GET with %zu bytes of headers, the handler reads X-Keep\n\n", request.size());
+
+  bench(server, handler, false, request);
+  bench(server, handler, true, request);
+
+  return 0;
+}
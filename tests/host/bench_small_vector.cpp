@@ -0,0 +1,106 @@
+/****************************************************************************************************************************
+  bench_small_vector.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// SmallVector next to the LinkedList it replaced, on the pattern of a request's header list : add n
+// heap-allocated elements, iterate, look one up with nth(), remove the first, then free() with a remover.
+
+#include "StringArray.h"
+#include "host_test.h"
+
+/////////////////////////////////////////////////
+
+struct Item
+{
+  int value;
+
+  Item(int v) : value(v) {}
+};
+
+static void deleteItem(Item* item)
+{
+  delete item;
+}
+
+static volatile long sink;
+
+/////////////////////////////////////////////////
+
+template <typename List>
+static double run(List& list, int n, int rounds)
+{
+  const double start = hostTestNow();
+
+  for (int r = 0; r < rounds; r++)
+  {
+    for (int i = 0; i < n; i++)
+      list.add(new Item(i));
+
+    long sum = 0;
+
+    for (const auto item : list)
+      sum += item->value;
+
+    sum += (*list.nth(n / 2))->value;
+
+    list.remove(list.front());
+    list.free();
+    sink = sum;
+  }
+
+  return (hostTestNow() - start) * 1e3;
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  const int rounds = 200000;
+
+  printf("add n, iterate, nth, remove front, free : %d rounds\n\n", rounds);
+
+  for (int n : { 4, 8, 16, 32 })
+  {
+    LinkedList<Item*> linked([](Item * const & item)
+    {
+      delete item;
+    });
+    SmallVector<Item*, 8> small(deleteItem);
+
+    const double linkedMs = run(linked, n, rounds);
+    const double smallMs = run(small, n, rounds);
+
+    printf("n=%-3d  LinkedList %6.0f ms   SmallVector<8> %6.0f ms\n", n, linkedMs, smallMs);
+  }
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+/****************************************************************************************************************************
+  bench_web_arena.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// AsyncWebArena next to one operator new per object, on the objects a request builds while parsing :
+// headers and parameters, then everything dropped at once when the request ends or is recycled.
+// The objects stand in for AsyncWebHeader / AsyncWebParameter on ESP32, two String members each.
+
+#include "AsyncWebArena.h"
+#include "host_test.h"
+
+#include <new>
+
+/////////////////////////////////////////////////
+
+struct Object
+{
+  char strings[32];
+
+  Object(int i)
+  {
+    strings[0] = (char) i;
+  }
+};
+
+static size_t heapCalls;
+
+void* operator new(size_t size)
+{
+  heapCalls++;
+
+  void* p = malloc(size);
+
+  if (!p)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+static volatile int sink;
+
+/////////////////////////////////////////////////
+
+static double runHeap(int objects, int rounds, size_t* calls)
+{
+  Object* list[64] = {};
+  const size_t before = heapCalls;
+  const double start = hostTestNow();
+
+  for (int r = 0; r < rounds; r++)
+  {
+    for (int i = 0; i < objects; i++)
+      list[i] = new Object(i);
+
+    sink = list[objects - 1]->strings[0];
+
+    for (int i = 0; i < objects; i++)
+      delete list[i];
+  }
+
+  *calls = (heapCalls - before) / rounds;
+
+  return (hostTestNow() - start) * 1e9 / rounds;
+}
+
+/////////////////////////////////////////////////
+
+static double runArena(int objects, int rounds, size_t* blocks)
+{
+  AsyncWebArena arena;
+  Object* list[64] = {};
+  size_t overflow = 0;
+  const double start = hostTestNow();
+
+  for (int r = 0; r < rounds; r++)
+  {
+    for (int i = 0; i < objects; i++)
+      list[i] = arena.create<Object>(i);
+
+    sink = list[objects - 1]->strings[0];
+
+    // Objects fill a block exactly, so every block past the first is one malloc()
+    overflow += (arena.used() - 1) / ASYNC_WEB_ARENA_SIZE;
+
+    arena.reset();
+  }
+
+  *blocks = overflow / rounds;
+
+  return (hostTestNow() - start) * 1e9 / rounds;
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  const int rounds = 1000000;
+
+  printf("objects of %zu bytes per request, arena first block %d bytes, %d rounds\n\n", sizeof(Object),
+         ASYNC_WEB_ARENA_SIZE, rounds);
+
+  for (int objects : { 4, 11, 24, 48 })
+  {
+    size_t calls, blocks;
+    const double heapNs = runHeap(objects, rounds, &calls);
+    const double arenaNs = runArena(objects, rounds, &blocks);
+
+    printf("%2d objects  new/delete %6.0f ns, %2zu heap calls   arena %6.0f ns, %zu overflow blocks\n", objects,
+           heapNs, calls, arenaNs, blocks);
+  }
+
+  return 0;
+}
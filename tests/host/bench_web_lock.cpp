@@ -0,0 +1,135 @@
+/****************************************************************************************************************************
+  bench_web_lock.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// AsyncWebLock and AsyncWebSpinLock built with ASYNC_WEB_LOCK_PTHREAD, next to std::mutex : time per
+// lock and unlock around a short section, from 1 to 8 threads. With ASYNC_WEB_LOCK_STATS the
+// AsyncWebLock counters show how often a take found the lock held and had to block after spinning.
+
+#include "AsyncWebSynchronization.h"
+#include "host_test.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define BENCH_ROUNDS          200000
+
+static volatile uint32_t sink;
+
+/////////////////////////////////////////////////
+
+// ns per lock and unlock, over every thread's rounds
+template <typename Take>
+static double run(int threads, Take take)
+{
+  std::vector<std::thread> workers;
+  const double start = hostTestNow();
+
+  for (int t = 0; t < threads; t++)
+  {
+    workers.emplace_back([&]
+    {
+      for (int i = 0; i < BENCH_ROUNDS; i++)
+        take();
+    });
+  }
+
+  for (auto& w : workers)
+    w.join();
+
+  return (hostTestNow() - start) * 1e9 / ((double) threads * BENCH_ROUNDS);
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  printf("%d lock/unlock per thread, %u hardware threads, spin %d, stats %s\n\n", BENCH_ROUNDS,
+         std::thread::hardware_concurrency(), ASYNC_WEB_LOCK_SPIN, ASYNC_WEB_LOCK_STATS ? "on" : "off");
+
+  for (int threads : { 1, 2, 4, 8 })
+  {
+    AsyncWebLock lock;
+    AsyncWebSpinLock spin;
+    std::mutex mutex;
+
+    const double lockNs = run(threads, [&]
+    {
+      AsyncWebLockGuard l(lock);
+      sink = sink + 1;
+    });
+
+    const double spinNs = run(threads, [&]
+    {
+      AsyncWebLockGuard l(spin);
+      sink = sink + 1;
+    });
+
+    const double mutexNs = run(threads, [&]
+    {
+      std::lock_guard<std::mutex> l(mutex);
+      sink = sink + 1;
+    });
+
+    const AsyncWebLockStats s = lock.stats();
+
+    printf("%d threads  AsyncWebLock %6.1f ns  AsyncWebSpinLock %6.1f ns  std::mutex %6.1f ns\n", threads, lockNs,
+           spinNs, mutexNs);
+
+    if (ASYNC_WEB_LOCK_STATS)
+      printf("           acquired %u, contended %u (%.2f%%), blocked %u (%.2f%%)\n", s.acquired, s.contended,
+             s.acquired ? 100.0 * s.contended / s.acquired : 0.0, s.blocked,
+             s.acquired ? 100.0 * s.blocked / s.acquired : 0.0);
+  }
+
+  // Taking a lock the thread already holds, as nested container calls do
+  AsyncWebLock lock;
+
+  lock.lock();
+
+  const double start = hostTestNow();
+
+  for (int i = 0; i < BENCH_ROUNDS; i++)
+  {
+    AsyncWebLockGuard l(lock);
+    sink = sink + 1;
+  }
+
+  const double nestedNs = (hostTestNow() - start) * 1e9 / BENCH_ROUNDS;
+
+  lock.unlock();
+
+  printf("\nAsyncWebLock already held by the thread %6.1f ns\n", nestedNs);
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+/****************************************************************************************************************************
+  deflate_corpus.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+#ifndef DEFLATE_CORPUS_H_
+#define DEFLATE_CORPUS_H_
+
+// Inputs shared by test_deflate and bench_deflate, and a helper that runs a whole body through
+// AsyncWebDeflate the way AsyncAbstractResponse does.
+
+#include "AsyncWebDeflate.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+/////////////////////////////////////////////////
+
+// A status page as a dynamic handler would render it
+static std::string corpusHtml(size_t rows)
+{
+  std::string s = "<!DOCTYPE html><html><head><title>Sensors</title><link rel=\"stylesheet\" href=\"/style.css\">"
+                  "</head><body><h1>Sensors</h1><table class=\"data\"><tr><th>Id</th><th>Name</th><th>Value</th>"
+                  "<th>Unit</th><th>Updated</th></tr>\n";
+  char row[256];
+
+  for (size_t i = 0; i < rows; i++)
+  {
+    snprintf(row, sizeof(row), "<tr class=\"%s\"><td>%u</td><td>sensor-%03u</td><td>%u.%02u</td><td>%s</td>"
+             "<td>2024-01-%02u %02u:%02u:%02u</td></tr>\n", (i & 1) ? "odd" : "even", (unsigned) i, (unsigned) (i * 7 % 1000),
+             (unsigned) (i * 37 % 100), (unsigned) (i * 13 % 100), (i % 3) ? "&deg;C" : "%RH", (unsigned) (i % 28 + 1),
+             (unsigned) (i % 24), (unsigned) (i * 7 % 60), (unsigned) (i * 11 % 60));
+    s += row;
+  }
+
+  return s + "</table></body></html>\n";
+}
+
+/////////////////////////////////////////////////
+
+// An array of readings as an API would return it
+static std::string corpusJson(size_t items)
+{
+  std::string s = "{\"device\":\"esp32-enc\",\"uptime\":123456,\"readings\":[";
+  char item[256];
+
+  for (size_t i = 0; i < items; i++)
+  {
+    snprintf(item, sizeof(item), "%s{\"id\":%u,\"name\":\"sensor-%03u\",\"value\":%u.%03u,\"ok\":%s,\"ts\":%u}",
+             i ? "," : "", (unsigned) i, (unsigned) (i * 7 % 1000), (unsigned) (i * 37 % 100), (unsigned) (i * 997 % 1000),
+             (i % 5) ? "true" : "false", (unsigned) (1700000000 + i * 61));
+    s += item;
+  }
+
+  return s + "]}";
+}
+
+/////////////////////////////////////////////////
+
+static std::string corpusRandom(size_t len, uint32_t seed)
+{
+  std::string s(len, '\0');
+
+  for (size_t i = 0; i < len; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    s[i] = (char) (seed >> 16);
+  }
+
+  return s;
+}
+
+/////////////////////////////////////////////////
+
+// Compresses input in slices of at most slice bytes, draining the output in reads of at most drain
+// bytes between commits. Empty on allocation failure.
+static std::string deflateAll(const std::string& input, AsyncWebEncoding encoding, size_t slice = ASYNC_DEFLATE_INPUT_SIZE,
+                              size_t drain = 1460)
+{
+  AsyncWebDeflate deflate;
+  std::string out;
+  uint8_t buf[2048];
+
+  if (!deflate.begin(encoding))
+    return out;
+
+  size_t pos = 0;
+
+  for (;;)
+  {
+    while (deflate.available())
+    {
+      size_t n = deflate.read(buf, (drain < sizeof(buf)) ? drain : sizeof(buf));
+      out.append((const char*) buf, n);
+    }
+
+    if (deflate.done())
+      break;
+
+    if (pos == input.size())
+    {
+      deflate.finish();
+      continue;
+    }
+
+    size_t room;
+    uint8_t* dst = deflate.inputBuffer(room);
+    size_t n = input.size() - pos;
+
+    if (n > room)
+      n = room;
+
+    if (n > slice)
+      n = slice;
+
+    memcpy(dst, input.data() + pos, n);
+    deflate.commit(n);
+    pos += n;
+  }
+
+  return out;
+}
+
+#endif /* DEFLATE_CORPUS_H_ */
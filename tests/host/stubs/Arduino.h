@@ -0,0 +1,136 @@
+/****************************************************************************************************************************
+  Arduino.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+// The part of the Arduino core for ESP32 the library uses, enough to build and run it on a Linux host.
+// Implemented in host_arduino.cpp.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "WString.h"
+#include "Print.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+/////////////////////////////////////////////////
+
+#define PGM_P                           const char *
+#define PROGMEM
+#define PSTR(s)                         (s)
+#define pgm_read_byte(p)                (*(const uint8_t *)(p))
+#define memcpy_P                        memcpy
+#define strlen_P                        strlen
+#define strcpy_P                        strcpy
+#define strncpy_P                       strncpy
+#define strcmp_P                        strcmp
+#define strncasecmp_P                   strncasecmp
+#define vsnprintf_P                     vsnprintf
+#define snprintf_P                      snprintf
+
+#define ICACHE_FLASH_ATTR
+#define IRAM_ATTR
+
+#define ARDUINO_BOARD                   "host"
+#define ESP_ARDUINO_VERSION_MAJOR       2
+
+#define DEC                             10
+#define HEX                             16
+
+#define _min(a, b)                      ((a) < (b) ? (a) : (b))
+#define _max(a, b)                      ((a) > (b) ? (a) : (b))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+bool psramFound();
+void* ps_malloc(size_t size);
+
+extern "C" uint32_t esp_get_free_heap_size(void);
+
+/////////////////////////////////////////////////
+
+class IPAddress
+{
+    uint32_t _address;
+
+  public:
+    IPAddress(uint32_t address = 0) : _address(address) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address(a | (b << 8) | (c << 16) | ((uint32_t) d << 24)) {}
+
+    inline operator uint32_t() const { return _address; }
+    inline bool operator==(const IPAddress& other) const { return _address == other._address; }
+    inline bool operator!=(const IPAddress& other) const { return _address != other._address; }
+
+    String toString() const;
+};
+
+/////////////////////////////////////////////////
+
+// Writes to stderr, reads nothing
+class HardwareSerial : public Stream
+{
+  public:
+    inline int available() override { return 0; }
+    inline int read() override { return -1; }
+    inline int peek() override { return -1; }
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+/////////////////////////////////////////////////
+
+class EspClass
+{
+  public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getFreePsram();
+};
+
+extern EspClass ESP;
+
+#endif /* HOST_ARDUINO_H_ */
@@ -0,0 +1,154 @@
+/****************************************************************************************************************************
+  AsyncTCP.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_ASYNCTCP_H_
+#define HOST_ASYNCTCP_H_
+
+// AsyncTCP without a network : the test plays the peer through the host side members, which call
+// the handlers the library registered, and reads what was sent from sent(). Everything added is
+// taken at once, space() is ASYNC_HOST_TCP_SPACE or what setSpace() made it.
+
+#include "Arduino.h"
+
+#include <string>
+
+class AsyncClient;
+
+typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, size_t len, uint32_t time)> AcAckHandler;
+typedef std::function<void(void*, AsyncClient*, int8_t error)> AcErrorHandler;
+typedef std::function<void(void*, AsyncClient*, void *data, size_t len)> AcDataHandler;
+typedef std::function<void(void*, AsyncClient*, uint32_t time)> AcTimeoutHandler;
+
+#define ASYNC_WRITE_FLAG_COPY           0x01
+#define ASYNC_WRITE_FLAG_MORE           0x02
+
+#ifndef ASYNC_HOST_TCP_SPACE
+  #define ASYNC_HOST_TCP_SPACE          5744
+#endif
+
+/////////////////////////////////////////////////
+
+class AsyncClient
+{
+  private:
+    std::string _sent;
+    size_t _adds;
+    size_t _space;
+    bool _closed;
+
+    AcConnectHandler _discCb;
+    void* _discArg;
+    AcDataHandler _dataCb;
+    void* _dataArg;
+    AcAckHandler _ackCb;
+    void* _ackArg;
+    AcConnectHandler _pollCb;
+    void* _pollArg;
+
+  public:
+    AsyncClient() : _adds(0), _space(ASYNC_HOST_TCP_SPACE), _closed(false), _discArg(NULL), _dataArg(NULL), _ackArg(NULL), _pollArg(NULL) {}
+
+    inline size_t space() { return _closed ? 0 : _space; }
+    inline bool canSend() { return !_closed; }
+    inline bool send() { return !_closed; }
+    size_t add(const char* data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+    size_t write(const char* data);
+    size_t write(const char* data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+
+    inline void close(bool now = false) { (void) now; _closed = true; }
+    inline void free() {}
+    inline int8_t abort() { _closed = true; return 0; }
+    inline bool connected() { return !_closed; }
+    inline bool disconnected() { return _closed; }
+    inline void ackLater() {}
+    inline size_t ack(size_t len) { return len; }
+
+    inline void setRxTimeout(uint32_t timeout) { (void) timeout; }
+    inline void setAckTimeout(uint32_t timeout) { (void) timeout; }
+    inline void setNoDelay(bool noDelay) { (void) noDelay; }
+
+    inline void onError(AcErrorHandler cb, void* arg = NULL) { (void) cb; (void) arg; }
+    inline void onTimeout(AcTimeoutHandler cb, void* arg = NULL) { (void) cb; (void) arg; }
+    inline void onAck(AcAckHandler cb, void* arg = NULL) { _ackCb = cb; _ackArg = arg; }
+    inline void onDisconnect(AcConnectHandler cb, void* arg = NULL) { _discCb = cb; _discArg = arg; }
+    inline void onData(AcDataHandler cb, void* arg = NULL) { _dataCb = cb; _dataArg = arg; }
+    inline void onPoll(AcConnectHandler cb, void* arg = NULL) { _pollCb = cb; _pollArg = arg; }
+
+    inline IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+    inline uint16_t remotePort() { return 40000; }
+    inline IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    inline uint16_t localPort() { return 80; }
+    inline const char* stateToString() { return _closed ? "Closed" : "Established"; }
+
+    /////////////////////////////////////////////////
+
+    // Host side : data from the peer, a poll tick, the peer's ACK of len bytes. Like lwIP's pbuf, data
+    // belongs to the caller and may be changed by the handler.
+    void receive(void* data, size_t len);
+    void poll();
+    void acked(size_t len);
+
+    // Host side : the connection is gone. The library's handler deletes the client.
+    void disconnect();
+
+    inline void setSpace(size_t space) { _space = space; }
+    inline const std::string& sent() const { return _sent; }
+    inline size_t adds() const { return _adds; }
+    inline void clearSent() { _sent.clear(); _adds = 0; }
+};
+
+/////////////////////////////////////////////////
+
+class AsyncServer
+{
+  private:
+    uint16_t _port;
+    AcConnectHandler _clientCb;
+    void* _clientArg;
+
+  public:
+    AsyncServer(uint16_t port) : _port(port), _clientArg(NULL) {}
+    ~AsyncServer();
+
+    inline void onClient(AcConnectHandler cb, void* arg) { _clientCb = cb; _clientArg = arg; }
+    void begin();
+    void end();
+    inline void setNoDelay(bool noDelay) { (void) noDelay; }
+
+    // Host side : a new connection to the server listening on port, handed to its client handler.
+    // NULL if there's none.
+    static AsyncClient* connect(uint16_t port);
+};
+
+#endif /* HOST_ASYNCTCP_H_ */
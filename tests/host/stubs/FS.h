@@ -0,0 +1,95 @@
+/****************************************************************************************************************************
+  FS.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_FS_H_
+#define HOST_FS_H_
+
+// A file system with no files : open() returns a closed File and writes go nowhere
+
+#include "Arduino.h"
+
+namespace fs
+{
+
+enum SeekMode
+{
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+/////////////////////////////////////////////////
+
+class File : public Stream
+{
+  public:
+    inline size_t write(uint8_t c) override { (void) c; return 0; }
+    inline size_t write(const uint8_t* buffer, size_t size) override { (void) buffer; (void) size; return 0; }
+    inline int available() override { return 0; }
+    inline int read() override { return -1; }
+    inline int peek() override { return -1; }
+    inline size_t read(uint8_t* buffer, size_t size) { (void) buffer; (void) size; return 0; }
+    inline bool seek(uint32_t pos, SeekMode mode = SeekSet) { (void) pos; (void) mode; return false; }
+    inline size_t position() const { return 0; }
+    inline size_t size() const { return 0; }
+    inline void flush() {}
+    inline void close() {}
+    inline operator bool() const { return false; }
+    inline const char* name() const { return ""; }
+    inline const char* path() const { return ""; }
+    inline bool isDirectory() { return false; }
+    inline File openNextFile(const char* mode = "r") { (void) mode; return File(); }
+};
+
+/////////////////////////////////////////////////
+
+class FS
+{
+  public:
+    inline File open(const char* path, const char* mode = "r", bool create = false) { (void) path; (void) mode; (void) create; return File(); }
+    inline File open(const String& path, const char* mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+    inline bool exists(const char* path) { (void) path; return false; }
+    inline bool exists(const String& path) { return exists(path.c_str()); }
+    inline bool remove(const char* path) { (void) path; return false; }
+    inline bool remove(const String& path) { return remove(path.c_str()); }
+    inline bool rename(const String& from, const String& to) { (void) from; (void) to; return false; }
+    inline bool mkdir(const String& path) { (void) path; return false; }
+    inline bool rmdir(const String& path) { (void) path; return false; }
+};
+
+}   // namespace fs
+
+using fs::FS;
+using fs::File;
+
+#endif /* HOST_FS_H_ */
@@ -0,0 +1,114 @@
+/****************************************************************************************************************************
+  Print.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_PRINT_H_
+#define HOST_PRINT_H_
+
+#include "WString.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/////////////////////////////////////////////////
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+      size_t n = 0;
+
+      while (size--)
+        n += write(*buffer++);
+
+      return n;
+    }
+
+    inline size_t write(const char* s) { return write((const uint8_t*) s, strlen(s)); }
+
+    /////////////////////////////////////////////////
+
+    inline size_t print(const String& s) { return write((const uint8_t*) s.c_str(), s.length()); }
+    inline size_t print(const char* s) { return write(s); }
+    inline size_t print(const __FlashStringHelper* s) { return write((const char*) s); }
+    inline size_t print(char c) { return write((uint8_t) c); }
+
+    template <typename T>
+    inline size_t print(T v) { return print(String(v)); }
+
+    inline size_t println() { return write("\r\n"); }
+
+    template <typename T>
+    inline size_t println(const T& v) { const size_t n = print(v); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)))
+    {
+      char buf[256];
+      va_list args;
+
+      va_start(args, format);
+      const int n = vsnprintf(buf, sizeof(buf), format, args);
+      va_end(args);
+
+      return (n > 0) ? write((const uint8_t*) buf, (size_t) n < sizeof(buf) ? n : sizeof(buf) - 1) : 0;
+    }
+};
+
+/////////////////////////////////////////////////
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(uint8_t* buffer, size_t length)
+    {
+      size_t n = 0;
+      int c;
+
+      while ((n < length) && ((c = read()) >= 0))
+        buffer[n++] = (uint8_t) c;
+
+      return n;
+    }
+
+    inline size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*) buffer, length); }
+};
+
+#endif /* HOST_PRINT_H_ */
@@ -0,0 +1,227 @@
+/****************************************************************************************************************************
+  WString.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_WSTRING_H_
+#define HOST_WSTRING_H_
+
+// Arduino's String over std::string, with the members the library uses. Its small buffer is
+// std::string's, 15 characters with libstdc++, where the ESP32 core keeps 11 inline.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include <string>
+
+class __FlashStringHelper;
+
+#define F(s)      (reinterpret_cast<const __FlashStringHelper *>(s))
+
+/////////////////////////////////////////////////
+
+class String
+{
+    std::string _s;
+
+  public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const __FlashStringHelper* s) : _s(s ? (const char*) s : "") {}
+    String(const String& other) = default;
+    String(String&& other) = default;
+
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) : String((unsigned long) v, base) {}
+    explicit String(int v, unsigned char base = 10) : String((long) v, base) {}
+    explicit String(unsigned int v, unsigned char base = 10) : String((unsigned long) v, base) {}
+    explicit String(long v, unsigned char base = 10) : _s(base == 10 ? std::to_string(v) : _format(v < 0 ? -v : v, base, v < 0)) {}
+    explicit String(unsigned long v, unsigned char base = 10) : _s(_format(v, base, false)) {}
+    explicit String(long long v) : _s(std::to_string(v)) {}
+    explicit String(unsigned long long v) : _s(std::to_string(v)) {}
+    explicit String(double v, unsigned int decimals = 2)
+    {
+      char buf[32];
+
+      snprintf(buf, sizeof(buf), "%.*f", (int) decimals, v);
+      _s = buf;
+    }
+
+    String& operator=(const String& other) = default;
+    String& operator=(String&& other) = default;
+
+    String& operator=(const char* s)
+    {
+      _s = s ? s : "";
+
+      return *this;
+    }
+
+    /////////////////////////////////////////////////
+
+    inline unsigned int length() const { return _s.size(); }
+    inline const char* c_str() const { return _s.c_str(); }
+    inline char* begin() { return &_s[0]; }
+    inline const char* begin() const { return _s.data(); }
+    inline char* end() { return &_s[0] + _s.size(); }
+    inline const char* end() const { return _s.data() + _s.size(); }
+    inline bool reserve(unsigned int size) { _s.reserve(size); return true; }
+    inline explicit operator bool() const { return true; }
+
+    inline char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    inline void setCharAt(unsigned int i, char c) { if (i < _s.size()) _s[i] = c; }
+    inline char operator[](unsigned int i) const { return charAt(i); }
+    inline char& operator[](unsigned int i) { return _s[i]; }
+
+    /////////////////////////////////////////////////
+
+    inline bool concat(const String& s) { _s += s._s; return true; }
+    inline bool concat(const char* s) { if (s) _s += s; return s != NULL; }
+    inline bool concat(const char* s, unsigned int n) { _s.append(s, n); return true; }
+    inline bool concat(char c) { _s += c; return true; }
+    inline bool concat(int v) { return concat(String(v)); }
+    inline bool concat(unsigned int v) { return concat(String(v)); }
+    inline bool concat(long v) { return concat(String(v)); }
+    inline bool concat(unsigned long v) { return concat(String(v)); }
+
+    template <typename T>
+    inline String& operator+=(const T& v) { concat(v); return *this; }
+
+    friend String operator+(const String& a, const String& b) { String r(a); r._s += b._s; return r; }
+    friend String operator+(const String& a, const char* b) { String r(a); r.concat(b); return r; }
+    friend String operator+(const char* a, const String& b) { String r(a); r._s += b._s; return r; }
+    friend String operator+(const String& a, char b) { String r(a); r._s += b; return r; }
+
+    /////////////////////////////////////////////////
+
+    inline bool equals(const String& s) const { return _s == s._s; }
+    inline bool equals(const char* s) const { return _s == (s ? s : ""); }
+    inline bool operator==(const String& s) const { return equals(s); }
+    inline bool operator==(const char* s) const { return equals(s); }
+    inline bool operator!=(const String& s) const { return !equals(s); }
+    inline bool operator!=(const char* s) const { return !equals(s); }
+    inline bool operator<(const String& s) const { return _s < s._s; }
+
+    inline bool equalsIgnoreCase(const String& s) const
+    {
+      return (_s.size() == s._s.size()) && (strcasecmp(_s.c_str(), s._s.c_str()) == 0);
+    }
+
+    inline bool startsWith(const String& s, unsigned int offset = 0) const
+    {
+      return (offset <= _s.size()) && (_s.compare(offset, s._s.size(), s._s) == 0);
+    }
+
+    inline bool endsWith(const String& s) const
+    {
+      return (_s.size() >= s._s.size()) && (_s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0);
+    }
+
+    /////////////////////////////////////////////////
+
+    inline int indexOf(char c, unsigned int from = 0) const { return _index(_s.find(c, from)); }
+    inline int indexOf(const String& s, unsigned int from = 0) const { return _index(_s.find(s._s, from)); }
+    inline int lastIndexOf(char c) const { return _index(_s.rfind(c)); }
+    inline int lastIndexOf(const String& s) const { return _index(_s.rfind(s._s)); }
+
+    inline String substring(unsigned int from) const
+    {
+      return (from < _s.size()) ? String(_s.substr(from).c_str()) : String();
+    }
+
+    inline String substring(unsigned int from, unsigned int to) const
+    {
+      if (from > to)
+        std::swap(from, to);
+
+      return (from < _s.size()) ? String(_s.substr(from, to - from).c_str()) : String();
+    }
+
+    /////////////////////////////////////////////////
+
+    void replace(const String& find, const String& with)
+    {
+      if (find._s.empty())
+        return;
+
+      for (size_t p = 0; (p = _s.find(find._s, p)) != std::string::npos; p += with._s.size())
+        _s.replace(p, find._s.size(), with._s);
+    }
+
+    inline void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    inline void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+
+    void trim()
+    {
+      const size_t first = _s.find_first_not_of(" \t\r\n\v\f");
+
+      if (first == std::string::npos)
+        _s.clear();
+      else
+        _s = _s.substr(first, _s.find_last_not_of(" \t\r\n\v\f") - first + 1);
+    }
+
+    inline void toLowerCase() { for (auto& c : _s) c = tolower((unsigned char) c); }
+    inline void toUpperCase() { for (auto& c : _s) c = toupper((unsigned char) c); }
+    inline long toInt() const { return atol(_s.c_str()); }
+
+  private:
+    static inline int _index(size_t p)
+    {
+      return (p == std::string::npos) ? -1 : (int) p;
+    }
+
+    static std::string _format(unsigned long v, unsigned char base, bool negative)
+    {
+      char buf[8 * sizeof(long) + 2];
+      char* p = buf + sizeof(buf) - 1;
+
+      *p = 0;
+
+      do
+      {
+        const unsigned digit = v % base;
+
+        *--p = (digit < 10) ? '0' + digit : 'a' + digit - 10;
+        v /= base;
+      } while (v);
+
+      if (negative)
+        *--p = '-';
+
+      return p;
+    }
+};
+
+#endif /* HOST_WSTRING_H_ */
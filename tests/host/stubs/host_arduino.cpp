@@ -0,0 +1,537 @@
+/****************************************************************************************************************************
+  host_arduino.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// Implementation of the host Arduino core declared in this directory
+
+#include "Arduino.h"
+#include "AsyncTCP.h"
+#include "WiFi.h"
+#include "esp_partition.h"
+#include "lwip/priv/tcp_priv.h"
+#include "Update.h"
+#include "enc28j60/esp32_enc28j60.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+static size_t hostFreeHeap = 200000;
+
+/////////////////////////////////////////////////
+
+unsigned long millis()
+{
+  return micros() / 1000;
+}
+
+unsigned long micros()
+{
+  static const auto start = std::chrono::steady_clock::now();
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield()
+{
+  std::this_thread::yield();
+}
+
+bool psramFound()
+{
+  return false;
+}
+
+void* ps_malloc(size_t size)
+{
+  return malloc(size);
+}
+
+/////////////////////////////////////////////////
+
+String IPAddress::toString() const
+{
+  char buf[16];
+
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address & 0xff, (_address >> 8) & 0xff, (_address >> 16) & 0xff, _address >> 24);
+
+  return String(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return (fputc(c, stderr) == EOF) ? 0 : 1;
+}
+
+/////////////////////////////////////////////////
+
+extern "C" uint32_t esp_get_free_heap_size(void)
+{
+  return hostFreeHeap;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+  (void) caps;
+
+  return hostFreeHeap;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+  (void) caps;
+
+  return hostFreeHeap;
+}
+
+void hostSetFreeHeap(size_t size)
+{
+  hostFreeHeap = size;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+  return hostFreeHeap;
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+  return hostFreeHeap;
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+  return hostFreeHeap;
+}
+
+uint32_t EspClass::getFreePsram()
+{
+  return 0;
+}
+
+/////////////////////////////////////////////////
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label)
+{
+  (void) type;
+  (void) subtype;
+  (void) label;
+
+  return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size)
+{
+  (void) partition;
+  (void) offset;
+  (void) dst;
+  (void) size;
+
+  return ESP_FAIL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size, esp_partition_mmap_memory_t memory,
+                             const void** out, spi_flash_mmap_handle_t* handle)
+{
+  (void) partition;
+  (void) offset;
+  (void) size;
+  (void) memory;
+  (void) out;
+  (void) handle;
+
+  return ESP_FAIL;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle)
+{
+  (void) handle;
+}
+
+/////////////////////////////////////////////////
+
+ESP32_ENC ETH;
+UpdateClass Update;
+
+ESP32_ENC::ESP32_ENC() : initialized(false), staticIP(false), eth_handle(NULL), started(false), eth_link(0) {}
+ESP32_ENC::~ESP32_ENC() {}
+
+IPAddress ESP32_ENC::localIP()
+{
+  return IPAddress(127, 0, 0, 1);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+size_t AsyncClient::add(const char* data, size_t size, uint8_t apiflags)
+{
+  (void) apiflags;
+
+  if (_closed)
+    return 0;
+
+  _adds++;
+  _sent.append(data, size);
+
+  return size;
+}
+
+size_t AsyncClient::write(const char* data)
+{
+  return write(data, strlen(data));
+}
+
+size_t AsyncClient::write(const char* data, size_t size, uint8_t apiflags)
+{
+  const size_t added = add(data, size, apiflags);
+
+  send();
+
+  return added;
+}
+
+void AsyncClient::receive(void* data, size_t len)
+{
+  if (_dataCb)
+    _dataCb(_dataArg, this, data, len);
+}
+
+void AsyncClient::poll()
+{
+  if (_pollCb)
+    _pollCb(_pollArg, this);
+}
+
+void AsyncClient::acked(size_t len)
+{
+  if (_ackCb)
+    _ackCb(_ackArg, this, len, 0);
+}
+
+void AsyncClient::disconnect()
+{
+  _closed = true;
+
+  if (_discCb)
+    _discCb(_discArg, this);
+  else
+    delete this;
+}
+
+static std::vector<AsyncServer*> hostListening;
+
+AsyncServer::~AsyncServer()
+{
+  end();
+}
+
+void AsyncServer::begin()
+{
+  end();
+  hostListening.push_back(this);
+}
+
+void AsyncServer::end()
+{
+  hostListening.erase(std::remove(hostListening.begin(), hostListening.end(), this), hostListening.end());
+}
+
+AsyncClient* AsyncServer::connect(uint16_t port)
+{
+  for (AsyncServer* server : hostListening)
+  {
+    if ((server->_port == port) && server->_clientCb)
+    {
+      AsyncClient* client = new AsyncClient();
+
+      server->_clientCb(server->_clientArg, client);
+
+      return client;
+    }
+  }
+
+  return NULL;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+static std::recursive_mutex hostCritical;
+
+void portENTER_CRITICAL(portMUX_TYPE* mux)
+{
+  (void) mux;
+  hostCritical.lock();
+}
+
+void portEXIT_CRITICAL(portMUX_TYPE* mux)
+{
+  (void) mux;
+  hostCritical.unlock();
+}
+
+/////////////////////////////////////////////////
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core)
+{
+  (void) name;
+  (void) stackDepth;
+  (void) priority;
+  (void) core;
+
+  std::thread(task, arg).detach();
+
+  if (handle)
+    *handle = NULL;
+
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  (void) task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  delay(ticks);
+}
+
+// Unique per thread, which is all the library compares it for
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+  static thread_local char self;
+
+  return &self;
+}
+
+TickType_t xTaskGetTickCount()
+{
+  return millis();
+}
+
+/////////////////////////////////////////////////
+
+struct HostQueue
+{
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<std::vector<uint8_t>> items;
+  size_t length;
+  size_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  HostQueue* queue = new HostQueue();
+
+  queue->length = length;
+  queue->itemSize = itemSize;
+
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t wait)
+{
+  HostQueue* queue = (HostQueue*) handle;
+
+  (void) wait;
+
+  std::lock_guard<std::mutex> lock(queue->mutex);
+
+  if (queue->items.size() >= queue->length)
+    return pdFALSE;
+
+  queue->items.emplace_back((const uint8_t*) item, (const uint8_t*) item + queue->itemSize);
+  queue->ready.notify_one();
+
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t wait)
+{
+  HostQueue* queue = (HostQueue*) handle;
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  auto available = [queue]
+  {
+    return !queue->items.empty();
+  };
+
+  if (wait == portMAX_DELAY)
+    queue->ready.wait(lock, available);
+  else if (!queue->ready.wait_for(lock, std::chrono::milliseconds(wait), available))
+    return pdFALSE;
+
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle)
+{
+  HostQueue* queue = (HostQueue*) handle;
+  std::lock_guard<std::mutex> lock(queue->mutex);
+
+  return queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t handle)
+{
+  delete (HostQueue*) handle;
+}
+
+/////////////////////////////////////////////////
+
+struct HostSemaphore
+{
+  std::mutex mutex;
+  std::condition_variable ready;
+  bool available;
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+  HostSemaphore* semaphore = new HostSemaphore();
+
+  semaphore->available = false;
+
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+  HostSemaphore* semaphore = new HostSemaphore();
+
+  semaphore->available = true;
+
+  return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t wait)
+{
+  HostSemaphore* semaphore = (HostSemaphore*) handle;
+  std::unique_lock<std::mutex> lock(semaphore->mutex);
+  auto available = [semaphore]
+  {
+    return semaphore->available;
+  };
+
+  if (wait == portMAX_DELAY)
+    semaphore->ready.wait(lock, available);
+  else if (!semaphore->ready.wait_for(lock, std::chrono::milliseconds(wait), available))
+    return pdFALSE;
+
+  semaphore->available = false;
+
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle)
+{
+  HostSemaphore* semaphore = (HostSemaphore*) handle;
+
+  {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+
+    semaphore->available = true;
+  }
+
+  semaphore->ready.notify_one();
+
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t handle)
+{
+  delete (HostSemaphore*) handle;
+}
+
+/////////////////////////////////////////////////
+
+struct tcp_pcb* tcp_active_pcbs = NULL;
+
+static std::mutex hostTcpipMutex;
+static std::deque<std::pair<tcpip_callback_fn, void*>> hostTcpipQueue;
+
+err_t tcpip_try_callback(tcpip_callback_fn function, void* ctx)
+{
+  std::lock_guard<std::mutex> lock(hostTcpipMutex);
+
+  hostTcpipQueue.emplace_back(function, ctx);
+
+  return ERR_OK;
+}
+
+err_t tcpip_callback(tcpip_callback_fn function, void* ctx)
+{
+  return tcpip_try_callback(function, ctx);
+}
+
+int hostRunTcpip()
+{
+  int n = 0;
+
+  for (;;)
+  {
+    std::pair<tcpip_callback_fn, void*> callback;
+
+    {
+      std::lock_guard<std::mutex> lock(hostTcpipMutex);
+
+      if (hostTcpipQueue.empty())
+        return n;
+
+      callback = hostTcpipQueue.front();
+      hostTcpipQueue.pop_front();
+    }
+
+    callback.first(callback.second);
+    n++;
+  }
+}
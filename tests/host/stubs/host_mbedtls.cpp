@@ -0,0 +1,309 @@
+/****************************************************************************************************************************
+  host_mbedtls.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// MD5 (RFC 1321) and SHA-256 (FIPS 180-4) behind the mbedtls calls the library makes, so digest
+// authentication and OTA digests run on the host. Small and slow, for tests only.
+
+#include "mbedtls/md5.h"
+#include "mbedtls/sha256.h"
+
+#include <string.h>
+
+/////////////////////////////////////////////////
+
+static inline uint32_t rotl(uint32_t x, int n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+static inline uint32_t rotr(uint32_t x, int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+/////////////////////////////////////////////////
+
+// Feeds input to block() 64 bytes at a time, the rest waits in buffer
+template <typename Context, typename Block>
+static void hashUpdate(Context* ctx, const unsigned char* input, size_t len, Block block)
+{
+  size_t used = ctx->total & 63;
+
+  ctx->total += len;
+
+  if (used)
+  {
+    const size_t n = (len < 64 - used) ? len : 64 - used;
+
+    memcpy(ctx->buffer + used, input, n);
+    input += n;
+    len -= n;
+
+    if (used + n < 64)
+      return;
+
+    block(ctx, ctx->buffer);
+  }
+
+  for (; len >= 64; input += 64, len -= 64)
+    block(ctx, input);
+
+  memcpy(ctx->buffer, input, len);
+}
+
+/////////////////////////////////////////////////
+
+// 0x80, zeros, and the length in bits : little endian for MD5, big endian for SHA-256
+template <typename Context, typename Block>
+static void hashPad(Context* ctx, bool bigEndian, Block block)
+{
+  const uint64_t bits = ctx->total * 8;
+  unsigned char pad[72] = { 0x80 };
+  const size_t used = ctx->total & 63;
+  const size_t padLen = (used < 56) ? (56 - used) : (120 - used);
+
+  for (int i = 0; i < 8; i++)
+    pad[padLen + i] = (unsigned char) (bits >> (bigEndian ? (56 - 8 * i) : (8 * i)));
+
+  hashUpdate(ctx, pad, padLen + 8, block);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+static void md5Block(mbedtls_md5_context* ctx, const unsigned char* data)
+{
+  static const uint32_t K[64] =
+  {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+  };
+
+  static const int R[64] =
+  {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+  };
+
+  uint32_t M[16];
+
+  for (int i = 0; i < 16; i++)
+    M[i] = data[4 * i] | (data[4 * i + 1] << 8) | (data[4 * i + 2] << 16) | ((uint32_t) data[4 * i + 3] << 24);
+
+  uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+
+  for (int i = 0; i < 64; i++)
+  {
+    uint32_t f;
+    int g;
+
+    if (i < 16)
+    {
+      f = (b & c) | (~b & d);
+      g = i;
+    }
+    else if (i < 32)
+    {
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) & 15;
+    }
+    else if (i < 48)
+    {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) & 15;
+    }
+    else
+    {
+      f = c ^ (b | ~d);
+      g = (7 * i) & 15;
+    }
+
+    const uint32_t t = d;
+
+    d = c;
+    c = b;
+    b = b + rotl(a + f + K[i] + M[g], R[i]);
+    a = t;
+  }
+
+  ctx->state[0] += a;
+  ctx->state[1] += b;
+  ctx->state[2] += c;
+  ctx->state[3] += d;
+}
+
+/////////////////////////////////////////////////
+
+static void sha256Block(mbedtls_sha256_context* ctx, const unsigned char* data)
+{
+  static const uint32_t K[64] =
+  {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+  };
+
+  uint32_t W[64];
+
+  for (int i = 0; i < 16; i++)
+    W[i] = ((uint32_t) data[4 * i] << 24) | (data[4 * i + 1] << 16) | (data[4 * i + 2] << 8) | data[4 * i + 3];
+
+  for (int i = 16; i < 64; i++)
+  {
+    const uint32_t s0 = rotr(W[i - 15], 7) ^ rotr(W[i - 15], 18) ^ (W[i - 15] >> 3);
+    const uint32_t s1 = rotr(W[i - 2], 17) ^ rotr(W[i - 2], 19) ^ (W[i - 2] >> 10);
+
+    W[i] = W[i - 16] + s0 + W[i - 7] + s1;
+  }
+
+  uint32_t h[8];
+
+  memcpy(h, ctx->state, sizeof(h));
+
+  for (int i = 0; i < 64; i++)
+  {
+    const uint32_t S1 = rotr(h[4], 6) ^ rotr(h[4], 11) ^ rotr(h[4], 25);
+    const uint32_t ch = (h[4] & h[5]) ^ (~h[4] & h[6]);
+    const uint32_t t1 = h[7] + S1 + ch + K[i] + W[i];
+    const uint32_t S0 = rotr(h[0], 2) ^ rotr(h[0], 13) ^ rotr(h[0], 22);
+    const uint32_t maj = (h[0] & h[1]) ^ (h[0] & h[2]) ^ (h[1] & h[2]);
+
+    memmove(h + 1, h, 7 * sizeof(uint32_t));
+    h[4] += t1;
+    h[0] = t1 + S0 + maj;
+  }
+
+  for (int i = 0; i < 8; i++)
+    ctx->state[i] += h[i];
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+
+extern "C"
+{
+  void mbedtls_md5_init(mbedtls_md5_context* ctx)
+  {
+    memset(ctx, 0, sizeof(*ctx));
+  }
+
+  void mbedtls_md5_free(mbedtls_md5_context* ctx)
+  {
+    memset(ctx, 0, sizeof(*ctx));
+  }
+
+  int mbedtls_md5_starts_ret(mbedtls_md5_context* ctx)
+  {
+    static const uint32_t init[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+    memcpy(ctx->state, init, sizeof(init));
+    ctx->total = 0;
+
+    return 0;
+  }
+
+  int mbedtls_md5_update_ret(mbedtls_md5_context* ctx, const unsigned char* input, size_t len)
+  {
+    hashUpdate(ctx, input, len, md5Block);
+
+    return 0;
+  }
+
+  int mbedtls_md5_finish_ret(mbedtls_md5_context* ctx, unsigned char output[16])
+  {
+    hashPad(ctx, false, md5Block);
+
+    for (int i = 0; i < 16; i++)
+      output[i] = (unsigned char) (ctx->state[i / 4] >> (8 * (i % 4)));
+
+    return 0;
+  }
+
+  /////////////////////////////////////////////////
+
+  void mbedtls_sha256_init(mbedtls_sha256_context* ctx)
+  {
+    memset(ctx, 0, sizeof(*ctx));
+  }
+
+  void mbedtls_sha256_free(mbedtls_sha256_context* ctx)
+  {
+    memset(ctx, 0, sizeof(*ctx));
+  }
+
+  int mbedtls_sha256_starts_ret(mbedtls_sha256_context* ctx, int is224)
+  {
+    static const uint32_t init[8] =
+    {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    if (is224)
+      return -1;
+
+    memcpy(ctx->state, init, sizeof(init));
+    ctx->total = 0;
+
+    return 0;
+  }
+
+  int mbedtls_sha256_update_ret(mbedtls_sha256_context* ctx, const unsigned char* input, size_t len)
+  {
+    hashUpdate(ctx, input, len, sha256Block);
+
+    return 0;
+  }
+
+  int mbedtls_sha256_finish_ret(mbedtls_sha256_context* ctx, unsigned char output[32])
+  {
+    hashPad(ctx, true, sha256Block);
+
+    for (int i = 0; i < 32; i++)
+      output[i] = (unsigned char) (ctx->state[i / 4] >> (24 - 8 * (i % 4)));
+
+    return 0;
+  }
+}
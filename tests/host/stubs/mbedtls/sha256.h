@@ -0,0 +1,58 @@
+/****************************************************************************************************************************
+  sha256.h - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+#ifndef HOST_MBEDTLS_SHA256_H_
+#define HOST_MBEDTLS_SHA256_H_
+
+// The mbedtls 2.x calls the library makes, implemented in host_mbedtls.cpp. SHA-224 isn't.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t state[8];
+  uint64_t total;
+  unsigned char buffer[64];
+} mbedtls_sha256_context;
+
+extern "C"
+{
+  void mbedtls_sha256_init(mbedtls_sha256_context* ctx);
+  void mbedtls_sha256_free(mbedtls_sha256_context* ctx);
+  int mbedtls_sha256_starts_ret(mbedtls_sha256_context* ctx, int is224);
+  int mbedtls_sha256_update_ret(mbedtls_sha256_context* ctx, const unsigned char* input, size_t len);
+  int mbedtls_sha256_finish_ret(mbedtls_sha256_context* ctx, unsigned char output[32]);
+}
+
+#endif /* HOST_MBEDTLS_SHA256_H_ */
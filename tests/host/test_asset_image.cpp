@@ -0,0 +1,190 @@
+/****************************************************************************************************************************
+  test_asset_image.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+// Packs a directory with utils/build_asset_image.py and reads it back through the host (mmap) backend
+
+#include "AsyncAssetImage.h"
+#include "host_test.h"
+
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/////////////////////////////////////////////////
+
+static std::string dir;
+
+static void writeFile(const char* name, const std::string& content)
+{
+  std::string path = dir + "/" + name;
+  FILE* f = fopen(path.c_str(), "wb");
+
+  CHECK(f != NULL);
+
+  if (f)
+  {
+    fwrite(content.data(), 1, content.size(), f);
+    fclose(f);
+  }
+}
+
+/////////////////////////////////////////////////
+
+static bool build(const char* image, const char* options)
+{
+  std::string cmd = std::string("python3 ") + HOST_TEST_ROOT "/utils/build_asset_image.py " + dir + "/data " + image
+                    + " " + options + " > /dev/null";
+
+  return system(cmd.c_str()) == 0;
+}
+
+/////////////////////////////////////////////////
+
+static std::string content(const AsyncAssetImage& image, const AsyncAssetImageEntry* entry)
+{
+  return std::string((const char*) image.data(entry), entry->dataLength);
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  char tmpl[] = "/tmp/asset_image_XXXXXX";
+
+  CHECK(mkdtemp(tmpl) != NULL);
+  dir = tmpl;
+
+  mkdir((dir + "/data").c_str(), 0700);
+  mkdir((dir + "/data/js").c_str(), 0700);
+
+  const std::string html = "<html><body>hello</body></html>";
+  const std::string plainJs = "console.log('plain');";
+  const std::string gzipJs = std::string("\x1f\x8b\x08\x00", 4) + "precompressed";
+  const std::string logo = std::string("\x89PNG\r\n\x1a\n", 8) + std::string(100, '\0');
+
+  writeFile("data/index.html", html);
+  writeFile("data/js/app.js", plainJs);
+  writeFile("data/js/app.js.gz", gzipJs);
+  writeFile("data/style.css.gz", "css");
+  writeFile("data/logo.png", logo);
+  writeFile("data/blob.xyz", "unknown type");
+
+  const std::string imagePath = dir + "/assets.bin";
+
+  CHECK(build(imagePath.c_str(), ""));
+
+  AsyncAssetImage image;
+
+  CHECK(!image.begin((dir + "/missing.bin").c_str()));
+  CHECK(image.begin(imagePath.c_str()));
+  CHECK(image.mapped());
+  CHECK(image.count() == 5);
+
+  // Entries are sorted for the binary search
+  for (size_t i = 1; i < image.count(); i++)
+    CHECK(strcmp(image.path(image.entry(i - 1)), image.path(image.entry(i))) < 0);
+
+  const AsyncAssetImageEntry* e = image.find("/index.html");
+
+  CHECK(e && content(image, e) == html);
+  CHECK(e && !(e->flags & ASYNC_ASSET_FLAG_GZIP));
+  CHECK(e && image.mime(e) && !strcmp(image.mime(e), "text/html"));
+
+  // The precompressed file replaces the plain one under the plain name
+  e = image.find("/js/app.js");
+
+  CHECK(e && content(image, e) == gzipJs);
+  CHECK(e && (e->flags & ASYNC_ASSET_FLAG_GZIP));
+  CHECK(e && image.mime(e) && !strcmp(image.mime(e), "application/javascript"));
+  CHECK(image.find("/js/app.js.gz") == NULL);
+
+  e = image.find("/style.css");
+
+  CHECK(e && (e->flags & ASYNC_ASSET_FLAG_GZIP) && content(image, e) == "css");
+  CHECK(image.find("/style.css.gz") == NULL);
+
+  e = image.find("/logo.png");
+
+  CHECK(e && content(image, e) == logo);
+  CHECK(e && ((uintptr_t) image.data(e) % 4) == 0);
+
+  // Left for AsyncWebMimeTypes at runtime
+  e = image.find("/blob.xyz");
+
+  CHECK(e && image.mime(e) == NULL);
+
+  // Length-bounded lookups, prefixes of existing paths don't match
+  CHECK(image.find("/index.html?x=1", 11) != NULL);
+  CHECK(image.find("/index.htm") == NULL);
+  CHECK(image.find("/index.html2") == NULL);
+  CHECK(image.find("/") == NULL);
+
+  // Same checks on an image that is already addressable, then on a corrupted copy
+  std::string copy(image.size(), '\0');
+  memcpy(&copy[0], image.data(image.entry(0)) - image.entry(0)->dataOffset, image.size());
+
+  image.end();
+  CHECK(!image.mapped());
+
+  AsyncAssetImage linked;
+
+  CHECK(linked.begin(copy.data(), copy.size()));
+  CHECK(linked.find("/logo.png") != NULL);
+
+  AsyncAssetImageEntry* first = (AsyncAssetImageEntry*) (&copy[0] + ((AsyncAssetImageHeader*) &copy[0])->entriesOffset);
+  first->dataLength = copy.size();
+
+  CHECK(!linked.begin(copy.data(), copy.size()));
+  CHECK(!linked.begin(copy.data(), 16));
+
+  // With --gzip, compressible files that shrink are stored compressed
+  writeFile("data/big.txt", std::string(4000, 'a'));
+
+  CHECK(build(imagePath.c_str(), "--gzip"));
+  CHECK(image.begin(imagePath.c_str()));
+
+  e = image.find("/big.txt");
+
+  CHECK(e && (e->flags & ASYNC_ASSET_FLAG_GZIP) && e->dataLength < 4000);
+
+  e = image.find("/logo.png");
+
+  CHECK(e && !(e->flags & ASYNC_ASSET_FLAG_GZIP));
+
+  image.end();
+
+  std::string cmd = "rm -rf " + dir;
+  CHECK(system(cmd.c_str()) == 0);
+
+  return hostTestResult("asset_image");
+}
@@ -0,0 +1,202 @@
+/****************************************************************************************************************************
+  test_deflate.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+// Round trips AsyncWebDeflate output through zlib's inflate, for both framings, many input shapes and
+// the ways a response can slice its input, and checks the Accept-Encoding parsing.
+
+#include "deflate_corpus.h"
+#include "host_test.h"
+
+#include <zlib.h>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+static bool inflateAll(const std::string& in, AsyncWebEncoding encoding, std::string& out)
+{
+  z_stream zs = {};
+
+  // 16 + : gzip framing only, plain : zlib framing only
+  if (inflateInit2(&zs, (encoding == ASYNC_ENCODING_GZIP) ? 16 + 15 : 15) != Z_OK)
+    return false;
+
+  zs.next_in = (Bytef*) in.data();
+  zs.avail_in = in.size();
+  out.clear();
+
+  int ret;
+  char buf[4096];
+
+  do
+  {
+    zs.next_out = (Bytef*) buf;
+    zs.avail_out = sizeof(buf);
+    ret = inflate(&zs, Z_NO_FLUSH);
+    out.append(buf, sizeof(buf) - zs.avail_out);
+  } while (ret == Z_OK);
+
+  // The whole input must be one complete stream, trailer included
+  const bool ok = (ret == Z_STREAM_END) && (zs.avail_in == 0);
+
+  inflateEnd(&zs);
+
+  return ok;
+}
+
+/////////////////////////////////////////////////
+
+static void roundTrip(const std::string& input, size_t slice, size_t drain)
+{
+  const AsyncWebEncoding encodings[] = { ASYNC_ENCODING_GZIP, ASYNC_ENCODING_DEFLATE };
+
+  for (AsyncWebEncoding encoding : encodings)
+  {
+    std::string packed = deflateAll(input, encoding, slice, drain);
+    std::string unpacked;
+
+    CHECK(!packed.empty());
+
+    const bool ok = inflateAll(packed, encoding, unpacked) && (unpacked == input);
+
+    if (!ok)
+      fprintf(stderr, "round trip failed: %zu bytes, encoding %d, slice %zu, drain %zu\n", input.size(), encoding, slice, drain);
+
+    CHECK(ok);
+  }
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  std::vector<std::string> inputs =
+  {
+    "",
+    "a",
+    "ab",
+    "abc",
+    std::string(3, 'x'),
+    std::string(258, 'x'),
+    std::string(259, 'x'),
+    std::string(100000, 'x'),
+    corpusHtml(5),
+    corpusHtml(400),
+    corpusJson(300),
+    corpusRandom(1, 1),
+    corpusRandom(ASYNC_DEFLATE_INPUT_SIZE, 2),
+    corpusRandom(20000, 3),
+  };
+
+  // Repeats at every distance around the window size
+  for (size_t distance : { (size_t) 1, (size_t) 2, (size_t) 257, (size_t) ASYNC_DEFLATE_WINDOW_SIZE - 1,
+                           (size_t) ASYNC_DEFLATE_WINDOW_SIZE, (size_t) ASYNC_DEFLATE_WINDOW_SIZE + 1 })
+  {
+    std::string unit = corpusRandom(distance, distance);
+    std::string s;
+
+    while (s.size() < 4 * ASYNC_DEFLATE_WINDOW_SIZE + 300)
+      s += unit;
+
+    inputs.push_back(s);
+  }
+
+  // Text mixed with incompressible runs
+  inputs.push_back(corpusHtml(50) + corpusRandom(3000, 4) + corpusHtml(50) + corpusJson(40));
+
+  const size_t slices[] = { ASYNC_DEFLATE_INPUT_SIZE, 1, 7, 100, ASYNC_DEFLATE_INPUT_SIZE - 1 };
+  const size_t drains[] = { 1460, 1, 64 };
+
+  for (const std::string& input : inputs)
+  {
+    for (size_t slice : slices)
+    {
+      for (size_t drain : drains)
+      {
+        // Byte-sized slices and drains are slow on the large inputs and add nothing there
+        if ((slice < 7 || drain < 64) && input.size() > 20000)
+          continue;
+
+        roundTrip(input, slice, drain);
+      }
+    }
+  }
+
+  // Counters
+  AsyncWebDeflate deflate;
+  std::string html = corpusHtml(100);
+  std::string packed = deflateAll(html, ASYNC_ENCODING_GZIP);
+
+  CHECK(packed.size() < html.size() / 3);
+
+  CHECK(deflate.begin(ASYNC_ENCODING_DEFLATE));
+  CHECK(deflate.encoding() == ASYNC_ENCODING_DEFLATE);
+  CHECK(!deflate.done());
+
+  // The stream header has to be read first
+  uint8_t buf[64];
+  size_t room;
+  size_t n = deflate.read(buf, sizeof(buf));
+
+  CHECK(n == 2);
+  deflate.inputBuffer(room);
+  CHECK(room == ASYNC_DEFLATE_INPUT_SIZE);
+
+  // No more input until the output is drained
+  memcpy(deflate.inputBuffer(room), "hello", 5);
+  deflate.commit(5);
+  deflate.finish();
+  CHECK(deflate.available() > 0);
+  deflate.inputBuffer(room);
+  CHECK(room == 0);
+  CHECK(deflate.totalIn() == 5);
+
+  n += deflate.read(buf, sizeof(buf));
+  CHECK(deflate.done());
+  CHECK(deflate.totalOut() == n);
+
+  // Accept-Encoding
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("gzip, deflate, br") == (ASYNC_ENCODING_GZIP | ASYNC_ENCODING_DEFLATE));
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("GZip;q=0.5") == ASYNC_ENCODING_GZIP);
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("gzip;q=0, deflate") == ASYNC_ENCODING_DEFLATE);
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("gzip;q=0.0") == ASYNC_ENCODING_NONE);
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("identity") == ASYNC_ENCODING_NONE);
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("x-gzip-foo, br") == ASYNC_ENCODING_NONE);
+  CHECK(AsyncWebDeflate::parseAcceptEncoding("") == ASYNC_ENCODING_NONE);
+
+  CHECK(AsyncWebDeflate::select(ASYNC_ENCODING_GZIP | ASYNC_ENCODING_DEFLATE) == ASYNC_ENCODING_GZIP);
+  CHECK(AsyncWebDeflate::select(ASYNC_ENCODING_DEFLATE) == ASYNC_ENCODING_DEFLATE);
+  CHECK(AsyncWebDeflate::select(ASYNC_ENCODING_NONE) == ASYNC_ENCODING_NONE);
+  CHECK(!strcmp(AsyncWebDeflate::name(ASYNC_ENCODING_GZIP), "gzip"));
+  CHECK(!strcmp(AsyncWebDeflate::name(ASYNC_ENCODING_DEFLATE), "deflate"));
+
+  return hostTestResult("deflate");
+}
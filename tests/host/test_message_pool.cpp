@@ -0,0 +1,137 @@
+/****************************************************************************************************************************
+  test_message_pool.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// AsyncWebMessagePool over the host core in stubs/ : payloads go to the smallest size class with
+// room, a miss is only counted when one goes to the heap, blocks are told apart from heap memory
+// by any thread while the slabs are set up.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncWebMessagePool.h"
+#include "host_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+// Released by a thread started before begin() : a heap block is never taken for a slab block
+static void testOwnsBeforeBegin()
+{
+  std::atomic<bool> stop(false);
+
+  std::thread other([&]
+  {
+    while (!stop.load())
+    {
+      void* p = malloc(16);
+
+      // Must go back to the heap, not into a free list
+      AsyncWebMessagePool::freePayload(p);
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  AsyncWebMessagePool::begin();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  stop = true;
+  other.join();
+
+  for (uint8_t i = ASYNC_WEB_POOL_OBJECTS; i < ASYNC_WEB_POOL_COUNT; i++)
+  {
+    AsyncWebSlabStats s = AsyncWebMessagePool::stats((AsyncWebPoolId) i);
+
+    CHECK(s.available == s.count);
+  }
+}
+
+/////////////////////////////////////////////////
+
+static void testPayloadMisses()
+{
+  std::vector<void*> small, medium;
+
+  for (int i = 0; i < ASYNC_WEB_MSG_POOL_SMALL; i++)
+    small.push_back(AsyncWebMessagePool::allocPayload(16));
+
+  // Small slab empty : the medium one takes it, nothing went to the heap
+  for (int i = 0; i < ASYNC_WEB_MSG_POOL_MEDIUM; i++)
+    medium.push_back(AsyncWebMessagePool::allocPayload(16));
+
+  AsyncWebSlabStats s = AsyncWebMessagePool::stats(ASYNC_WEB_POOL_SMALL);
+  AsyncWebSlabStats m = AsyncWebMessagePool::stats(ASYNC_WEB_POOL_MEDIUM);
+
+  CHECK(s.hits == ASYNC_WEB_MSG_POOL_SMALL);
+  CHECK(s.misses == 0);
+  CHECK(m.hits == ASYNC_WEB_MSG_POOL_MEDIUM);
+  CHECK(m.misses == 0);
+
+  // Both empty : the heap, a miss of the small class only
+  void* heap = AsyncWebMessagePool::allocPayload(16);
+  void* large = AsyncWebMessagePool::allocPayload(100);
+
+  s = AsyncWebMessagePool::stats(ASYNC_WEB_POOL_SMALL);
+  m = AsyncWebMessagePool::stats(ASYNC_WEB_POOL_MEDIUM);
+
+  CHECK(s.misses == 1);
+  CHECK(m.misses == 1);
+
+  // Too large for any class isn't a miss
+  void* huge = AsyncWebMessagePool::allocPayload(ASYNC_WEB_MSG_POOL_MEDIUM_SIZE + 1);
+
+  CHECK(AsyncWebMessagePool::stats(ASYNC_WEB_POOL_MEDIUM).misses == 1);
+
+  AsyncWebMessagePool::freePayload(heap);
+  AsyncWebMessagePool::freePayload(large);
+  AsyncWebMessagePool::freePayload(huge);
+
+  for (void* p : small)
+    AsyncWebMessagePool::freePayload(p);
+
+  for (void* p : medium)
+    AsyncWebMessagePool::freePayload(p);
+
+  CHECK(AsyncWebMessagePool::stats(ASYNC_WEB_POOL_SMALL).available == ASYNC_WEB_MSG_POOL_SMALL);
+  CHECK(AsyncWebMessagePool::stats(ASYNC_WEB_POOL_MEDIUM).available == ASYNC_WEB_MSG_POOL_MEDIUM);
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  testOwnsBeforeBegin();
+  testPayloadMisses();
+
+  return hostTestResult("message_pool");
+}
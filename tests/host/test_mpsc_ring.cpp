@@ -0,0 +1,175 @@
+/****************************************************************************************************************************
+  test_mpsc_ring.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// AsyncMpscRing with many producer threads and one consumer : nothing is lost or duplicated, each
+// producer's items come out in the order it pushed them, and a full ring refuses and counts.
+
+#include "AsyncMpscRing.h"
+#include "host_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+#define PRODUCERS       8
+
+// Producer in the top byte, its sequence number below
+typedef uint32_t Item;
+
+/////////////////////////////////////////////////
+
+static void testSingleTask()
+{
+  AsyncMpscRing<int, 4> ring;
+  int item;
+
+  CHECK(ring.empty());
+  CHECK(!ring.pop(item));
+
+  for (int i = 0; i < 4; i++)
+    CHECK(ring.push(i));
+
+  CHECK(!ring.push(4));
+  CHECK(ring.dropped() == 1);
+
+  // Wraps around several times
+  for (int i = 0; i < 40; i++)
+  {
+    CHECK(ring.pop(item));
+    CHECK(item == i);
+    CHECK(ring.push(i + 4));
+  }
+
+  for (int i = 40; i < 44; i++)
+  {
+    CHECK(ring.pop(item));
+    CHECK(item == i);
+  }
+
+  CHECK(ring.empty());
+  CHECK(ring.dropped() == 1);
+}
+
+/////////////////////////////////////////////////
+
+template <size_t N>
+static void testProducers(const char* name, uint32_t perProducer)
+{
+  static AsyncMpscRing<Item, N> ring;
+  std::atomic<int> running(PRODUCERS);
+  std::atomic<uint64_t> refused(0);
+  std::vector<std::thread> producers;
+
+  const double start = hostTestNow();
+
+  for (uint32_t p = 0; p < PRODUCERS; p++)
+  {
+    producers.emplace_back([&, p]()
+    {
+      uint64_t full = 0;
+
+      for (uint32_t i = 0; i < perProducer; i++)
+      {
+        // A refused item is still ours, try again once the consumer made room
+        while (!ring.push((p << 24) | i))
+        {
+          full++;
+          std::this_thread::yield();
+        }
+      }
+
+      refused += full;
+      running--;
+    });
+  }
+
+  // The consumer, as the async_tcp task draining the ring
+  std::vector<uint32_t> next(PRODUCERS, 0);
+  uint64_t received = 0;
+  bool ordered = true;
+  Item item;
+
+  while (running.load() || !ring.empty())
+  {
+    if (!ring.pop(item))
+    {
+      std::this_thread::yield();
+
+      continue;
+    }
+
+    const uint32_t p = item >> 24;
+    const uint32_t i = item & 0xffffff;
+
+    if ((p >= PRODUCERS) || (i != next[p]))
+      ordered = false;
+    else
+      next[p]++;
+
+    received++;
+  }
+
+  for (auto& t : producers)
+    t.join();
+
+  while (ring.pop(item))
+    received++;
+
+  const double elapsed = hostTestNow() - start;
+
+  CHECK(ordered);
+  CHECK(received == (uint64_t) PRODUCERS * perProducer);
+  CHECK(ring.dropped() == refused.load());
+
+  for (uint32_t p = 0; p < PRODUCERS; p++)
+    CHECK(next[p] == perProducer);
+
+  printf("  %-10s %d producers x %u items, %.1f M items/s, %llu pushes refused while full\n", name, PRODUCERS,
+         (unsigned) perProducer, received / elapsed / 1e6, (unsigned long long) refused.load());
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  testSingleTask();
+
+  // The default sizes of the WebSocket and SSE rings, and a tiny one to stay full most of the time
+  testProducers<16>("ring 16", 200000);
+  testProducers<2>("ring 2", 20000);
+  testProducers<1024>("ring 1024", 200000);
+
+  return hostTestResult("mpsc_ring");
+}
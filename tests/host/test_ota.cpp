@@ -0,0 +1,194 @@
+/****************************************************************************************************************************
+  test_ota.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// Uploads through AsyncOtaHandler into an AsyncOtaFileTarget image, over the host core in stubs/ :
+// a raw body and a multipart form, with and without a matching SHA-256 / MD5 digest.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "AsyncOtaHandler.h"
+#include "host_test.h"
+#include "lwip/tcpip.h"
+
+#include <string>
+#include <thread>
+
+#define OTA_IMAGE_PATH        "test_ota.bin"
+
+// 20000 bytes of (i * 31 + 7) : several flash buffers and a partial one, no CRLF in it
+#define OTA_IMAGE_SHA256      "f8aed270a592b255d90b04785c0b130a968ae204948fc2755db1861c810c6c83"
+#define OTA_IMAGE_MD5         "420a33bca71c3ff5c4d1096376a4ac59"
+
+static std::string image;
+
+/////////////////////////////////////////////////
+
+static std::string readImage()
+{
+  std::string data;
+  FILE* f = fopen(OTA_IMAGE_PATH, "rb");
+
+  if (!f)
+    return data;
+
+  char buf[1024];
+  size_t n;
+
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    data.append(buf, n);
+
+  fclose(f);
+
+  return data;
+}
+
+/////////////////////////////////////////////////
+
+// Sends the request in segments of one MSS, then polls until the answer is out
+static std::string upload(const std::string& request)
+{
+  AsyncClient* client = AsyncServer::connect(80);
+
+  for (size_t pos = 0; pos < request.size(); pos += 1460)
+  {
+    std::string segment = request.substr(pos, 1460);
+
+    client->receive(&segment[0], segment.size());
+  }
+
+  const uint32_t start = millis();
+
+  while (client->sent().empty() && (millis() - start < 5000))
+  {
+    hostRunTcpip();
+    client->poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  const std::string sent = client->sent();
+
+  client->disconnect();
+
+  return sent;
+}
+
+/////////////////////////////////////////////////
+
+static std::string raw(const char* query, const char* header)
+{
+  return std::string("POST /update") + query + " HTTP/1.1\r\n"
+         "Content-Type: application/octet-stream\r\n"
+         "Content-Length: " + std::to_string(image.size()) + "\r\n" + header + "\r\n" + image;
+}
+
+/////////////////////////////////////////////////
+
+static std::string multipart(const char* header)
+{
+  const std::string body = "--xyz\r\n"
+                           "Content-Disposition: form-data; name=\"firmware\"; filename=\"fw.bin\"\r\n"
+                           "Content-Type: application/octet-stream\r\n\r\n" + image + "\r\n--xyz--\r\n";
+
+  return std::string("POST /update HTTP/1.1\r\n"
+                     "Content-Type: multipart/form-data; boundary=xyz\r\n"
+                     "Content-Length: ") + std::to_string(body.size()) + "\r\n" + header + "\r\n" + body;
+}
+
+/////////////////////////////////////////////////
+
+static void checkWritten(const std::string& sent)
+{
+  CHECK(sent.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+  CHECK(readImage() == image);
+
+  remove(OTA_IMAGE_PATH);
+}
+
+/////////////////////////////////////////////////
+
+static void checkRefused(const std::string& sent)
+{
+  CHECK(sent.compare(0, 12, "HTTP/1.1 500") == 0);
+  CHECK(sent.find("checksum mismatch") != std::string::npos);
+
+  // The file target removes an abandoned image
+  FILE* f = fopen(OTA_IMAGE_PATH, "rb");
+
+  CHECK(f == NULL);
+
+  if (f)
+    fclose(f);
+}
+
+/////////////////////////////////////////////////
+
+static void testRaw()
+{
+  checkWritten(upload(raw("", "")));
+  checkWritten(upload(raw("", "X-Update-SHA256: " OTA_IMAGE_SHA256 "\r\n")));
+  checkWritten(upload(raw("?md5=" OTA_IMAGE_MD5, "")));
+
+  checkRefused(upload(raw("", "X-Update-SHA256: " OTA_IMAGE_MD5 OTA_IMAGE_MD5 "\r\n")));
+  checkRefused(upload(raw("", "X-Update-MD5: 0123456789abcdef0123456789abcdef\r\n")));
+}
+
+/////////////////////////////////////////////////
+
+static void testMultipart()
+{
+  checkWritten(upload(multipart("")));
+  checkWritten(upload(multipart("X-Update-SHA256: " OTA_IMAGE_SHA256 "\r\n")));
+  checkWritten(upload(multipart("X-Update-MD5: " OTA_IMAGE_MD5 "\r\n")));
+
+  checkRefused(upload(multipart("X-Update-SHA256: " OTA_IMAGE_MD5 OTA_IMAGE_MD5 "\r\n")));
+  checkRefused(upload(multipart("X-Update-MD5: 0123456789abcdef0123456789abcdef\r\n")));
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  for (size_t i = 0; i < 20000; i++)
+    image += (char) (i * 31 + 7);
+
+  remove(OTA_IMAGE_PATH);
+
+  AsyncWebServer server(80);
+
+  server.addHandler(new AsyncOtaHandler("/update", new AsyncOtaFileTarget(OTA_IMAGE_PATH)));
+  server.begin();
+
+  testRaw();
+  testMultipart();
+
+  return hostTestResult("ota");
+}
@@ -0,0 +1,259 @@
+/****************************************************************************************************************************
+  test_responses.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// Responses through the library's request and response code, over the host core in stubs/ : what
+// reaches the client when the send window is short.
+
+#include "AsyncWebServer_ESP32_ENC.h"
+#include "host_test.h"
+#include "lwip/tcpip.h"
+
+#include <string>
+#include <thread>
+
+/////////////////////////////////////////////////
+
+static AsyncClient* request(const char* text, size_t space)
+{
+  AsyncClient* client = AsyncServer::connect(80);
+  std::string buffer = text;
+
+  client->setSpace(space);
+  client->receive(&buffer[0], buffer.size());
+
+  return client;
+}
+
+/////////////////////////////////////////////////
+
+static size_t headLength(const std::string& sent)
+{
+  const size_t end = sent.find("\r\n\r\n");
+
+  return (end == std::string::npos) ? 0 : end + 4;
+}
+
+/////////////////////////////////////////////////
+
+// Room for the head but not for a chunk : nothing goes out, then head and body together
+static void testChunkedHeadWithoutRoom()
+{
+  AsyncClient* client = request("GET /chunked HTTP/1.1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+  const size_t head = headLength(client->sent());
+
+  CHECK(head > 0);
+  client->disconnect();
+
+  for (size_t extra = 0; extra <= 8; extra++)
+  {
+    client = request("GET /chunked HTTP/1.1\r\n\r\n", head + extra);
+
+    CHECK(client->sent().empty());
+
+    client->setSpace(ASYNC_HOST_TCP_SPACE);
+    client->poll();
+
+    const std::string& sent = client->sent();
+
+    CHECK(sent.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    CHECK(headLength(sent) == head);
+    CHECK(sent.find("hello") != std::string::npos);
+
+    client->disconnect();
+  }
+}
+
+/////////////////////////////////////////////////
+
+// A plain status reply goes out in one add(), and answers the request : the second send is dropped
+static void testCannedAnswers()
+{
+  AsyncClient* client = request("GET /canned HTTP/1.1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+  const std::string& sent = client->sent();
+
+  CHECK(client->adds() == 1);
+  CHECK(sent.compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+  CHECK(headLength(sent) == sent.size());
+  CHECK(sent.find("Content-Length: 0\r\n") != std::string::npos);
+  CHECK(sent.find("late") == std::string::npos);
+
+  client->poll();
+  CHECK(client->adds() == 1);
+
+  client->disconnect();
+
+  // No room for the whole reply : the response object sends what fits, the rest later
+  client = request("GET /canned HTTP/1.1\r\n\r\n", 16);
+
+  CHECK(client->sent().size() <= 16);
+
+  client->setSpace(ASYNC_HOST_TCP_SPACE);
+  client->poll();
+
+  CHECK(client->sent().compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+  CHECK(client->sent().find("late") == std::string::npos);
+
+  client->disconnect();
+}
+
+/////////////////////////////////////////////////
+
+static AsyncResponseStreamHandle producer;
+
+// Written to from another thread through a handle : the idle connection is woken once, and the
+// handle is detached when the client goes away
+static void testStreamHandle()
+{
+  AsyncClient* client = request("GET /stream HTTP/1.1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+
+  CHECK(producer.attached());
+  hostRunTcpip();
+
+  std::thread([]
+  {
+    producer.print("abc");
+    producer.print("def");
+  }).join();
+
+  CHECK(hostRunTcpip() == 1);
+
+  client->poll();
+  CHECK(client->sent().find("abcdef") != std::string::npos);
+
+  // Nothing more to send, the response waits again and end() wakes it
+  client->acked(client->sent().size());
+  hostRunTcpip();
+
+  std::thread([]
+  {
+    producer.end();
+  }).join();
+
+  CHECK(hostRunTcpip() == 1);
+
+  client->poll();
+
+  // Last chunk, its size is padded with spaces
+  const std::string& sent = client->sent();
+  const size_t last = sent.rfind("\r\n", sent.size() - 5);
+
+  CHECK(sent.compare(sent.size() - 4, 4, "\r\n\r\n") == 0);
+  CHECK((last != std::string::npos) && (sent[last + 2] == '0'));
+
+  client->disconnect();
+
+  client = request("GET /stream HTTP/1.1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+
+  AsyncResponseStreamHandle copy = producer;
+
+  client->disconnect();
+
+  CHECK(!producer.attached());
+  CHECK(!copy.attached());
+  CHECK(copy.print("late") == 0);
+
+  producer = AsyncResponseStreamHandle();
+  hostRunTcpip();
+}
+
+/////////////////////////////////////////////////
+
+// Early routing is off by default : a handler filter still sees the request headers
+static void testFilterSeesHeaders()
+{
+  AsyncClient* client = request("GET /filtered HTTP/1.1\r\nX-Key: 1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+
+  CHECK(client->sent().compare(0, 15, "HTTP/1.1 200 OK") == 0);
+  CHECK(client->sent().find("filtered") != std::string::npos);
+
+  client->disconnect();
+
+  client = request("GET /filtered HTTP/1.1\r\n\r\n", ASYNC_HOST_TCP_SPACE);
+
+  // The catch-all handler without onNotFound()
+  CHECK(client->sent().compare(0, 12, "HTTP/1.1 500") == 0);
+  CHECK(client->sent().find("filtered") == std::string::npos);
+
+  client->disconnect();
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  AsyncWebServer server(80);
+
+  server.on("/chunked", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    request->send(request->beginChunkedResponse("text/plain", [](uint8_t* buffer, size_t maxLen, size_t index) -> size_t
+    {
+      if (index || (maxLen < 5))
+        return 0;
+
+      memcpy(buffer, "hello", 5);
+
+      return 5;
+    }));
+  });
+
+  server.on("/canned", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    request->send(404);
+    request->send(200, "text/plain", "late");
+  });
+
+  server.on("/stream", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    AsyncResponseStream* response = request->beginChunkedResponseStream("text/plain");
+
+    producer = response->handle();
+    request->send(response);
+  });
+
+  server.on("/filtered", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    request->send(200, "text/plain", "filtered");
+  }).setFilter([](AsyncWebServerRequest * request)
+  {
+    return request->hasHeader("X-Key");
+  });
+
+  server.begin();
+
+  testChunkedHeadWithoutRoom();
+  testCannedAnswers();
+  testStreamHandle();
+  testFilterSeesHeaders();
+
+  return hostTestResult("responses");
+}
@@ -0,0 +1,267 @@
+/****************************************************************************************************************************
+  test_small_vector.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// SmallVector against the LinkedList behaviour it replaces : order, removal, removers that use the list,
+// growth past the inline elements, and free() moving each element a bounded number of times.
+
+#include "StringArray.h"
+#include "host_test.h"
+
+#include <algorithm>
+#include <vector>
+
+/////////////////////////////////////////////////
+
+static std::vector<int> removed;
+
+static void onRemove(int v)
+{
+  removed.push_back(v);
+}
+
+/////////////////////////////////////////////////
+
+static std::vector<int> contents(const SmallVector<int, 4>& list)
+{
+  std::vector<int> out;
+
+  for (int v : list)
+    out.push_back(v);
+
+  return out;
+}
+
+/////////////////////////////////////////////////
+
+static void testOrderAndGrowth()
+{
+  SmallVector<int, 4> list(onRemove);
+
+  CHECK(list.isEmpty());
+  CHECK(list.nth(0) == nullptr);
+
+  for (int i = 0; i < 20; i++)
+    list.add(i);
+
+  CHECK(list.length() == 20);
+  CHECK(list.front() == 0);
+  CHECK(list.nth(19) && *list.nth(19) == 19);
+  CHECK(list.nth(20) == nullptr);
+
+  std::vector<int> expected;
+
+  for (int i = 0; i < 20; i++)
+    expected.push_back(i);
+
+  CHECK(contents(list) == expected);
+  CHECK(list.count_if([](int v) { return v % 2 == 0; }) == 10);
+}
+
+/////////////////////////////////////////////////
+
+static void testRemove()
+{
+  SmallVector<int, 4> list(onRemove);
+
+  for (int i = 0; i < 10; i++)
+    list.add(i);
+
+  removed.clear();
+
+  CHECK(list.remove(5));
+  CHECK(!list.remove(42));
+  CHECK(list.remove_first([](int v) { return v > 6; }));
+  CHECK(list.remove_if([](int v) { return v % 2 == 1; }) == 3);
+
+  CHECK(contents(list) == std::vector<int>({ 0, 2, 4, 6, 8 }));
+  CHECK(removed == std::vector<int>({ 5, 7, 1, 3, 9 }));
+}
+
+/////////////////////////////////////////////////
+
+// A remover that deletes a client which then takes itself out of the server's list
+static SmallVector<int, 4>* reentrant;
+
+static void onRemoveReentrant(int v)
+{
+  removed.push_back(v);
+
+  if (v == 7)
+    reentrant->remove(2);
+}
+
+static void testFree()
+{
+  SmallVector<int, 4> list(onRemove);
+
+  for (int i = 0; i < 10; i++)
+    list.add(i);
+
+  removed.clear();
+  list.free();
+
+  CHECK(list.isEmpty());
+  CHECK(removed.size() == 10);
+
+  std::vector<int> sorted(removed);
+
+  std::sort(sorted.begin(), sorted.end());
+
+  for (int i = 0; i < 10; i++)
+    CHECK(sorted[i] == i);
+
+  // Reusable after free()
+  list.add(42);
+  CHECK(list.length() == 1 && list.front() == 42);
+
+  SmallVector<int, 4> other(onRemoveReentrant);
+
+  reentrant = &other;
+
+  for (int i = 0; i < 10; i++)
+    other.add(i);
+
+  removed.clear();
+  other.free();
+
+  CHECK(other.isEmpty());
+  CHECK(removed.size() == 10);
+}
+
+/////////////////////////////////////////////////
+
+// Counts the moves and copies made while elements are removed
+struct Counted
+{
+  int value;
+  static size_t assignments;
+
+  Counted(int v = 0) : value(v) {}
+  Counted(const Counted& other) : value(other.value)
+  {
+    assignments++;
+  }
+
+  Counted& operator=(const Counted& other)
+  {
+    value = other.value;
+    assignments++;
+
+    return *this;
+  }
+
+  bool operator==(const Counted& other) const
+  {
+    return value == other.value;
+  }
+};
+
+size_t Counted::assignments = 0;
+
+static size_t countedRemoved;
+
+static void onRemoveCounted(Counted)
+{
+  countedRemoved++;
+}
+
+static void testFreeIsLinear()
+{
+  const size_t n = 4096;
+  SmallVector<Counted, 8> list(onRemoveCounted);
+
+  for (size_t i = 0; i < n; i++)
+    list.add(Counted(i));
+
+  Counted::assignments = 0;
+  countedRemoved = 0;
+
+  list.free();
+
+  CHECK(countedRemoved == n);
+  CHECK(Counted::assignments <= 4 * n);
+}
+
+/////////////////////////////////////////////////
+
+static void testCopy()
+{
+  SmallVector<int, 4> list(onRemove);
+
+  for (int i = 0; i < 6; i++)
+    list.add(i);
+
+  SmallVector<int, 4> copy(list);
+  SmallVector<int, 4> assigned;
+
+  assigned.add(99);
+  assigned = list;
+
+  CHECK(contents(copy) == contents(list));
+  CHECK(contents(assigned) == contents(list));
+
+  // The copies own their elements
+  copy.remove(0);
+  CHECK(list.length() == 6);
+}
+
+/////////////////////////////////////////////////
+
+static void testStringArray()
+{
+  StringArray headers;
+
+  headers.add("Content-Type");
+  headers.add("X-Custom");
+
+  CHECK(headers.containsIgnoreCase("content-type"));
+  CHECK(headers.containsIgnoreCase("X-CUSTOM"));
+  CHECK(!headers.containsIgnoreCase("Content"));
+
+  headers.free();
+  CHECK(headers.isEmpty());
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  testOrderAndGrowth();
+  testRemove();
+  testFree();
+  testFreeIsLinear();
+  testCopy();
+  testStringArray();
+
+  return hostTestResult("small_vector");
+}
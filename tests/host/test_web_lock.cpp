@@ -0,0 +1,205 @@
+/****************************************************************************************************************************
+  test_web_lock.cpp - Dead simple Ethernet AsyncWebServer.
+
+  For ENC28J60 Ethernet in ESP32 (ESP32 + ENC28J60)
+
+  AsyncWebServer_ESP32_ENC is a library for the Ethernet ENC28J60 in ESSP32 to run AsyncWebServer
+
+  Based on and modified from ESPAsyncWebServer (https://github.com/me-no-dev/ESPAsyncWebServer)
+  Built by Khoi Hoang https://github.com/khoih-prog/AsyncWebServer_ESP32_ENC
+  Licensed under GPLv3 license
+
+  Original author: Hristo Gochkov
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+
+  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License along with this library;
+  if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  Version: 1.6.3
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.6.2   K Hoang      27/11/2022 Initial porting for ENC28J60 + ESP32. Sync with AsyncWebServer_WT32_ETH01 v1.6.2
+  1.6.3   K Hoang      05/12/2022 Add Async_WebSocketsServer, MQTT examples
+ *****************************************************************************************************************************/
+
+
+// AsyncWebLock and AsyncWebSpinLock, built with ASYNC_WEB_LOCK_PTHREAD and ASYNC_WEB_LOCK_STATS :
+// mutual exclusion under contention, the same task taking a lock again, the contention counters.
+
+#include "AsyncWebSynchronization.h"
+#include "host_test.h"
+
+#include <thread>
+#include <vector>
+
+#define LOCK_THREADS          8
+#define LOCK_ROUNDS           20000
+
+/////////////////////////////////////////////////
+
+// Plain counters, only correct if the lock excludes the other threads
+template <typename Lock>
+static void testExclusion(const Lock& lock)
+{
+  volatile uint32_t counter = 0;
+  volatile uint32_t inside = 0;
+  volatile bool overlapped = false;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < LOCK_THREADS; t++)
+  {
+    threads.emplace_back([&]
+    {
+      for (int i = 0; i < LOCK_ROUNDS; i++)
+      {
+        AsyncWebLockGuard l(lock);
+
+        if (inside++)
+          overlapped = true;
+
+        counter = counter + 1;
+
+        // Some rounds give the others a chance to find it held
+        if ((i & 255) == 0)
+          std::this_thread::yield();
+
+        inside--;
+      }
+    });
+  }
+
+  for (auto& t : threads)
+    t.join();
+
+  CHECK(counter == LOCK_THREADS * LOCK_ROUNDS);
+  CHECK(!overlapped);
+}
+
+/////////////////////////////////////////////////
+
+static void testContended()
+{
+  AsyncWebLock lock;
+
+  testExclusion(lock);
+
+  AsyncWebLockStats s = lock.stats();
+
+  CHECK(s.acquired == LOCK_THREADS * LOCK_ROUNDS);
+  CHECK(s.contended <= s.acquired);
+  CHECK(s.blocked <= s.contended);
+
+  // Held across the other thread's spin : counted as contended, then blocked
+  AsyncWebLock held;
+  volatile bool taken = false;
+
+  CHECK(held.lock());
+
+  std::thread other([&]
+  {
+    AsyncWebLockGuard l(held);
+    taken = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  CHECK(!taken);
+
+  held.unlock();
+  other.join();
+
+  CHECK(taken);
+
+  s = held.stats();
+
+  CHECK(s.acquired == 2);
+  CHECK(s.contended == 1);
+  CHECK(s.blocked == 1);
+}
+
+/////////////////////////////////////////////////
+
+static void testRecursive()
+{
+  AsyncWebLock lock;
+
+  // Only the outermost take is matched by unlock()
+  CHECK(lock.lock());
+  CHECK(!lock.lock());
+
+  {
+    AsyncWebLockGuard inner(lock);
+    AsyncWebLockGuard innermost(lock);
+  }
+
+  // Still held after the nested guards
+  volatile bool taken = false;
+
+  std::thread other([&]
+  {
+    AsyncWebLockGuard l(lock);
+    taken = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  CHECK(!taken);
+
+  lock.unlock();
+  other.join();
+
+  CHECK(taken);
+
+  // Free again for this thread
+  CHECK(lock.lock());
+  lock.unlock();
+
+  CHECK(lock.stats().acquired == 3);
+}
+
+/////////////////////////////////////////////////
+
+static void testSpinLock()
+{
+  AsyncWebSpinLock lock;
+
+  testExclusion(lock);
+
+  // Nests like portMUX : the holder may take it again, released by the outermost unlock
+  volatile bool taken = false;
+
+  lock.lock();
+  lock.lock();
+  lock.unlock();
+
+  std::thread other([&]
+  {
+    AsyncWebLockGuard l(lock);
+    taken = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  CHECK(!taken);
+
+  lock.unlock();
+  other.join();
+
+  CHECK(taken);
+}
+
+/////////////////////////////////////////////////
+
+int main()
+{
+  testContended();
+  testRecursive();
+  testSpinLock();
+
+  return hostTestResult("web_lock");
+}
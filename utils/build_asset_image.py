@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#
+# build_asset_image.py - pack a directory into a read-only asset image for AsyncWebServer::serveAssets()
+#
+# Usage:
+#   python3 utils/build_asset_image.py data/ assets.bin [--gzip] [--partition-size 0x100000]
+#
+# Flash the image into a data partition, e.g. with a partitions.csv row
+#   assets,   data, 0x40,    ,   0x100000,
+# and
+#   parttool.py --port /dev/ttyUSB0 write_partition --partition-name=assets --input=assets.bin
+#
+# then in the sketch
+#   server.serveAssets("/", "assets", "max-age=600");
+#
+# Layout (little-endian, see src/AsyncAssetImage.h):
+#   header (32 bytes) | entries (32 bytes each, sorted by path) | string table | file data (4-byte aligned)
+#
+# A file "x.js.gz" is stored as "/x.js" with the gzip flag set. When "x.js" exists too, only the
+# precompressed file is stored.
+# With --gzip, compressible files are gzip-compressed when this makes them smaller.
+
+import argparse
+import gzip
+import os
+import struct
+import sys
+
+MAGIC = 0x41535741          # "AWSA"
+VERSION = 1
+FLAG_GZIP = 0x0001
+
+HEADER_FMT = "<IHHIII12x"
+ENTRY_FMT = "<IHHIHxxIII4x"
+
+MIME_TYPES = {
+    ".html": "text/html",
+    ".htm": "text/html",
+    ".css": "text/css",
+    ".txt": "text/plain",
+    ".js": "application/javascript",
+    ".mjs": "application/javascript",
+    ".json": "application/json",
+    ".map": "application/json",
+    ".png": "image/png",
+    ".gif": "image/gif",
+    ".jpg": "image/jpeg",
+    ".jpeg": "image/jpeg",
+    ".ico": "image/x-icon",
+    ".svg": "image/svg+xml",
+    ".webp": "image/webp",
+    ".eot": "font/eot",
+    ".woff": "font/woff",
+    ".woff2": "font/woff2",
+    ".ttf": "font/ttf",
+    ".xml": "text/xml",
+    ".pdf": "application/pdf",
+    ".zip": "application/zip",
+    ".gz": "application/x-gzip",
+    ".wasm": "application/wasm",
+}
+
+COMPRESSIBLE = ("text/", "application/javascript", "application/json", "image/svg+xml", "text/xml", "application/wasm")
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def mime_for(path):
+    # Unknown extensions are left empty, the server resolves them with AsyncWebMimeTypes at runtime
+    return MIME_TYPES.get(os.path.splitext(path)[1].lower(), "")
+
+
+def align4(n):
+    return (n + 3) & ~3
+
+
+def collect(root, use_gzip):
+    files = {}
+
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+
+        for name in sorted(filenames):
+            full = os.path.join(dirpath, name)
+            rel = "/" + os.path.relpath(full, root).replace(os.sep, "/")
+
+            with open(full, "rb") as f:
+                files[rel] = f.read()
+
+    assets = []
+
+    for path, data in files.items():
+        flags = 0
+
+        if path.endswith(".gz"):
+            # Served under the plain name, in place of the plain file if there is one
+            path = path[:-3]
+            flags |= FLAG_GZIP
+        elif path + ".gz" in files:
+            # The precompressed variant is stored instead
+            continue
+
+        mime = mime_for(path)
+
+        if use_gzip and not flags and mime and mime.startswith(COMPRESSIBLE):
+            packed = gzip.compress(data, compresslevel=9, mtime=0)
+
+            if len(packed) < len(data):
+                data = packed
+                flags |= FLAG_GZIP
+
+        assets.append((path.encode("utf-8"), mime.encode("ascii"), flags, data))
+
+    assets.sort(key=lambda a: a[0])
+
+    return assets
+
+
+def build(assets):
+    count = len(assets)
+    entries_offset = struct.calcsize(HEADER_FMT)
+    strings_offset = entries_offset + count * struct.calcsize(ENTRY_FMT)
+
+    strings = bytearray()
+    string_offsets = {}
+
+    def add_string(s):
+        if s not in string_offsets:
+            string_offsets[s] = strings_offset + len(strings)
+            strings.extend(s + b"\0")
+
+        return string_offsets[s]
+
+    located = [(path, add_string(path), mime, add_string(mime) if mime else 0, flags, data)
+               for path, mime, flags, data in assets]
+
+    data_offset = align4(strings_offset + len(strings))
+    blob = bytearray()
+    entries = bytearray()
+
+    for path, path_off, mime, mime_off, flags, data in located:
+        if len(path) > 0xFFFF:
+            sys.exit("path too long: %s" % path.decode())
+
+        offset = data_offset + len(blob)
+        blob.extend(data)
+        blob.extend(b"\0" * (align4(len(blob)) - len(blob)))
+        entries.extend(struct.pack(ENTRY_FMT, path_off, len(path), flags, mime_off, len(mime), offset, len(data), fnv1a(data)))
+
+    image_size = data_offset + len(blob)
+    header = struct.pack(HEADER_FMT, MAGIC, VERSION, struct.calcsize(HEADER_FMT), count, entries_offset, image_size)
+
+    image = header + entries + strings
+    image += b"\0" * (data_offset - len(image))
+    image += blob
+
+    return bytes(image)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack a directory into an AsyncWebServer asset image")
+    parser.add_argument("source", help="directory to pack")
+    parser.add_argument("output", help="image file to write")
+    parser.add_argument("--gzip", action="store_true", help="gzip compressible files when smaller")
+    parser.add_argument("--partition-size", type=lambda v: int(v, 0), default=0,
+                        help="fail if the image does not fit the partition")
+    args = parser.parse_args()
+
+    assets = collect(args.source, args.gzip)
+    image = build(assets)
+
+    if args.partition_size and len(image) > args.partition_size:
+        sys.exit("image is %d bytes, partition is only %d" % (len(image), args.partition_size))
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+
+    for path, mime, flags, data in assets:
+        print("%-40s %8d %s%s" % (path.decode(), len(data), mime.decode() or "-", " (gzip)" if flags & FLAG_GZIP else ""))
+
+    print("%d assets, image size %d bytes" % (len(assets), len(image)))
+
+
+if __name__ == "__main__":
+    main()